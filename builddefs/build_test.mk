@@ -54,20 +54,35 @@ include tests/test_common/build.mk
 include $(TEST_PATH)/test.mk
 endif
 
+ifeq ($(strip $(BENCH)), yes)
+include tests/test_common/build.mk
+include $(TEST_PATH)/bench.mk
+endif
+
 include $(BUILDDEFS_PATH)/common_features.mk
 include $(BUILDDEFS_PATH)/generic_features.mk
 include $(PLATFORM_PATH)/common.mk
 include $(TMK_PATH)/protocol.mk
 include $(QUANTUM_PATH)/debounce/tests/rules.mk
 include $(QUANTUM_PATH)/encoder/tests/rules.mk
+include $(QUANTUM_PATH)/framebuffer/tests/rules.mk
+include $(QUANTUM_PATH)/render_scheduler/tests/rules.mk
+include $(QUANTUM_PATH)/output_stage/tests/rules.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
+include $(QUANTUM_PATH)/split_common/tests/rules.mk
+include $(DRIVER_PATH)/oled/tests/rules.mk
+include $(TMK_PATH)/protocol/tests/rules.mk
 include $(PLATFORM_PATH)/test/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include $(BUILDDEFS_PATH)/build_full_test.mk
 endif
+ifeq ($(strip $(BENCH)), yes)
+include $(BUILDDEFS_PATH)/build_bench.mk
+else
+$(TEST)_SRC += tests/test_common/main.c
+endif
 
 $(TEST)_SRC += \
-	tests/test_common/main.c \
 	$(LIB_PATH)/printf/printf.c \
 	$(QUANTUM_PATH)/logging/print.c
 
@@ -149,6 +149,24 @@ ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
     endif
 endif
 
+ifeq ($(strip $(I2C_ASYNC_ENABLE)), yes)
+    ifeq ($(PLATFORM),CHIBIOS)
+        OPT_DEFS += -DI2C_ASYNC_ENABLE
+        QUANTUM_LIB_SRC += i2c_queue.c
+    else
+        $(call CATASTROPHIC_ERROR,Invalid I2C_ASYNC_ENABLE,I2C_ASYNC_ENABLE is only supported on ChibiOS)
+    endif
+endif
+
+ifeq ($(strip $(SPI_ASYNC_ENABLE)), yes)
+    ifeq ($(PLATFORM),CHIBIOS)
+        OPT_DEFS += -DSPI_ASYNC_ENABLE
+        QUANTUM_LIB_SRC += spi_queue.c
+    else
+        $(call CATASTROPHIC_ERROR,Invalid SPI_ASYNC_ENABLE,SPI_ASYNC_ENABLE is only supported on ChibiOS)
+    endif
+endif
+
 VALID_EEPROM_DRIVER_TYPES := vendor custom transient i2c spi
 EEPROM_DRIVER ?= vendor
 ifeq ($(filter $(EEPROM_DRIVER),$(VALID_EEPROM_DRIVER_TYPES)),)
@@ -285,8 +303,13 @@ endif
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix/animations
     COMMON_VPATH += $(QUANTUM_DIR)/led_matrix/animations/runners
+    COMMON_VPATH += $(QUANTUM_DIR)/framebuffer
+    COMMON_VPATH += $(QUANTUM_DIR)/render_scheduler
+    COMMON_VPATH += $(QUANTUM_DIR)/led_engine
     SRC += $(QUANTUM_DIR)/process_keycode/process_backlight.c
     SRC += $(QUANTUM_DIR)/led_matrix/led_matrix.c
+    SRC += $(QUANTUM_DIR)/framebuffer/framebuffer.c
+    SRC += $(QUANTUM_DIR)/render_scheduler/render_scheduler.c
     SRC += $(QUANTUM_DIR)/led_matrix/led_matrix_drivers.c
     SRC += $(LIB_PATH)/lib8tion/lib8tion.c
     CIE1931_CURVE := yes
@@ -343,8 +366,15 @@ endif
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix/animations
     COMMON_VPATH += $(QUANTUM_DIR)/rgb_matrix/animations/runners
+    COMMON_VPATH += $(QUANTUM_DIR)/framebuffer
+    COMMON_VPATH += $(QUANTUM_DIR)/render_scheduler
+    COMMON_VPATH += $(QUANTUM_DIR)/led_engine
+    COMMON_VPATH += $(QUANTUM_DIR)/output_stage
     SRC += $(QUANTUM_DIR)/color.c
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix.c
+    SRC += $(QUANTUM_DIR)/framebuffer/framebuffer.c
+    SRC += $(QUANTUM_DIR)/render_scheduler/render_scheduler.c
+    SRC += $(QUANTUM_DIR)/output_stage/output_stage.c
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix_drivers.c
     SRC += $(LIB_PATH)/lib8tion/lib8tion.c
     CIE1931_CURVE := yes
@@ -543,10 +573,17 @@ ifeq ($(strip $(TERMINAL_ENABLE)), yes)
     OPT_DEFS += -DUSER_PRINT
 endif
 
+ifeq ($(strip $(TELEMETRY_ENABLE)), yes)
+    RAW_ENABLE := yes
+    SRC += $(QUANTUM_DIR)/telemetry.c
+    OPT_DEFS += -DTELEMETRY_ENABLE
+endif
+
 ifeq ($(strip $(VIA_ENABLE)), yes)
     DYNAMIC_KEYMAP_ENABLE := yes
     RAW_ENABLE := yes
     BOOTMAGIC_ENABLE := yes
+    CRC_ENABLE := yes
     SRC += $(QUANTUM_DIR)/via.c
     OPT_DEFS += -DVIA_ENABLE
 endif
@@ -576,6 +613,7 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
 
     # Include common stuff for all non custom matrix users
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix_common.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/matrix_port.c
 
     # if 'lite' then skip the actual matrix implementation
     ifneq ($(strip $(CUSTOM_MATRIX)), lite)
@@ -601,7 +639,8 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
         QUANTUM_SRC += $(QUANTUM_DIR)/split_common/transport.c \
-                       $(QUANTUM_DIR)/split_common/transactions.c
+                       $(QUANTUM_DIR)/split_common/transactions.c \
+                       $(QUANTUM_DIR)/split_common/split_framebuffer.c
 
         OPT_DEFS += -DSPLIT_COMMON_TRANSACTIONS
 
@@ -621,6 +660,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
         else
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
         endif
+        ifeq ($(strip $(SERIAL_DRIVER)), usart)
+            QUANTUM_LIB_SRC += serial_link.c
+        endif
     endif
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
@@ -661,7 +703,7 @@ ifeq ($(strip $(OLED_ENABLE)), yes)
 
         OPT_DEFS += -DOLED_DRIVER_$(strip $(shell echo $(OLED_DRIVER) | tr '[:lower:]' '[:upper:]'))
         ifeq ($(strip $(OLED_DRIVER)), SSD1306)
-            SRC += ssd1306_sh1106.c
+            SRC += ssd1306_sh1106.c oled_draw.c
             QUANTUM_LIB_SRC += i2c_master.c
         endif
     endif
@@ -83,6 +83,14 @@ define GENERATE_MSG_MAKE_TEST
 endef
 MSG_MAKE_TEST = $(eval $(call GENERATE_MSG_MAKE_TEST))$(MSG_MAKE_TEST_ACTUAL)
 MSG_TEST = Testing $(BOLD)$(TEST_NAME)$(NO_COLOR)
+define GENERATE_MSG_MAKE_BENCH
+    MSG_MAKE_BENCH_ACTUAL := Making benchmark $(BOLD)$(BENCH_NAME)$(NO_COLOR)
+    ifneq ($$(MAKE_TARGET),)
+        MSG_MAKE_BENCH_ACTUAL += with target $(BOLD)$$(MAKE_TARGET)$(NO_COLOR)
+    endif
+endef
+MSG_MAKE_BENCH = $(eval $(call GENERATE_MSG_MAKE_BENCH))$(MSG_MAKE_BENCH_ACTUAL)
+MSG_BENCH = Benchmarking $(BOLD)$(BENCH_NAME)$(NO_COLOR)
 define GENERATE_MSG_AVAILABLE_KEYMAPS
     MSG_AVAILABLE_KEYMAPS_ACTUAL := Available keymaps for $(BOLD)$$(CURRENT_KB)$(NO_COLOR):
 endef
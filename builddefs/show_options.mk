@@ -40,6 +40,8 @@ OTHER_OPTION_NAMES = \
   AUTO_SHIFT_ENABLE \
   AUTO_SHIFT_MODIFIERS \
   DYNAMIC_TAPPING_TERM_ENABLE \
+  TAPPING_PREDICT_ENABLE \
+  TELEMETRY_ENABLE \
   COMBO_ENABLE \
   KEY_LOCK_ENABLE \
   KEY_OVERRIDE_ENABLE \
@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include "eeprom_driver.h"
+#include "telemetry.h"
 
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uint8_t ret = 0;
@@ -38,14 +39,17 @@ uint32_t eeprom_read_dword(const uint32_t *addr) {
 }
 
 void eeprom_write_byte(uint8_t *addr, uint8_t value) {
+    telemetry_count(TELEMETRY_EEPROM_WRITES);
     eeprom_write_block(&value, addr, 1);
 }
 
 void eeprom_write_word(uint16_t *addr, uint16_t value) {
+    telemetry_count(TELEMETRY_EEPROM_WRITES);
     eeprom_write_block(&value, addr, 2);
 }
 
 void eeprom_write_dword(uint32_t *addr, uint32_t value) {
+    telemetry_count(TELEMETRY_EEPROM_WRITES);
     eeprom_write_block(&value, addr, 4);
 }
 
@@ -53,6 +57,7 @@ void eeprom_update_block(const void *buf, void *addr, size_t len) {
     uint8_t read_buf[len];
     eeprom_read_block(read_buf, addr, len);
     if (memcmp(buf, read_buf, len) != 0) {
+        telemetry_count(TELEMETRY_EEPROM_WRITES);
         eeprom_write_block(buf, addr, len);
     }
 }
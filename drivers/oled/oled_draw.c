@@ -0,0 +1,169 @@
+/*
+Copyright 2022 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "oled_driver.h"
+#include "progmem.h"
+
+#include <stdlib.h>
+
+// Drawing primitives operating directly on the oled buffer.
+// Coordinates follow oled_write_pixel, i.e. they are relative to the rotated display.
+// Only bytes whose value actually changes are written, so redrawing identical
+// content every frame leaves the dirty flags, and the i2c bus, untouched.
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+extern uint8_t         oled_rotation_width;
+
+#define OLED_RLE_REPEAT 0x80
+
+static inline uint8_t oled_rotation_height(void) {
+    return OLED_MATRIX_SIZE / oled_rotation_width * 8;
+}
+
+// Replaces the bits selected by mask, marking the chunk dirty if the byte changed
+static inline void oled_write_bits(uint16_t index, uint8_t mask, uint8_t bits) {
+    uint8_t data = (oled_buffer[index] & ~mask) | (bits & mask);
+    if (oled_buffer[index] != data) {
+        oled_buffer[index] = data;
+        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+    }
+}
+
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    uint8_t max_height = oled_rotation_height();
+    if (x >= oled_rotation_width || y >= max_height || !width || !height) {
+        return;
+    }
+    uint8_t x_end = (width > oled_rotation_width - x) ? oled_rotation_width : x + width;
+    uint8_t y_end = (height > max_height - y) ? max_height : y + height;
+
+    // Work a page at a time, so each byte is visited once
+    for (uint8_t page = y / 8; page <= (y_end - 1) / 8; page++) {
+        uint8_t mask = 0xFF;
+        if (page == y / 8) {
+            mask &= 0xFF << (y % 8);
+        }
+        if (page == (y_end - 1) / 8) {
+            mask &= 0xFF >> (7 - (y_end - 1) % 8);
+        }
+        uint16_t index = page * oled_rotation_width + x;
+        for (uint8_t col = x; col < x_end; col++, index++) {
+            oled_write_bits(index, mask, on ? 0xFF : 0x00);
+        }
+    }
+}
+
+void oled_draw_hline(uint8_t x, uint8_t y, uint8_t width, bool on) {
+    oled_fill_rect(x, y, width, 1, on);
+}
+
+void oled_draw_vline(uint8_t x, uint8_t y, uint8_t height, bool on) {
+    oled_fill_rect(x, y, 1, height, on);
+}
+
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    if (!width || !height) {
+        return;
+    }
+    oled_draw_hline(x, y, width, on);
+    oled_draw_hline(x, y + height - 1, width, on);
+    oled_draw_vline(x, y, height, on);
+    oled_draw_vline(x + width - 1, y, height, on);
+}
+
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on) {
+    if (y0 == y1) {
+        oled_draw_hline(x0 < x1 ? x0 : x1, y0, abs(x1 - x0) + 1, on);
+        return;
+    }
+    if (x0 == x1) {
+        oled_draw_vline(x0, y0 < y1 ? y0 : y1, abs(y1 - y0) + 1, on);
+        return;
+    }
+
+    // Bresenham
+    int16_t dx  = abs(x1 - x0);
+    int16_t dy  = -abs(y1 - y0);
+    int8_t  sx  = x0 < x1 ? 1 : -1;
+    int8_t  sy  = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    while (true) {
+        oled_write_pixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+// Places one sprite byte, which may straddle two pages when y is not page aligned
+static void oled_write_sprite_byte(uint8_t x, uint8_t y, uint8_t mask, uint8_t bits) {
+    uint8_t  shift = y % 8;
+    uint16_t index = (y / 8) * oled_rotation_width + x;
+    oled_write_bits(index, mask << shift, bits << shift);
+    if (shift && (y / 8 + 1) < oled_rotation_height() / 8) {
+        oled_write_bits(index + oled_rotation_width, mask >> (8 - shift), bits >> (8 - shift));
+    }
+}
+
+void oled_draw_sprite_P(const char *data, uint8_t x, uint8_t y) {
+    const uint8_t *src    = (const uint8_t *)data;
+    uint8_t        width  = pgm_read_byte(src++);
+    uint8_t        height = pgm_read_byte(src++);
+    uint8_t        pages  = (height + 7) / 8;
+    if (!width) {
+        return;
+    }
+
+    uint8_t col = 0, page = 0, run = 0;
+    bool    repeat = false;
+    uint8_t bits   = 0;
+    while (page < pages) {
+        if (!run) {
+            uint8_t control = pgm_read_byte(src++);
+            repeat          = control & OLED_RLE_REPEAT;
+            run             = (control & ~OLED_RLE_REPEAT) + 1;
+            if (repeat) {
+                bits = pgm_read_byte(src++);
+            }
+        }
+        if (!repeat) {
+            bits = pgm_read_byte(src++);
+        }
+        run--;
+
+        uint16_t row = y + page * 8;
+        if (x + col < oled_rotation_width && row < oled_rotation_height()) {
+            // The last page of the sprite may be partially used
+            uint8_t mask = (page == pages - 1 && height % 8) ? 0xFF >> (8 - height % 8) : 0xFF;
+            oled_write_sprite_byte(x + col, row, mask, bits);
+        }
+
+        if (++col == width) {
+            col = 0;
+            page++;
+        }
+    }
+}
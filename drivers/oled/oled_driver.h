@@ -170,6 +170,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_UPDATE_INTERVAL 50
 #endif
 
+// Maximum number of data writes oled_render() issues per call
+#if !defined(OLED_UPDATE_PROCESS_LIMIT)
+#    define OLED_UPDATE_PROCESS_LIMIT 1
+#endif
+
+// Maximum number of bytes contiguous dirty blocks are merged into for a single data write.
+// Larger writes block oled_render() for longer, so merging is opt-in.
+#if !defined(OLED_RENDER_TRANSFER_SIZE)
+#    define OLED_RENDER_TRANSFER_SIZE OLED_BLOCK_SIZE
+#endif
+
+// When non zero, oled_task() flushes every dirty block at once, at most once per interval (ms)
+#if !defined(OLED_FLUSH_INTERVAL)
+#    define OLED_FLUSH_INTERVAL 0
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
@@ -199,6 +215,10 @@ void oled_clear(void);
 // Renders the dirty chunks of the buffer to oled display
 void oled_render(void);
 
+// Renders dirty chunks of the buffer to oled display, merging contiguous ones into a single write.
+// all - render every dirty chunk now, instead of at most OLED_UPDATE_PROCESS_LIMIT writes
+void oled_render_dirty(bool all);
+
 // Moves cursor to character position indicated by column and line, wraps if out of bounds
 // Max column denoted by 'oled_max_chars()' and max lines by 'oled_max_lines()' functions
 void oled_set_cursor(uint8_t col, uint8_t line);
@@ -244,6 +264,26 @@ void oled_write_raw_byte(const char data, uint16_t index);
 // Coordinates start at top-left and go right and down for positive x and y
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
 
+// Drawing primitives, coordinates are the same as for oled_write_pixel
+// Only chunks containing changed bytes are marked dirty, so redrawing unchanged content is free
+// Fills the given rectangle, clipped to the display
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Draws the outline of the given rectangle, clipped to the display
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Draws a horizontal or vertical line starting at x, y
+void oled_draw_hline(uint8_t x, uint8_t y, uint8_t width, bool on);
+void oled_draw_vline(uint8_t x, uint8_t y, uint8_t height, bool on);
+
+// Draws a line between two points, both included
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on);
+
+// Draws a run length encoded 1bpp PROGMEM sprite with its top-left corner at x, y
+// Format: width, height, followed by the column bytes of each 8 pixel page, like the oled buffer,
+// encoded as runs: 0x00-0x7F n + 1 literal bytes follow, 0x80-0xFF repeat the next byte (n & 0x7F) + 1 times
+void oled_draw_sprite_P(const char *data, uint8_t x, uint8_t y);
+
 #if defined(__AVR__)
 // Writes a PROGMEM string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -131,6 +131,14 @@ uint32_t oled_scroll_timeout;
 #if OLED_UPDATE_INTERVAL > 0
 uint16_t oled_update_timeout;
 #endif
+#if OLED_FLUSH_INTERVAL > 0
+uint16_t oled_flush_timeout;
+#endif
+#if defined(OLED_SHADOW_BUFFER)
+// Copy of what was last sent to the display, blocks marked stale have unknown display content
+uint8_t         oled_shadow[OLED_MATRIX_SIZE];
+OLED_BLOCK_TYPE oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+#endif
 
 // Internal variables to reduce math instructions
 
@@ -226,6 +234,11 @@ bool oled_init(oled_rotation_t rotation) {
 #endif
 
     oled_clear();
+    // Display RAM content is unknown after power up
+    oled_dirty = OLED_ALL_BLOCKS_MASK;
+#if defined(OLED_SHADOW_BUFFER)
+    oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+#endif
     oled_initialized = true;
     oled_active      = true;
     oled_scrolling   = false;
@@ -240,18 +253,24 @@ __attribute__((weak)) oled_rotation_t oled_init_user(oled_rotation_t rotation) {
 }
 
 void oled_clear(void) {
-    memset(oled_buffer, 0, sizeof(oled_buffer));
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        if (oled_buffer[i]) {
+            oled_buffer[i] = 0;
+            oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+        }
+    }
     oled_cursor = &oled_buffer[0];
-    oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint8_t update_start, uint16_t update_size, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint16_t start_index  = OLED_BLOCK_SIZE * update_start;
+    uint8_t  start_page   = start_index / OLED_DISPLAY_WIDTH;
+    uint8_t  start_column = start_index % OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
+    (void)update_size;
     cmd_array[0] = PAM_PAGE_ADDR | start_page;
     cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
     cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
@@ -260,96 +279,209 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = NOP;
 #else
     // Commands for use in Horizontal Addressing mode.
-    cmd_array[1] = start_column;
-    cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    if (start_column + update_size <= OLED_DISPLAY_WIDTH) {
+        // Within a single page
+        cmd_array[1] = start_column;
+        cmd_array[2] = start_column + update_size - 1;
+        cmd_array[4] = start_page;
+        cmd_array[5] = start_page;
+    } else {
+        // Whole pages, wrapping from the last column back to the first
+        cmd_array[1] = 0;
+        cmd_array[2] = OLED_DISPLAY_WIDTH - 1;
+        cmd_array[4] = start_page;
+        cmd_array[5] = (start_index + update_size - 1) / OLED_DISPLAY_WIDTH;
+    }
 #endif
 }
 
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds_90(uint8_t update_start, uint8_t update_count, uint8_t *cmd_array) {
     cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
     cmd_array[4] = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    ;
+    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 * update_count - 1 + cmd_array[1];
     cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
+// Rotates an 8x8 pixel tile: dest[i] bit (7 - j) is src[j] bit i.
+// Transposes the tile as two 32 bit words with three rounds of masked swaps.
+static void rotate_90(const uint8_t *src, uint8_t *dest) {
+    uint32_t x = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+    uint32_t y = ((uint32_t)src[4] << 24) | ((uint32_t)src[5] << 16) | ((uint32_t)src[6] << 8) | src[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    dest[7] = x >> 24;
+    dest[6] = x >> 16;
+    dest[5] = x >> 8;
+    dest[4] = x;
+    dest[3] = y >> 24;
+    dest[2] = y >> 16;
+    dest[1] = y >> 8;
+    dest[0] = y;
 }
 
-static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
-        }
+// Number of contiguous dirty blocks starting at update_start, up to max_count
+static uint8_t dirty_run_length(uint8_t update_start, uint8_t max_count) {
+    uint8_t count = 1;
+    while (count < max_count && update_start + count < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << (update_start + count)))) {
+        ++count;
     }
+    return count;
 }
 
-void oled_render(void) {
-    if (!oled_initialized) {
-        return;
+#define OLED_RENDER_MAX_BLOCKS (OLED_RENDER_TRANSFER_SIZE > OLED_BLOCK_SIZE ? OLED_RENDER_TRANSFER_SIZE / OLED_BLOCK_SIZE : 1)
+
+static bool render_blocks(uint8_t update_start, uint8_t *update_count) {
+    uint8_t max_count = OLED_RENDER_MAX_BLOCKS;
+#if (OLED_IC == OLED_IC_SH1106)
+    // Page addressing mode does not wrap to the next page
+    bool page_bound = true;
+#else
+    // Horizontal addressing mode wraps to the start column, so only whole pages can span
+    bool page_bound = (OLED_BLOCK_SIZE * update_start) % OLED_DISPLAY_WIDTH != 0;
+#endif
+    if (page_bound) {
+        uint8_t page_count = (OLED_DISPLAY_WIDTH - (OLED_BLOCK_SIZE * update_start) % OLED_DISPLAY_WIDTH) / OLED_BLOCK_SIZE;
+        if (page_count < max_count) {
+            max_count = page_count ? page_count : 1;
+        }
     }
+    *update_count        = dirty_run_length(update_start, max_count);
+    uint16_t update_size = OLED_BLOCK_SIZE * *update_count;
 
-    // Do we have work to do?
-    oled_dirty &= OLED_ALL_BLOCKS_MASK;
-    if (!oled_dirty || oled_scrolling) {
-        return;
+    // Set column & page position
+    static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+    calc_bounds(update_start, update_size, &display_start[1]); // Offset from I2C_CMD byte at the start
+
+    // Send column & page position
+    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
+        print("oled_render offset command failed\n");
+        return false;
     }
 
-    // Find first dirty block
-    uint8_t update_start = 0;
-    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
-        ++update_start;
+    // Send render data chunk as is
+    if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], update_size) != I2C_STATUS_SUCCESS) {
+        print("oled_render data failed\n");
+        return false;
     }
+    return true;
+}
+
+static bool render_blocks_90(uint8_t update_start, uint8_t *update_count) {
+    // Blocks can only be merged when each one covers the full display height
+    *update_count = (OLED_BLOCK_SIZE == OLED_DISPLAY_HEIGHT) ? dirty_run_length(update_start, OLED_RENDER_MAX_BLOCKS) : 1;
 
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-    } else {
-        calc_bounds_90(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-    }
+    calc_bounds_90(update_start, *update_count, &display_start[1]); // Offset from I2C_CMD byte at the start
 
     // Send column & page position
     if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
         print("oled_render offset command failed\n");
+        return false;
+    }
+
+    // Rotate the render chunks, interleaving the pages of merged blocks
+    const static uint8_t source_map[] = OLED_SOURCE_MAP;
+    const static uint8_t target_map[] = OLED_TARGET_MAP;
+
+    static uint8_t temp_buffer[OLED_BLOCK_SIZE * OLED_RENDER_MAX_BLOCKS];
+    uint16_t       page_stride = 8 * *update_count;
+    for (uint8_t block = 0; block < *update_count; ++block) {
+        const uint8_t *source = &oled_buffer[OLED_BLOCK_SIZE * (update_start + block)];
+        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+            rotate_90(&source[source_map[i]], &temp_buffer[target_map[i] / 8 * page_stride + 8 * block]);
+        }
+    }
+
+    // Send render data chunk after rotating
+    if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE * *update_count) != I2C_STATUS_SUCCESS) {
+        print("oled_render90 data failed\n");
+        return false;
+    }
+    return true;
+}
+
+void oled_render_dirty(bool all) {
+    if (!oled_initialized) {
         return;
     }
 
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render data failed\n");
-            return;
+    // Do we have work to do?
+    oled_dirty &= OLED_ALL_BLOCKS_MASK;
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+#if defined(OLED_SHADOW_BUFFER)
+    // Drop blocks that were rewritten with the content already on the display
+    for (uint8_t i = 0; i < OLED_BLOCK_COUNT; ++i) {
+        OLED_BLOCK_TYPE block = (OLED_BLOCK_TYPE)1 << i;
+        if ((oled_dirty & block) && !(oled_shadow_stale & block) && !memcmp(&oled_buffer[OLED_BLOCK_SIZE * i], &oled_shadow[OLED_BLOCK_SIZE * i], OLED_BLOCK_SIZE)) {
+            oled_dirty &= ~block;
         }
-    } else {
-        // Rotate the render chunks
-        const static uint8_t source_map[] = OLED_SOURCE_MAP;
-        const static uint8_t target_map[] = OLED_TARGET_MAP;
+    }
+    if (!oled_dirty) {
+        return;
+    }
+#endif
 
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+    uint8_t update_start  = 0;
+    uint8_t num_processed = 0;
+    while (oled_dirty && (all || num_processed++ < OLED_UPDATE_PROCESS_LIMIT)) {
+        // Find next dirty block
+        while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
+            ++update_start;
         }
 
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render90 data failed\n");
+        uint8_t update_count;
+        bool    success;
+        if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+            success = render_blocks(update_start, &update_count);
+        } else {
+            success = render_blocks_90(update_start, &update_count);
+        }
+        if (!success) {
+#if defined(OLED_SHADOW_BUFFER)
+            for (uint8_t i = 0; i < update_count; ++i) {
+                oled_shadow_stale |= ((OLED_BLOCK_TYPE)1 << (update_start + i));
+            }
+#endif
             return;
         }
+
+#if defined(OLED_SHADOW_BUFFER)
+        memcpy(&oled_shadow[OLED_BLOCK_SIZE * update_start], &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE * update_count);
+#endif
+        // Clear dirty flags
+        for (uint8_t i = 0; i < update_count; ++i) {
+            oled_dirty &= ~((OLED_BLOCK_TYPE)1 << (update_start + i));
+#if defined(OLED_SHADOW_BUFFER)
+            oled_shadow_stale &= ~((OLED_BLOCK_TYPE)1 << (update_start + i));
+#endif
+        }
+        update_start += update_count;
     }
 
     // Turn on display if it is off
     oled_on();
+}
 
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+void oled_render(void) {
+    oled_render_dirty(false);
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -417,32 +549,32 @@ void oled_write_char(const char data, bool invert) {
         return;
     }
 
-    // copy the current render buffer to check for dirty after
+    // render the glyph to a temporary buffer to check for dirty after
     static uint8_t oled_temp_buffer[OLED_FONT_WIDTH];
-    memcpy(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH);
 
     _Static_assert(sizeof(font) >= ((OLED_FONT_END + 1 - OLED_FONT_START) * OLED_FONT_WIDTH), "OLED_FONT_END references outside array");
 
     // set the reder buffer data
     uint8_t cast_data = (uint8_t)data; // font based on unsigned type for index
     if (cast_data < OLED_FONT_START || cast_data > OLED_FONT_END) {
-        memset(oled_cursor, 0x00, OLED_FONT_WIDTH);
+        memset(oled_temp_buffer, 0x00, OLED_FONT_WIDTH);
     } else {
         const uint8_t *glyph = &font[(cast_data - OLED_FONT_START) * OLED_FONT_WIDTH];
-        memcpy_P(oled_cursor, glyph, OLED_FONT_WIDTH);
+        memcpy_P(oled_temp_buffer, glyph, OLED_FONT_WIDTH);
     }
 
     // Invert if needed
     if (invert) {
-        InvertCharacter(oled_cursor);
+        InvertCharacter(oled_temp_buffer);
     }
 
-    // Dirty check
-    if (memcmp(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH)) {
-        uint16_t index = oled_cursor - &oled_buffer[0];
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
-        // Edgecase check if the written data spans the 2 chunks
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << ((index + OLED_FONT_WIDTH - 1) / OLED_BLOCK_SIZE));
+    // Dirty check, only the chunks holding changed bytes need to be rendered
+    uint16_t index = oled_cursor - &oled_buffer[0];
+    for (uint8_t i = 0; i < OLED_FONT_WIDTH; i++) {
+        if (oled_buffer[index + i] != oled_temp_buffer[i]) {
+            oled_buffer[index + i] = oled_temp_buffer[i];
+            oled_dirty |= ((OLED_BLOCK_TYPE)1 << ((index + i) / OLED_BLOCK_SIZE));
+        }
     }
 
     // Finally move to the next char
@@ -464,20 +596,28 @@ void oled_write_ln(const char *data, bool invert) {
 
 void oled_pan(bool left) {
     uint16_t i = 0;
+    uint8_t  data;
     for (uint16_t y = 0; y < OLED_DISPLAY_HEIGHT / 8; y++) {
         if (left) {
             for (uint16_t x = 0; x < OLED_DISPLAY_WIDTH - 1; x++) {
-                i              = y * OLED_DISPLAY_WIDTH + x;
-                oled_buffer[i] = oled_buffer[i + 1];
+                i    = y * OLED_DISPLAY_WIDTH + x;
+                data = oled_buffer[i + 1];
+                if (oled_buffer[i] != data) {
+                    oled_buffer[i] = data;
+                    oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+                }
             }
         } else {
             for (uint16_t x = OLED_DISPLAY_WIDTH - 1; x > 0; x--) {
-                i              = y * OLED_DISPLAY_WIDTH + x;
-                oled_buffer[i] = oled_buffer[i - 1];
+                i    = y * OLED_DISPLAY_WIDTH + x;
+                data = oled_buffer[i - 1];
+                if (oled_buffer[i] != data) {
+                    oled_buffer[i] = data;
+                    oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+                }
             }
         }
     }
-    oled_dirty = OLED_ALL_BLOCKS_MASK;
 }
 
 oled_buffer_reader_t oled_read_raw(uint16_t start_index) {
@@ -698,6 +838,9 @@ bool oled_scroll_off(void) {
         }
         oled_scrolling = false;
         oled_dirty     = OLED_ALL_BLOCKS_MASK;
+#if defined(OLED_SHADOW_BUFFER)
+        oled_shadow_stale = OLED_ALL_BLOCKS_MASK;
+#endif
     }
     return !oled_scrolling;
 }
@@ -768,7 +911,14 @@ void oled_task(void) {
 #endif
 
     // Smart render system, no need to check for dirty
+#if OLED_FLUSH_INTERVAL > 0
+    if (timer_elapsed(oled_flush_timeout) >= OLED_FLUSH_INTERVAL) {
+        oled_flush_timeout = timer_read();
+        oled_render_dirty(true);
+    }
+#else
     oled_render();
+#endif
 
     // Display timeout check
 #if OLED_TIMEOUT > 0
@@ -0,0 +1,217 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "oled_driver.h"
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+}
+
+#define WIDTH OLED_DISPLAY_WIDTH
+#define HEIGHT OLED_DISPLAY_HEIGHT
+
+static bool pixel(uint8_t x, uint8_t y) {
+    return oled_buffer[(y / 8) * WIDTH + x] & (1 << (y % 8));
+}
+
+static uint16_t count_pixels(void) {
+    uint16_t count = 0;
+    for (uint8_t x = 0; x < WIDTH; x++) {
+        for (uint8_t y = 0; y < HEIGHT; y++) {
+            count += pixel(x, y);
+        }
+    }
+    return count;
+}
+
+// Encodes a sprite given as rows of '#' and '.' characters
+static std::vector<char> encode_sprite(const std::vector<std::string> &rows) {
+    uint8_t              width  = rows[0].size();
+    uint8_t              height = rows.size();
+    std::vector<uint8_t> bytes;
+    for (uint8_t page = 0; page < (height + 7) / 8; page++) {
+        for (uint8_t x = 0; x < width; x++) {
+            uint8_t b = 0;
+            for (uint8_t bit = 0; bit < 8 && page * 8 + bit < height; bit++) {
+                if (rows[page * 8 + bit][x] == '#') {
+                    b |= 1 << bit;
+                }
+            }
+            bytes.push_back(b);
+        }
+    }
+
+    std::vector<char> out = {(char)width, (char)height};
+    size_t            i   = 0;
+    while (i < bytes.size()) {
+        size_t run = 1;
+        while (i + run < bytes.size() && bytes[i + run] == bytes[i] && run < 128) {
+            run++;
+        }
+        if (run > 2) {
+            out.push_back((char)(0x80 | (run - 1)));
+            out.push_back((char)bytes[i]);
+        } else {
+            size_t literal = 0;
+            while (i + literal < bytes.size() && literal < 128 && !(i + literal + 2 < bytes.size() && bytes[i + literal] == bytes[i + literal + 1] && bytes[i + literal] == bytes[i + literal + 2])) {
+                literal++;
+            }
+            literal = literal ? literal : 1;
+            out.push_back((char)(literal - 1));
+            for (size_t j = 0; j < literal; j++) {
+                out.push_back((char)bytes[i + j]);
+            }
+            run = literal;
+        }
+        i += run;
+    }
+    return out;
+}
+
+class OledDraw : public testing::Test {
+   protected:
+    void SetUp() override {
+        ASSERT_TRUE(oled_init(OLED_ROTATION_0));
+        oled_render_dirty(true);
+        ASSERT_EQ(oled_dirty, 0);
+    }
+};
+
+TEST_F(OledDraw, FillRectCoversExactArea) {
+    oled_fill_rect(3, 5, 10, 12, true);
+    for (uint8_t x = 0; x < WIDTH; x++) {
+        for (uint8_t y = 0; y < HEIGHT; y++) {
+            bool inside = x >= 3 && x < 13 && y >= 5 && y < 17;
+            ASSERT_EQ(pixel(x, y), inside) << (int)x << "," << (int)y;
+        }
+    }
+
+    oled_fill_rect(4, 6, 8, 10, false);
+    EXPECT_EQ(count_pixels(), 10 * 12 - 8 * 10);
+}
+
+TEST_F(OledDraw, ClipsToDisplay) {
+    oled_fill_rect(WIDTH - 2, HEIGHT - 3, 50, 50, true);
+    EXPECT_EQ(count_pixels(), 2 * 3);
+    oled_fill_rect(WIDTH, 0, 4, 4, true);
+    oled_draw_rect(0, HEIGHT, 4, 4, true);
+    EXPECT_EQ(count_pixels(), 2 * 3);
+}
+
+TEST_F(OledDraw, RedrawingUnchangedContentStaysClean) {
+    oled_draw_rect(70, 9, 20, 10, true);
+    oled_draw_line(40, 8, 60, HEIGHT - 1, true);
+    oled_write_ln("QMK", false);
+    EXPECT_NE(oled_dirty, 0);
+    oled_render_dirty(true);
+    ASSERT_EQ(oled_dirty, 0);
+
+    oled_draw_rect(70, 9, 20, 10, true);
+    oled_draw_line(40, 8, 60, HEIGHT - 1, true);
+    oled_set_cursor(0, 0);
+    oled_write_ln("QMK", false);
+    EXPECT_EQ(oled_dirty, 0);
+}
+
+TEST_F(OledDraw, OnlyChunksWithChangedBytesAreDirty) {
+    // A glyph straddling two chunks
+    uint8_t  col   = (OLED_BLOCK_SIZE - 1) / OLED_FONT_WIDTH;
+    uint16_t index = col * OLED_FONT_WIDTH;
+    uint8_t  first = index / OLED_BLOCK_SIZE;
+    uint8_t  last  = (index + OLED_FONT_WIDTH - 1) / OLED_BLOCK_SIZE;
+    ASSERT_LT(first, last);
+    OLED_BLOCK_TYPE both = ((OLED_BLOCK_TYPE)1 << first) | ((OLED_BLOCK_TYPE)1 << last);
+
+    oled_set_cursor(col, 0);
+    oled_write_char('A', true);
+    EXPECT_EQ(oled_dirty, both);
+    oled_render_dirty(true);
+
+    // Rewriting the glyph only touches the chunk holding the modified byte
+    oled_write_raw_byte(~oled_buffer[index + OLED_FONT_WIDTH - 1], index + OLED_FONT_WIDTH - 1);
+    oled_render_dirty(true);
+    oled_set_cursor(col, 0);
+    oled_write_char('A', true);
+    EXPECT_EQ(oled_dirty, (OLED_BLOCK_TYPE)1 << last);
+    oled_render_dirty(true);
+
+    // Clearing only touches chunks that had content
+    oled_clear();
+    EXPECT_EQ(oled_dirty, both);
+    oled_render_dirty(true);
+    oled_clear();
+    EXPECT_EQ(oled_dirty, 0);
+}
+
+TEST_F(OledDraw, LineEndpointsAndDiagonal) {
+    oled_draw_line(7, 7, 0, 0, true);
+    EXPECT_EQ(count_pixels(), 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        EXPECT_TRUE(pixel(i, i));
+    }
+
+    oled_draw_line(20, 3, 10, 3, true);
+    oled_draw_line(40, 2, 40, 12, true);
+    EXPECT_EQ(count_pixels(), 8 + 11 + 11);
+    EXPECT_TRUE(pixel(10, 3));
+    EXPECT_TRUE(pixel(40, 12));
+
+    oled_draw_line(50, 0, 60, 5, true);
+    EXPECT_TRUE(pixel(50, 0));
+    EXPECT_TRUE(pixel(60, 5));
+    EXPECT_EQ(count_pixels(), 8 + 11 + 11 + 11);
+}
+
+TEST_F(OledDraw, RleSpriteAtUnalignedPosition) {
+    const std::vector<std::string> rows = {
+        "##########",
+        "#........#",
+        "#.######.#",
+        "#........#",
+        "#........#",
+        "#........#",
+        "#........#",
+        "#........#",
+        "#.#.#.#.##",
+        "##########",
+    };
+    std::vector<char> sprite = encode_sprite(rows);
+    EXPECT_LT(sprite.size(), 2 + 2 * rows[0].size());
+
+    // Pixels around the sprite must survive, the ones it covers are replaced
+    oled_fill_rect(0, 0, 20, 20, true);
+    oled_draw_sprite_P(sprite.data(), 5, 3);
+    for (uint8_t x = 0; x < 20; x++) {
+        for (uint8_t y = 0; y < 20; y++) {
+            bool expected = true;
+            if (x >= 5 && x < 15 && y >= 3 && y < 13) {
+                expected = rows[y - 3][x - 5] == '#';
+            }
+            ASSERT_EQ(pixel(x, y), expected) << (int)x << "," << (int)y;
+        }
+    }
+}
+
+TEST_F(OledDraw, SpriteIsClipped) {
+    std::vector<char> sprite = encode_sprite({"####", "####", "####", "####"});
+    oled_draw_sprite_P(sprite.data(), WIDTH - 2, HEIGHT - 2);
+    EXPECT_EQ(count_pixels(), 4);
+}
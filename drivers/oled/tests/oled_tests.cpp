@@ -0,0 +1,330 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "oled_driver.h"
+#include "i2c_master.h"
+
+extern uint8_t oled_buffer[OLED_MATRIX_SIZE];
+}
+
+#ifndef OLED_BLOCK_COUNT
+#    define OLED_BLOCK_COUNT (sizeof(OLED_BLOCK_TYPE) * 8)
+#endif
+#ifndef OLED_BLOCK_SIZE
+#    define OLED_BLOCK_SIZE (OLED_MATRIX_SIZE / OLED_BLOCK_COUNT)
+#endif
+
+#define RAM_COLUMNS 132
+#define RAM_PAGES 8
+
+/* Simulated SSD1306/SH1106 controller: interprets the command stream and
+ * writes data bytes to its display RAM the way the hardware does, so the
+ * test can check what actually ends up on the glass.
+ */
+static struct {
+    uint8_t ram[RAM_PAGES][RAM_COLUMNS];
+    bool    horizontal;
+    uint8_t column, column_start, column_end;
+    uint8_t page, page_start, page_end;
+
+    uint32_t transactions;
+    uint32_t data_writes;
+    uint32_t bytes;
+} display;
+
+static void reset_display(void) {
+    memset(&display, 0, sizeof(display));
+    display.column_end = RAM_COLUMNS - 1;
+    display.page_end   = RAM_PAGES - 1;
+}
+
+static void reset_counters(void) {
+    display.transactions = 0;
+    display.data_writes  = 0;
+    display.bytes        = 0;
+}
+
+static uint8_t command_arguments(uint8_t command) {
+    switch (command) {
+        case 0x21: // COLUMN_ADDR
+        case 0x22: // PAGE_ADDR
+            return 2;
+        case 0x26: // SCROLL_RIGHT
+        case 0x27: // SCROLL_LEFT
+            return 6;
+        case 0x29: // SCROLL_RIGHT_UP
+        case 0x2A: // SCROLL_LEFT_UP
+            return 5;
+        case 0x20: // MEMORY_MODE
+        case 0x23: // FADE_BLINK
+        case 0x81: // CONTRAST
+        case 0x8D: // CHARGE_PUMP
+        case 0xA8: // MULTIPLEX_RATIO
+        case 0xD3: // DISPLAY_OFFSET
+        case 0xD5: // DISPLAY_CLOCK
+        case 0xD9: // PRE_CHARGE_PERIOD
+        case 0xDA: // COM_PINS
+        case 0xDB: // VCOM_DETECT
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void run_commands(const uint8_t *data, uint16_t length) {
+    uint16_t i = 0;
+    while (i < length) {
+        uint8_t command = data[i++];
+        uint8_t args[6] = {0};
+        for (uint8_t a = 0; a < command_arguments(command) && i < length; a++) {
+            args[a] = data[i++];
+        }
+        if (command == 0x20) {
+            display.horizontal = args[0] == 0x00;
+        } else if (command == 0x21) {
+            display.column_start = display.column = args[0];
+            display.column_end                    = args[1];
+        } else if (command == 0x22) {
+            display.page_start = display.page = args[0];
+            display.page_end                  = args[1];
+        } else if (command <= 0x0F) {
+            display.column = (display.column & 0xF0) | command;
+        } else if (command >= 0x10 && command <= 0x1F) {
+            display.column = (display.column & 0x0F) | ((command & 0x0F) << 4);
+        } else if (command >= 0xB0 && command <= 0xB7) {
+            display.page = command & 0x07;
+        }
+    }
+}
+
+static void write_data(const uint8_t *data, uint16_t length) {
+    display.data_writes++;
+    display.bytes += length;
+    for (uint16_t i = 0; i < length; i++) {
+        display.ram[display.page % RAM_PAGES][display.column % RAM_COLUMNS] = data[i];
+        if (display.horizontal) {
+            if (display.column++ == display.column_end) {
+                display.column = display.column_start;
+                if (display.page++ == display.page_end) {
+                    display.page = display.page_start;
+                }
+            }
+        } else {
+            display.column++;
+        }
+    }
+}
+
+extern "C" {
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    display.transactions++;
+    if (length > 0 && data[0] == 0x00) {
+        run_commands(&data[1], length - 1);
+    } else if (length > 0 && data[0] == 0x40) {
+        write_data(&data[1], length - 1);
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    display.transactions++;
+    if (regaddr == 0x00) {
+        run_commands(data, length);
+    } else if (regaddr == 0x40) {
+        write_data(data, length);
+    }
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+static bool ram_pixel(uint8_t column, uint8_t row) {
+#if (OLED_IC == OLED_IC_SH1106)
+    column += OLED_COLUMN_OFFSET;
+#endif
+    return display.ram[row / 8][column] & (1 << (row % 8));
+}
+
+static uint32_t pattern_state;
+
+static uint8_t next_pattern(void) {
+    pattern_state = pattern_state * 1103515245 + 12345;
+    return pattern_state >> 16;
+}
+
+class OledRender : public testing::Test {
+   protected:
+    void SetUp() override {
+        reset_display();
+        pattern_state = 1;
+    }
+
+    void init(oled_rotation_t rotation) {
+        ASSERT_TRUE(oled_init(rotation));
+        oled_render_dirty(true);
+        reset_counters();
+    }
+
+    void expect_unrotated_ram(void) {
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            uint8_t page   = i / OLED_DISPLAY_WIDTH;
+            uint8_t column = i % OLED_DISPLAY_WIDTH;
+#if (OLED_IC == OLED_IC_SH1106)
+            column += OLED_COLUMN_OFFSET;
+#endif
+            ASSERT_EQ(display.ram[page][column], oled_buffer[i]) << "at buffer index " << i;
+        }
+    }
+
+    void record_frame_stats(const char *name) {
+        RecordProperty(std::string(name) + "_transactions", display.transactions);
+        RecordProperty(std::string(name) + "_bytes", display.bytes);
+    }
+};
+
+TEST_F(OledRender, FullFrameIsCoalesced) {
+    init(OLED_ROTATION_0);
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        oled_write_raw_byte(next_pattern() | 1, i);
+    }
+    oled_render_dirty(true);
+    record_frame_stats("full_frame");
+
+    expect_unrotated_ram();
+    EXPECT_EQ(display.bytes, (uint32_t)OLED_MATRIX_SIZE);
+#if (OLED_IC == OLED_IC_SH1106)
+    // Page addressing mode needs one write per page
+    EXPECT_EQ(display.data_writes, (uint32_t)(OLED_DISPLAY_HEIGHT / 8));
+#else
+    EXPECT_EQ(display.data_writes, (uint32_t)(OLED_MATRIX_SIZE / OLED_RENDER_TRANSFER_SIZE));
+#endif
+    // One addressing command per data write
+    EXPECT_EQ(display.transactions, 2 * display.data_writes);
+}
+
+TEST_F(OledRender, ScatteredDirtyBlocks) {
+    init(OLED_ROTATION_0);
+    // Block runs starting at page boundaries, in the middle of a page and at the end
+    const uint8_t blocks[] = {1, 2, 3, 4, 5, OLED_BLOCK_COUNT - 1};
+    for (uint8_t block : blocks) {
+        for (uint16_t i = 0; i < OLED_BLOCK_SIZE; i++) {
+            oled_write_raw_byte(next_pattern() | 1, block * OLED_BLOCK_SIZE + i);
+        }
+    }
+    oled_render_dirty(true);
+    record_frame_stats("scattered");
+
+    expect_unrotated_ram();
+    EXPECT_EQ(display.bytes, (uint32_t)(sizeof(blocks) * OLED_BLOCK_SIZE));
+    EXPECT_LT(display.data_writes, sizeof(blocks));
+}
+
+TEST_F(OledRender, RenderIsRateLimited) {
+    init(OLED_ROTATION_0);
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i += OLED_BLOCK_SIZE * 2) {
+        oled_write_raw_byte(0xFF, i);
+    }
+    uint32_t calls = 0;
+    while (display.bytes < OLED_MATRIX_SIZE / 2 && calls < OLED_BLOCK_COUNT) {
+        uint32_t writes_before = display.data_writes;
+        oled_render();
+        EXPECT_LE(display.data_writes - writes_before, (uint32_t)OLED_UPDATE_PROCESS_LIMIT);
+        calls++;
+    }
+    EXPECT_EQ(display.bytes, (uint32_t)(OLED_MATRIX_SIZE / 2));
+    expect_unrotated_ram();
+}
+
+TEST_F(OledRender, UnchangedFrameSendsNothing) {
+    init(OLED_ROTATION_0);
+    oled_write_ln("QMK", false);
+    oled_render_dirty(true);
+    reset_counters();
+
+    oled_set_cursor(0, 0);
+    oled_write_ln("QMK", false);
+    oled_render_dirty(true);
+    EXPECT_EQ(display.transactions, 0u);
+}
+
+#if defined(OLED_SHADOW_BUFFER)
+TEST_F(OledRender, ClearAndRewriteSendsNothing) {
+    init(OLED_ROTATION_0);
+    oled_write_ln("QMK", false);
+    oled_render_dirty(true);
+    reset_counters();
+
+    oled_clear();
+    oled_write_ln("QMK", false);
+    oled_render_dirty(true);
+    EXPECT_EQ(display.transactions, 0u);
+
+    oled_clear();
+    oled_write_ln("QMX", false);
+    oled_render_dirty(true);
+    EXPECT_EQ(display.data_writes, 1u);
+    EXPECT_EQ(display.bytes, (uint32_t)OLED_BLOCK_SIZE);
+    expect_unrotated_ram();
+}
+#endif
+
+TEST_F(OledRender, RotatedFrameMatchesPixels) {
+#if (OLED_IC == OLED_IC_SH1106)
+    GTEST_SKIP() << "90 degree rendering uses horizontal addressing";
+#endif
+    init(OLED_ROTATION_90);
+    bool pixels[OLED_DISPLAY_HEIGHT][OLED_DISPLAY_WIDTH];
+    for (uint8_t x = 0; x < OLED_DISPLAY_HEIGHT; x++) {
+        for (uint8_t y = 0; y < OLED_DISPLAY_WIDTH; y++) {
+            pixels[x][y] = next_pattern() & 0x10;
+            oled_write_pixel(x, y, pixels[x][y]);
+        }
+    }
+    oled_render_dirty(true);
+    record_frame_stats("rotated_full_frame");
+
+    EXPECT_EQ(display.bytes, (uint32_t)OLED_MATRIX_SIZE);
+    EXPECT_LE(display.data_writes, (uint32_t)(OLED_MATRIX_SIZE / OLED_RENDER_TRANSFER_SIZE));
+    // Logical (x, y) lands on display column y, row (height - 1 - x)
+    for (uint8_t x = 0; x < OLED_DISPLAY_HEIGHT; x++) {
+        for (uint8_t y = 0; y < OLED_DISPLAY_WIDTH; y++) {
+            ASSERT_EQ(ram_pixel(y, OLED_DISPLAY_HEIGHT - 1 - x), pixels[x][y]) << "at " << (int)x << "," << (int)y;
+        }
+    }
+}
+
+TEST_F(OledRender, RotatedPartialUpdate) {
+#if (OLED_IC == OLED_IC_SH1106)
+    GTEST_SKIP() << "90 degree rendering uses horizontal addressing";
+#endif
+    init(OLED_ROTATION_90);
+    oled_write_pixel(0, 0, true);
+    oled_write_pixel(OLED_DISPLAY_HEIGHT - 1, OLED_DISPLAY_WIDTH - 1, true);
+    oled_write_pixel(3, 20, true);
+    oled_render_dirty(true);
+
+    EXPECT_TRUE(ram_pixel(0, OLED_DISPLAY_HEIGHT - 1));
+    EXPECT_TRUE(ram_pixel(OLED_DISPLAY_WIDTH - 1, 0));
+    EXPECT_TRUE(ram_pixel(20, OLED_DISPLAY_HEIGHT - 4));
+    EXPECT_FALSE(ram_pixel(21, OLED_DISPLAY_HEIGHT - 4));
+    EXPECT_EQ(display.bytes, (uint32_t)(3 * OLED_BLOCK_SIZE));
+}
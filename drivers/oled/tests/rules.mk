@@ -0,0 +1,37 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+OLED_COMMON_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/oled_draw_tests.cpp \
+	$(DRIVER_PATH)/oled/ssd1306_sh1106.c \
+	$(DRIVER_PATH)/oled/oled_draw.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+OLED_COMMON_INC := \
+	$(DRIVER_PATH)/oled/tests \
+	$(DRIVER_PATH)/oled
+
+oled_ssd1306_DEFS := -DNO_PRINT -DOLED_RENDER_TRANSFER_SIZE=128
+oled_ssd1306_INC := $(OLED_COMMON_INC)
+oled_ssd1306_SRC := $(OLED_COMMON_SRC)
+
+oled_ssd1306_128x64_DEFS := -DNO_PRINT -DOLED_DISPLAY_128X64 -DOLED_SHADOW_BUFFER -DOLED_RENDER_TRANSFER_SIZE=1024
+oled_ssd1306_128x64_INC := $(OLED_COMMON_INC)
+oled_ssd1306_128x64_SRC := $(OLED_COMMON_SRC)
+
+oled_sh1106_DEFS := -DNO_PRINT -DOLED_DISPLAY_128X64 -DOLED_IC=OLED_IC_SH1106 -DOLED_COLUMN_OFFSET=2 -DOLED_RENDER_TRANSFER_SIZE=1024
+oled_sh1106_INC := $(OLED_COMMON_INC)
+oled_sh1106_SRC := $(OLED_COMMON_SRC)
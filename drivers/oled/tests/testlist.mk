@@ -0,0 +1,4 @@
+TEST_LIST += \
+	oled_ssd1306 \
+	oled_ssd1306_128x64 \
+	oled_sh1106
@@ -27,3 +27,10 @@ void soft_serial_initiator_init(void);
 void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
+
+#if defined(SERIAL_DRIVER_USART)
+#    include "serial_link.h"
+
+// counters of checked frames, retransmissions and errors
+const serial_link_counters_t *soft_serial_get_counters(void);
+#endif
@@ -1,5 +1,6 @@
 """Used by the make system to generate info_config.h from info.json.
 """
+import re
 from pathlib import Path
 
 from dotty_dict import dotty
@@ -42,6 +43,34 @@ def pin_array(define, pins, postfix):
 """
 
 
+def port_groups(define, pins, postfix):
+    """Return the config.h lines that set the number of port groups in a pin array.
+
+    Pins on the same port with the same distance between their pad and their index are read together, see quantum/matrix_port.h.
+    """
+    groups = set()
+
+    for index, pin in enumerate(pins):
+        if not pin:
+            continue
+
+        match = re.fullmatch(r'([A-Z]+)(\d+)', str(pin))
+        if match:
+            groups.add((match.group(1), int(match.group(2)) - index))
+        else:
+            # Unknown pin naming, assume it needs a group of its own
+            groups.add((str(pin), index))
+
+    if not groups:
+        return ''
+
+    return f"""
+#ifndef {define}_PORT_GROUPS{postfix}
+#   define {define}_PORT_GROUPS{postfix} {len(groups)}
+#endif // {define}_PORT_GROUPS{postfix}
+"""
+
+
 def matrix_pins(matrix_pins, postfix=''):
     """Add the matrix config to the config.h.
     """
@@ -52,9 +81,11 @@ def matrix_pins(matrix_pins, postfix=''):
 
     if 'cols' in matrix_pins:
         pins.append(pin_array('MATRIX_COL', matrix_pins['cols'], postfix))
+        pins.append(port_groups('MATRIX_COL', matrix_pins['cols'], postfix))
 
     if 'rows' in matrix_pins:
         pins.append(pin_array('MATRIX_ROW', matrix_pins['rows'], postfix))
+        pins.append(port_groups('MATRIX_ROW', matrix_pins['rows'], postfix))
 
     return '\n'.join(pins)
 
@@ -267,8 +267,10 @@ def test_generate_config_h():
     assert '#   define VENDOR_ID 0xFEED' in result.stdout
     assert '#   define MATRIX_COLS 1' in result.stdout
     assert '#   define MATRIX_COL_PINS { F4 }' in result.stdout
+    assert '#   define MATRIX_COL_PORT_GROUPS 1' in result.stdout
     assert '#   define MATRIX_ROWS 1' in result.stdout
     assert '#   define MATRIX_ROW_PINS { F5 }' in result.stdout
+    assert '#   define MATRIX_ROW_PORT_GROUPS 1' in result.stdout
 
 
 def test_generate_rules_mk():
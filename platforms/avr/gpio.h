@@ -36,3 +36,11 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Operation of GPIO by port. */
+
+typedef uint8_t port_data_t;
+
+#define readPort(pin) PINx_ADDRESS(pin)
+#define getPinPort(pin) ((pin) >> PORT_SHIFTER)
+#define getPinPad(pin) ((pin)&0xF)
@@ -134,6 +134,42 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_COMPARE_PENDING (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_COMPARE_PENDING (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_COMPARE_PENDING (TIFR0 & _BV(OCF0A))
+#endif
+
+/** \brief timer read_us
+ *
+ * Interpolates between the millisecond ticks with the timer0 counter, so the
+ * resolution is one timer0 count (4 us at 16MHz).
+ */
+uint32_t timer_read_us(void) {
+    uint32_t t;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t   = timer_count;
+        raw = TIMER_RAW;
+        // The counter has wrapped, but the interrupt counting it can't run yet
+        if (TIMER_COMPARE_PENDING) {
+            raw = TIMER_RAW;
+            t++;
+        }
+    }
+
+    return t * 1000 + (uint32_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+}
+
+/** \brief timer elapsed_us
+ */
+uint32_t timer_elapsed_us(uint32_t last) {
+    return TIMER_DIFF_32(timer_read_us(), last);
+}
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
@@ -26,6 +26,9 @@
  */
 #include "quantum.h"
 #include "i2c_master.h"
+#ifdef I2C_ASYNC_ENABLE
+#    include "i2c_queue.h"
+#endif
 #include <string.h>
 #include <ch.h>
 #include <hal.h>
@@ -145,23 +148,106 @@ i2c_status_t i2c_start(uint8_t address) {
     return I2C_STATUS_SUCCESS;
 }
 
-i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = address;
+#ifdef I2C_ASYNC_ENABLE
+static BSEMAPHORE_DECL(i2c_work_sem, true);
+static BSEMAPHORE_DECL(i2c_done_sem, true);
+
+static THD_WORKING_AREA(waI2CThread, 256);
+static THD_FUNCTION(I2CThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_queue");
+
+    while (true) {
+        const i2c_transfer_t* transfer;
+        while ((transfer = i2c_queue_begin()) != NULL) {
+            i2cStart(&I2C_DRIVER, &i2cconfig);
+            msg_t status;
+            if (transfer->tx_length == 0) {
+                status = i2cMasterReceiveTimeout(&I2C_DRIVER, (transfer->address >> 1), transfer->rx_data, transfer->rx_length, TIME_MS2I(transfer->timeout));
+            } else {
+                status = i2cMasterTransmitTimeout(&I2C_DRIVER, (transfer->address >> 1), transfer->tx_data, transfer->tx_length, transfer->rx_data, transfer->rx_length, TIME_MS2I(transfer->timeout));
+            }
+            i2c_queue_end(chibios_to_qmk(&status));
+            chBSemSignal(&i2c_done_sem);
+        }
+        chBSemWait(&i2c_work_sem);
+    }
+}
+
+void i2c_queue_notify(void) {
+    static bool thread_started = false;
+    if (!thread_started) {
+        thread_started = true;
+        chThdCreateStatic(waI2CThread, sizeof(waI2CThread), HIGHPRIO, I2CThread, NULL);
+    }
+    chBSemSignal(&i2c_work_sem);
+}
+
+typedef struct {
+    volatile bool done;
+    i2c_status_t  status;
+} i2c_blocking_result_t;
+
+static void i2c_blocking_done(i2c_status_t status, void* context) {
+    i2c_blocking_result_t* result = (i2c_blocking_result_t*)context;
+    result->status                = status;
+    result->done                  = true;
+}
+
+/* The blocking API goes through the queue as well, so it is ordered with
+ * respect to asynchronous transfers already queued for the same device.
+ * Other completion callbacks may run while waiting.
+ */
+static i2c_status_t i2c_transfer_blocking(uint8_t address, const uint8_t* tx_data, uint16_t tx_length, uint8_t* rx_data, uint16_t rx_length, uint16_t timeout) {
+    i2c_blocking_result_t result   = {.done = false, .status = I2C_STATUS_ERROR};
+    i2c_transfer_t        transfer = {
+        .address   = address,
+        .priority  = I2C_PRIORITY_NORMAL,
+        .tx_data   = tx_data,
+        .tx_length = tx_length,
+        .rx_data   = rx_data,
+        .rx_length = rx_length,
+        .timeout   = timeout,
+        .callback  = i2c_blocking_done,
+        .context   = &result,
+    };
+
+    i2c_queue_task();
+    while (!i2c_queue_submit(&transfer)) {
+        chBSemWait(&i2c_done_sem);
+        i2c_queue_task();
+    }
+    while (!result.done) {
+        chBSemWait(&i2c_done_sem);
+        i2c_queue_task();
+    }
+    return result.status;
+}
+#else
+static i2c_status_t i2c_transfer_blocking(uint8_t address, const uint8_t* tx_data, uint16_t tx_length, uint8_t* rx_data, uint16_t rx_length, uint16_t timeout) {
     i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
+    msg_t status;
+    if (tx_length == 0) {
+        status = i2cMasterReceiveTimeout(&I2C_DRIVER, (address >> 1), rx_data, rx_length, TIME_MS2I(timeout));
+    } else {
+        status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), tx_data, tx_length, rx_data, rx_length, TIME_MS2I(timeout));
+    }
     return chibios_to_qmk(&status);
 }
+#endif
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_address = address;
+    return i2c_transfer_blocking(i2c_address, data, length, 0, 0, timeout);
+}
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_transfer_blocking(i2c_address, 0, 0, data, length, timeout);
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 1];
     for (uint16_t i = 0; i < length; i++) {
@@ -169,13 +255,11 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
     }
     complete_packet[0] = regaddr;
 
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_transfer_blocking(i2c_address, complete_packet, length + 1, 0, 0, timeout);
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
 
     uint8_t complete_packet[length + 2];
     for (uint16_t i = 0; i < length; i++) {
@@ -184,25 +268,27 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
     complete_packet[0] = regaddr >> 8;
     complete_packet[1] = regaddr & 0xFF;
 
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 2, 0, 0, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_transfer_blocking(i2c_address, complete_packet, length + 2, 0, 0, timeout);
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_transfer_blocking(i2c_address, &regaddr, 1, data, length, timeout);
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
     i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
-    msg_t   status             = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), register_packet, 2, data, length, TIME_MS2I(timeout));
-    return chibios_to_qmk(&status);
+    return i2c_transfer_blocking(i2c_address, register_packet, 2, data, length, timeout);
 }
 
 void i2c_stop(void) {
+#ifdef I2C_ASYNC_ENABLE
+    i2c_queue_task();
+    while (!i2c_queue_is_idle()) {
+        chBSemWait(&i2c_done_sem);
+        i2c_queue_task();
+    }
+#endif
     i2cStop(&I2C_DRIVER);
 }
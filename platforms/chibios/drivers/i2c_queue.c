@@ -0,0 +1,187 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_queue.h"
+#include "atomic_util.h"
+
+#include <stddef.h>
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_PENDING,
+    SLOT_ACTIVE,
+    SLOT_DONE,
+} slot_state_t;
+
+typedef struct {
+    i2c_transfer_t        transfer;
+    volatile slot_state_t state;
+    i2c_status_t          status;
+    uint16_t              sequence;
+} i2c_slot_t;
+
+static i2c_slot_t slots[I2C_QUEUE_SIZE];
+static uint16_t   next_sequence;
+static uint16_t   next_completion;
+static int8_t     active_slot = -1;
+static uint32_t   coalesced;
+
+static inline bool sequence_before(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) < 0;
+}
+
+static inline bool is_write_only(const i2c_transfer_t *transfer) {
+    return transfer->rx_length == 0;
+}
+
+static bool try_coalesce(const i2c_transfer_t *transfer) {
+    if (!is_write_only(transfer)) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+        i2c_slot_t *slot = &slots[i];
+        if (slot->state != SLOT_PENDING || !is_write_only(&slot->transfer)) {
+            continue;
+        }
+        const i2c_transfer_t *queued = &slot->transfer;
+        if (queued->address == transfer->address && queued->tx_data == transfer->tx_data && queued->tx_length == transfer->tx_length && queued->callback == transfer->callback && queued->context == transfer->context) {
+            if (transfer->priority > queued->priority) {
+                slot->transfer.priority = transfer->priority;
+            }
+            coalesced++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool i2c_queue_submit(const i2c_transfer_t *transfer) {
+    bool queued = false;
+
+    ATOMIC_BLOCK_FORCEON {
+        if (try_coalesce(transfer)) {
+            queued = true;
+        } else {
+            for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+                if (slots[i].state == SLOT_FREE) {
+                    slots[i].transfer = *transfer;
+                    slots[i].sequence = next_sequence++;
+                    slots[i].state    = SLOT_PENDING;
+                    queued            = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (queued) {
+        i2c_queue_notify();
+    }
+    return queued;
+}
+
+const i2c_transfer_t *i2c_queue_begin(void) {
+    const i2c_transfer_t *transfer = NULL;
+
+    ATOMIC_BLOCK_FORCEON {
+        if (active_slot < 0) {
+            int8_t best = -1;
+            for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+                if (slots[i].state != SLOT_PENDING) {
+                    continue;
+                }
+                if (best < 0 || slots[i].transfer.priority > slots[best].transfer.priority || (slots[i].transfer.priority == slots[best].transfer.priority && sequence_before(slots[i].sequence, slots[best].sequence))) {
+                    best = i;
+                }
+            }
+            if (best >= 0) {
+                slots[best].state = SLOT_ACTIVE;
+                active_slot       = best;
+                transfer          = &slots[best].transfer;
+            }
+        }
+    }
+
+    return transfer;
+}
+
+void i2c_queue_end(i2c_status_t status) {
+    ATOMIC_BLOCK_FORCEON {
+        if (active_slot >= 0) {
+            i2c_slot_t *slot = &slots[active_slot];
+            slot->status     = status;
+            // Reuse the sequence field to keep callbacks in completion order
+            slot->sequence = next_completion++;
+            slot->state    = SLOT_DONE;
+            active_slot    = -1;
+        }
+    }
+}
+
+void i2c_queue_task(void) {
+    while (true) {
+        i2c_callback_t callback = NULL;
+        void *         context  = NULL;
+        i2c_status_t   status   = I2C_STATUS_SUCCESS;
+        bool           found    = false;
+
+        ATOMIC_BLOCK_FORCEON {
+            int8_t oldest = -1;
+            for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+                if (slots[i].state == SLOT_DONE && (oldest < 0 || sequence_before(slots[i].sequence, slots[oldest].sequence))) {
+                    oldest = i;
+                }
+            }
+            if (oldest >= 0) {
+                callback             = slots[oldest].transfer.callback;
+                context              = slots[oldest].transfer.context;
+                status               = slots[oldest].status;
+                slots[oldest].state  = SLOT_FREE;
+                found                = true;
+            }
+        }
+
+        if (!found) {
+            break;
+        }
+        // The slot is already released, so the callback may queue the next transfer
+        if (callback) {
+            callback(status, context);
+        }
+    }
+}
+
+bool i2c_queue_is_idle(void) {
+    bool idle = true;
+
+    ATOMIC_BLOCK_FORCEON {
+        for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+            if (slots[i].state != SLOT_FREE) {
+                idle = false;
+                break;
+            }
+        }
+    }
+
+    return idle;
+}
+
+uint32_t i2c_queue_coalesced_count(void) {
+    return coalesced;
+}
+
+__attribute__((weak)) void i2c_queue_notify(void) {}
@@ -0,0 +1,94 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Asynchronous I2C transfer queue.
+ * Transfers are described by an i2c_transfer_t and submitted with
+ * i2c_queue_submit(). The bus backend (i2c_master.c when I2C_ASYNC_ENABLE
+ * is defined) executes them in the background, highest priority first and
+ * in submission order within a priority. Completion callbacks are invoked
+ * from i2c_queue_task(), i.e. from the main loop.
+ *
+ * The data buffers referenced by a transfer must stay valid until its
+ * callback has been invoked.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_master.h"
+
+#ifndef I2C_QUEUE_SIZE
+#    define I2C_QUEUE_SIZE 8
+#endif
+
+typedef enum {
+    I2C_PRIORITY_LOW = 0,
+    I2C_PRIORITY_NORMAL,
+    I2C_PRIORITY_HIGH,
+} i2c_priority_t;
+
+typedef void (*i2c_callback_t)(i2c_status_t status, void *context);
+
+typedef struct {
+    uint8_t        address; // Already shifted, as with i2c_transmit()
+    uint8_t        priority;
+    const uint8_t *tx_data;
+    uint16_t       tx_length;
+    uint8_t *      rx_data;
+    uint16_t       rx_length;
+    uint16_t       timeout;
+    i2c_callback_t callback;
+    void *         context;
+} i2c_transfer_t;
+
+/**
+ * @brief Queue a transfer. Write-only transfers that are identical to one
+ * still waiting in the queue (same device, buffer, length and callback) are
+ * coalesced into it, as the buffer is only read once the transfer starts.
+ *
+ * @return false if the queue is full.
+ */
+bool i2c_queue_submit(const i2c_transfer_t *transfer);
+
+/**
+ * @brief Invoke the callbacks of completed transfers and release their slots.
+ */
+void i2c_queue_task(void);
+
+/**
+ * @brief true when no transfer is queued, in flight or awaiting its callback.
+ */
+bool i2c_queue_is_idle(void);
+
+uint32_t i2c_queue_coalesced_count(void);
+
+/* Backend interface */
+
+/**
+ * @brief Claim the next transfer to put on the bus. Returns NULL if there is
+ * nothing queued or a transfer is already in flight.
+ */
+const i2c_transfer_t *i2c_queue_begin(void);
+
+/**
+ * @brief Report the result of the transfer claimed by i2c_queue_begin().
+ */
+void i2c_queue_end(i2c_status_t status);
+
+/**
+ * @brief Called after a transfer has been queued, so the backend can wake up.
+ */
+void i2c_queue_notify(void);
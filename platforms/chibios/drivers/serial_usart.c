@@ -33,11 +33,21 @@ static SerialConfig serial_config = {
 
 static SerialDriver* serial_driver = &SERIAL_USART_DRIVER;
 
-static inline bool react_to_transactions(void);
 static inline bool __attribute__((nonnull)) receive(uint8_t* destination, const size_t size);
 static inline bool __attribute__((nonnull)) send(const uint8_t* source, const size_t size);
-static inline bool initiate_transaction(uint8_t sstd_index);
 static inline void usart_clear(void);
+static bool        transaction_buffers(uint8_t sstd_index, serial_link_buffers_t* buffers);
+static void        execute_transaction(uint8_t sstd_index);
+
+static const serial_link_io_t serial_link_io = {
+    .send    = send,
+    .receive = receive,
+    .clear   = usart_clear,
+    .buffers = transaction_buffers,
+    .execute = execute_transaction,
+};
+
+static serial_link_t serial_link;
 
 /**
  * @brief Clear the receive input queue.
@@ -158,6 +168,35 @@ __attribute__((weak, nonnull)) void usart_slave_init(SerialDriver** driver) {
     usart_init();
 }
 
+/**
+ * @brief Buffers of a transaction in the split shared memory.
+ */
+static bool transaction_buffers(uint8_t sstd_index, serial_link_buffers_t* buffers) {
+    /* Sanity check that we are actually handling a valid transaction. */
+    if (sstd_index >= NUM_TOTAL_TRANSACTIONS) {
+        return false;
+    }
+
+    split_transaction_desc_t* trans = &split_transaction_table[sstd_index];
+
+    buffers->request_size = trans->initiator2target_buffer_size;
+    buffers->request      = split_trans_initiator2target_buffer(trans);
+    buffers->reply_size   = trans->target2initiator_buffer_size;
+    buffers->reply        = split_trans_target2initiator_buffer(trans);
+    return true;
+}
+
+/**
+ * @brief Allow any slave processing to occur, once the transaction buffer from the master is in place.
+ */
+static void execute_transaction(uint8_t sstd_index) {
+    split_transaction_desc_t* trans = &split_transaction_table[sstd_index];
+
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+    }
+}
+
 /**
  * @brief This thread runs on the slave and responds to transactions initiated
  * by the master.
@@ -168,7 +207,10 @@ static THD_FUNCTION(SlaveThread, arg) {
     chRegSetThreadName("usart_tx_rx");
 
     while (true) {
-        if (!react_to_transactions()) {
+        /* Wait until there is a transaction for us. */
+        uint8_t sstd_index = (uint8_t)sdGet(serial_driver);
+
+        if (!serial_link_react(&serial_link, sstd_index)) {
             /* Clear the receive queue, to start with a clean slate.
              * Parts of failed transactions or spurious bytes could still be in it. */
             usart_clear();
@@ -182,55 +224,13 @@ static THD_FUNCTION(SlaveThread, arg) {
 void soft_serial_target_init(void) {
     usart_slave_init(&serial_driver);
 
+    serial_link_init(&serial_link, &serial_link_io);
     sdStart(serial_driver, &serial_config);
 
     /* Start transport thread. */
     chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
 }
 
-/**
- * @brief React to transactions started by the master.
- */
-static inline bool react_to_transactions(void) {
-    /* Wait until there is a transaction for us. */
-    uint8_t sstd_index = (uint8_t)sdGet(serial_driver);
-
-    /* Sanity check that we are actually responding to a valid transaction. */
-    if (sstd_index >= NUM_TOTAL_TRANSACTIONS) {
-        return false;
-    }
-
-    split_transaction_desc_t* trans = &split_transaction_table[sstd_index];
-
-    /* Send back the handshake which is XORed as a simple checksum,
-     to signal that the slave is ready to receive possible transaction buffers  */
-    sstd_index ^= HANDSHAKE_MAGIC;
-    if (!send(&sstd_index, sizeof(sstd_index))) {
-        return false;
-    }
-
-    /* Receive transaction buffer from the master. If this transaction requires it.*/
-    if (trans->initiator2target_buffer_size) {
-        if (!receive(split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size)) {
-            return false;
-        }
-    }
-
-    /* Allow any slave processing to occur. */
-    if (trans->slave_callback) {
-        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size, split_trans_target2initiator_buffer(trans));
-    }
-
-    /* Send transaction buffer to the master. If this transaction requires it. */
-    if (trans->target2initiator_buffer_size) {
-        if (!send(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size)) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 /**
  * @brief Master specific initializations.
  */
@@ -241,66 +241,38 @@ void soft_serial_initiator_init(void) {
     serial_config.cr2 |= USART_CR2_SWAP; // master has swapped TX/RX pins
 #endif
 
+    serial_link_init(&serial_link, &serial_link_io);
     sdStart(serial_driver, &serial_config);
 }
 
 /**
  * @brief Start transaction from the master half to the slave half.
  *
+ * The request and the reply each travel as one checked frame, see serial_link.h.
+ * NACKed or damaged frames are sent again up to SERIAL_LINK_RETRIES times,
+ * a timeout fails the transaction and leaves retrying to transactions.c.
+ *
  * @param index Transaction Table index of the transaction to start.
  * @return bool Indicates success of transaction.
  */
 bool soft_serial_transaction(int index) {
-    /* Clear the receive queue, to start with a clean slate.
-     * Parts of failed transactions or spurious bytes could still be in it. */
-    usart_clear();
-    return initiate_transaction((uint8_t)index);
-}
-
-/**
- * @brief Initiate transaction to slave half.
- */
-static inline bool initiate_transaction(uint8_t sstd_index) {
     /* Sanity check that we are actually starting a valid transaction. */
-    if (sstd_index >= NUM_TOTAL_TRANSACTIONS) {
+    if (index < 0 || index >= NUM_TOTAL_TRANSACTIONS) {
         dprintln("USART: Illegal transaction Id.");
         return false;
     }
 
-    split_transaction_desc_t* trans = &split_transaction_table[sstd_index];
-
-    /* Send transaction table index to the slave, which doubles as basic handshake token. */
-    if (!send(&sstd_index, sizeof(sstd_index))) {
-        dprintln("USART: Send Handshake failed.");
+    if (!serial_link_initiate(&serial_link, (uint8_t)index)) {
+        dprintln("USART: Transaction failed.");
         return false;
     }
 
-    uint8_t sstd_index_shake = 0xFF;
-
-    /* Which we always read back first so that we can error out correctly.
-     *   - due to the half duplex limitations on return codes, we always have to read *something*.
-     *   - without the read, write only transactions *always* succeed, even during the boot process where the slave is not ready.
-     */
-    if (!receive(&sstd_index_shake, sizeof(sstd_index_shake)) || (sstd_index_shake != (sstd_index ^ HANDSHAKE_MAGIC))) {
-        dprintln("USART: Handshake failed.");
-        return false;
-    }
-
-    /* Send transaction buffer to the slave. If this transaction requires it. */
-    if (trans->initiator2target_buffer_size) {
-        if (!send(split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size)) {
-            dprintln("USART: Send failed.");
-            return false;
-        }
-    }
-
-    /* Receive transaction buffer from the slave. If this transaction requires it. */
-    if (trans->target2initiator_buffer_size) {
-        if (!receive(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size)) {
-            dprintln("USART: Receive failed.");
-            return false;
-        }
-    }
-
     return true;
 }
+
+/**
+ * @brief Error counters of the transactions this half took part in.
+ */
+const serial_link_counters_t* soft_serial_get_counters(void) {
+    return &serial_link.counters;
+}
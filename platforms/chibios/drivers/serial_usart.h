@@ -18,6 +18,7 @@
 
 #include "quantum.h"
 #include "serial.h"
+#include "serial_link.h"
 #include "printf.h"
 
 #include <ch.h>
@@ -113,4 +114,3 @@
 #    define SERIAL_USART_TIMEOUT 20
 #endif
 
-#define HANDSHAKE_MAGIC 7
@@ -15,8 +15,12 @@
  */
 
 #include "spi_master.h"
+#ifdef SPI_ASYNC_ENABLE
+#    include "spi_queue.h"
+#endif
 
 #include "timer.h"
+#include "wait.h"
 
 static pin_t currentSlavePin = NO_PIN;
 
@@ -49,7 +53,7 @@ __attribute__((weak)) void spi_init(void) {
     }
 }
 
-bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+static bool spi_start_unlocked(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     if (currentSlavePin != NO_PIN || slavePin == NO_PIN) {
         return false;
     }
@@ -251,10 +255,137 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
-void spi_stop(void) {
+static void spi_stop_unlocked(void) {
     if (currentSlavePin != NO_PIN) {
         spiUnselect(&SPI_DRIVER);
         spiStop(&SPI_DRIVER);
         currentSlavePin = NO_PIN;
     }
 }
+
+#ifdef SPI_ASYNC_ENABLE
+/* The blocking API and the queue thread share the peripheral, so a blocking
+ * spi_start()/spi_stop() pair holds the bus mutex for its whole duration.
+ */
+static MUTEX_DECL(spi_bus_mutex);
+static thread_t* spi_bus_owner = NULL;
+
+static BSEMAPHORE_DECL(spi_work_sem, true);
+
+static void spi_execute(const spi_transaction_t* transaction) {
+    for (uint8_t i = 0; i < transaction->segment_count; i++) {
+        const spi_segment_t* segment = &transaction->segments[i];
+        if (segment->length > 0) {
+            if (segment->tx_data && segment->rx_data) {
+                spiExchange(&SPI_DRIVER, segment->length, segment->tx_data, segment->rx_data);
+            } else if (segment->tx_data) {
+                spiSend(&SPI_DRIVER, segment->length, segment->tx_data);
+            } else if (segment->rx_data) {
+                spiReceive(&SPI_DRIVER, segment->length, segment->rx_data);
+            } else {
+                spiIgnore(&SPI_DRIVER, segment->length);
+            }
+        }
+        if (segment->delay_us > 0) {
+            wait_us(segment->delay_us);
+        }
+    }
+}
+
+static void spi_release_bus(void) {
+    spi_stop_unlocked();
+    spi_bus_owner = NULL;
+    chMtxUnlock(&spi_bus_mutex);
+}
+
+static THD_WORKING_AREA(waSPIThread, 256);
+static THD_FUNCTION(SPIThread, arg) {
+    (void)arg;
+    chRegSetThreadName("spi_queue");
+
+    // Device the peripheral is still configured for, when batching transactions
+    const spi_device_t* batched_device = NULL;
+
+    while (true) {
+        const spi_transaction_t* transaction;
+        while ((transaction = spi_queue_begin()) != NULL) {
+            const spi_device_t* device  = transaction->device;
+            bool                success = true;
+
+            if (batched_device == device) {
+                spiSelect(&SPI_DRIVER);
+            } else {
+                if (batched_device) {
+                    spi_release_bus();
+                }
+                chMtxLock(&spi_bus_mutex);
+                spi_bus_owner = chThdGetSelfX();
+                success       = spi_start_unlocked(device->slave_pin, device->lsb_first, device->mode, device->divisor);
+            }
+
+            if (success) {
+                spi_execute(transaction);
+            }
+
+            if (success && spi_queue_has_pending(device)) {
+                // Keep the bus and peripheral configuration for the next transaction
+                spiUnselect(&SPI_DRIVER);
+                batched_device = device;
+            } else {
+                spi_release_bus();
+                batched_device = NULL;
+            }
+
+            spi_queue_end(success);
+        }
+        if (batched_device) {
+            spi_release_bus();
+            batched_device = NULL;
+        }
+        chBSemWait(&spi_work_sem);
+    }
+}
+
+void spi_queue_notify(void) {
+    static bool thread_started = false;
+    if (!thread_started) {
+        thread_started = true;
+        chThdCreateStatic(waSPIThread, sizeof(waSPIThread), HIGHPRIO, SPIThread, NULL);
+    }
+    chBSemSignal(&spi_work_sem);
+}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    // Nested spi_start() calls from the same thread fail, as they do without the queue
+    if (spi_bus_owner == chThdGetSelfX()) {
+        return false;
+    }
+
+    chMtxLock(&spi_bus_mutex);
+    spi_bus_owner = chThdGetSelfX();
+    if (!spi_start_unlocked(slavePin, lsbFirst, mode, divisor)) {
+        spi_bus_owner = NULL;
+        chMtxUnlock(&spi_bus_mutex);
+        return false;
+    }
+    return true;
+}
+
+void spi_stop(void) {
+    if (spi_bus_owner != chThdGetSelfX()) {
+        return;
+    }
+
+    spi_stop_unlocked();
+    spi_bus_owner = NULL;
+    chMtxUnlock(&spi_bus_mutex);
+}
+#else
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    return spi_start_unlocked(slavePin, lsbFirst, mode, divisor);
+}
+
+void spi_stop(void) {
+    spi_stop_unlocked();
+}
+#endif
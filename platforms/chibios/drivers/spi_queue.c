@@ -0,0 +1,178 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spi_queue.h"
+#include "atomic_util.h"
+
+#include <stddef.h>
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_PENDING,
+    SLOT_ACTIVE,
+    SLOT_DONE,
+} slot_state_t;
+
+typedef struct {
+    spi_transaction_t     transaction;
+    volatile slot_state_t state;
+    bool                  success;
+    uint16_t              sequence;
+} spi_slot_t;
+
+static spi_slot_t          slots[SPI_QUEUE_SIZE];
+static uint16_t            next_sequence;
+static uint16_t            next_completion;
+static int8_t              active_slot = -1;
+static const spi_device_t *last_device;
+static uint8_t             batch_count;
+
+static inline bool sequence_before(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) < 0;
+}
+
+static int8_t oldest_pending(const spi_device_t *device) {
+    int8_t oldest = -1;
+    for (uint8_t i = 0; i < SPI_QUEUE_SIZE; i++) {
+        if (slots[i].state != SLOT_PENDING || (device && slots[i].transaction.device != device)) {
+            continue;
+        }
+        if (oldest < 0 || sequence_before(slots[i].sequence, slots[oldest].sequence)) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+bool spi_queue_submit(const spi_transaction_t *transaction) {
+    bool queued = false;
+
+    ATOMIC_BLOCK_FORCEON {
+        for (uint8_t i = 0; i < SPI_QUEUE_SIZE; i++) {
+            if (slots[i].state == SLOT_FREE) {
+                slots[i].transaction = *transaction;
+                slots[i].sequence    = next_sequence++;
+                slots[i].state       = SLOT_PENDING;
+                queued               = true;
+                break;
+            }
+        }
+    }
+
+    if (queued) {
+        spi_queue_notify();
+    }
+    return queued;
+}
+
+const spi_transaction_t *spi_queue_begin(void) {
+    const spi_transaction_t *transaction = NULL;
+
+    ATOMIC_BLOCK_FORCEON {
+        if (active_slot < 0) {
+            int8_t next = -1;
+            if (last_device && batch_count < SPI_QUEUE_BATCH_LIMIT) {
+                next = oldest_pending(last_device);
+            }
+            if (next < 0) {
+                next = oldest_pending(NULL);
+            }
+            if (next >= 0) {
+                const spi_device_t *device = slots[next].transaction.device;
+                batch_count                = (device == last_device) ? batch_count + 1 : 1;
+                last_device                = device;
+                slots[next].state          = SLOT_ACTIVE;
+                active_slot                = next;
+                transaction                = &slots[next].transaction;
+            }
+        }
+    }
+
+    return transaction;
+}
+
+void spi_queue_end(bool success) {
+    ATOMIC_BLOCK_FORCEON {
+        if (active_slot >= 0) {
+            spi_slot_t *slot = &slots[active_slot];
+            slot->success    = success;
+            // Reuse the sequence field to keep callbacks in completion order
+            slot->sequence = next_completion++;
+            slot->state    = SLOT_DONE;
+            active_slot    = -1;
+        }
+    }
+}
+
+bool spi_queue_has_pending(const spi_device_t *device) {
+    bool pending = false;
+
+    ATOMIC_BLOCK_FORCEON {
+        pending = oldest_pending(device) >= 0;
+    }
+
+    return pending;
+}
+
+void spi_queue_task(void) {
+    while (true) {
+        spi_callback_t callback = NULL;
+        void *         context  = NULL;
+        bool           success  = false;
+        bool           found    = false;
+
+        ATOMIC_BLOCK_FORCEON {
+            int8_t oldest = -1;
+            for (uint8_t i = 0; i < SPI_QUEUE_SIZE; i++) {
+                if (slots[i].state == SLOT_DONE && (oldest < 0 || sequence_before(slots[i].sequence, slots[oldest].sequence))) {
+                    oldest = i;
+                }
+            }
+            if (oldest >= 0) {
+                callback            = slots[oldest].transaction.callback;
+                context             = slots[oldest].transaction.context;
+                success             = slots[oldest].success;
+                slots[oldest].state = SLOT_FREE;
+                found               = true;
+            }
+        }
+
+        if (!found) {
+            break;
+        }
+        // The slot is already released, so the callback may queue the next transaction
+        if (callback) {
+            callback(success, context);
+        }
+    }
+}
+
+bool spi_queue_is_idle(void) {
+    bool idle = true;
+
+    ATOMIC_BLOCK_FORCEON {
+        for (uint8_t i = 0; i < SPI_QUEUE_SIZE; i++) {
+            if (slots[i].state != SLOT_FREE) {
+                idle = false;
+                break;
+            }
+        }
+    }
+
+    return idle;
+}
+
+__attribute__((weak)) void spi_queue_notify(void) {}
@@ -0,0 +1,110 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Asynchronous SPI transaction queue.
+ * A transaction selects a device, runs a list of segments (each one sending
+ * and/or receiving a buffer, optionally followed by a delay) and deselects
+ * the device again. The bus backend (spi_master.c when SPI_ASYNC_ENABLE is
+ * defined) executes transactions in the background. Completion callbacks
+ * are invoked from spi_queue_task(), i.e. from the main loop.
+ *
+ * Buffers, segments and the device referenced by a transaction must stay
+ * valid until its callback has been invoked.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+#ifndef SPI_QUEUE_SIZE
+#    define SPI_QUEUE_SIZE 8
+#endif
+
+/* Maximum number of consecutive transactions for the same device that may
+ * be pulled ahead of older transactions for other devices.
+ */
+#ifndef SPI_QUEUE_BATCH_LIMIT
+#    define SPI_QUEUE_BATCH_LIMIT 4
+#endif
+
+typedef struct {
+    pin_t    slave_pin;
+    bool     lsb_first;
+    uint8_t  mode;
+    uint16_t divisor;
+} spi_device_t;
+
+typedef struct {
+    const uint8_t *tx_data;  // NULL to clock out zeroes
+    uint8_t *      rx_data;  // NULL to discard received data
+    uint16_t       length;
+    uint16_t       delay_us; // Delay after the segment, with the device still selected
+} spi_segment_t;
+
+typedef void (*spi_callback_t)(bool success, void *context);
+
+typedef struct {
+    const spi_device_t * device;
+    const spi_segment_t *segments;
+    uint8_t              segment_count;
+    spi_callback_t       callback;
+    void *               context;
+} spi_transaction_t;
+
+/**
+ * @brief Queue a transaction.
+ *
+ * @return false if the queue is full.
+ */
+bool spi_queue_submit(const spi_transaction_t *transaction);
+
+/**
+ * @brief Invoke the callbacks of completed transactions and release their slots.
+ */
+void spi_queue_task(void);
+
+/**
+ * @brief true when no transaction is queued, in flight or awaiting its callback.
+ */
+bool spi_queue_is_idle(void);
+
+/* Backend interface */
+
+/**
+ * @brief Claim the next transaction to execute. Transactions are executed in
+ * submission order, except that pending transactions for the device used by
+ * the previous one are batched ahead, up to SPI_QUEUE_BATCH_LIMIT in a row,
+ * so the backend can keep the peripheral configured between them.
+ *
+ * @return NULL if there is nothing queued or a transaction is in flight.
+ */
+const spi_transaction_t *spi_queue_begin(void);
+
+/**
+ * @brief Report the result of the transaction claimed by spi_queue_begin().
+ */
+void spi_queue_end(bool success);
+
+/**
+ * @brief true if a transaction for the given device is waiting in the queue.
+ */
+bool spi_queue_has_pending(const spi_device_t *device);
+
+/**
+ * @brief Called after a transaction has been queued, so the backend can wake up.
+ */
+void spi_queue_notify(void);
@@ -77,7 +77,8 @@ uint16_t timer_read(void) {
     return (uint16_t)timer_read32();
 }
 
-uint32_t timer_read32(void) {
+// Get the ticks since timer_clear(), and the milliseconds taken out of them when they would have overflowed.
+static uint32_t read_ticks(uint32_t *offset_ms) {
     chSysLock();
     uint32_t ticks = get_system_time_ticks() - ticks_offset;
     if (ticks < last_ticks) {
@@ -91,11 +92,26 @@ uint32_t timer_read32(void) {
         ticks_offset += OVERFLOW_ADJUST_TICKS;
         ms_offset += OVERFLOW_ADJUST_MS;
     }
-    last_ticks              = ticks;
-    uint32_t ms_offset_copy = ms_offset; // read while still holding the lock to ensure a consistent value
+    last_ticks = ticks;
+    *offset_ms = ms_offset; // read while still holding the lock to ensure a consistent value
     chSysUnlock();
 
-    return (uint32_t)TIME_I2MS(ticks) + ms_offset_copy;
+    return ticks;
+}
+
+uint32_t timer_read32(void) {
+    uint32_t offset_ms;
+    uint32_t ticks = read_ticks(&offset_ms);
+
+    return (uint32_t)TIME_I2MS(ticks) + offset_ms;
+}
+
+// Only as precise as the system tick, 10us with the default CH_CFG_ST_FREQUENCY
+uint32_t timer_read_us(void) {
+    uint32_t offset_ms;
+    uint32_t ticks = read_ticks(&offset_ms);
+
+    return (uint32_t)(((uint64_t)ticks * 1000000) / CH_CFG_ST_FREQUENCY) + offset_ms * 1000;
 }
 
 uint16_t timer_elapsed(uint16_t last) {
@@ -105,3 +121,7 @@ uint16_t timer_elapsed(uint16_t last) {
 uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(timer_read32(), last);
 }
+
+uint32_t timer_elapsed_us(uint32_t last) {
+    return TIMER_DIFF_32(timer_read_us(), last);
+}
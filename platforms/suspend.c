@@ -8,6 +8,15 @@
 __attribute__((weak)) void matrix_power_up(void) {}
 __attribute__((weak)) void matrix_power_down(void) {}
 
+// Matrices without a cheaper way to tell fall back to a full scan
+__attribute__((weak)) bool matrix_wake_check(void) {
+    matrix_scan();
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r)) return true;
+    }
+    return false;
+}
+
 /** \brief Run user level Power down
  *
  * FIXME: needs doc
@@ -42,10 +51,7 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) {
  */
 bool suspend_wakeup_condition(void) {
     matrix_power_up();
-    matrix_scan();
+    bool wakeup = matrix_wake_check();
     matrix_power_down();
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        if (matrix_get_row(r)) return true;
-    }
-    return false;
+    return wakeup;
 }
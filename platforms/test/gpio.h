@@ -0,0 +1,64 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint8_t pin_t;
+
+/* GPIO mock, backed by gpio_mock.c.
+ *
+ * Pins are encoded as port << 4 | pad, like on AVR, with 16 bit ports.
+ * Input levels are set with gpio_mock_set_pin(), every pin reads high
+ * after gpio_mock_reset().
+ */
+
+typedef uint16_t port_data_t;
+
+#define GPIO_MOCK_PORT_COUNT 15
+#define GPIO_MOCK_PIN(port, pad) ((pin_t)(((port) << 4) | (pad)))
+
+extern uint16_t gpio_mock_pin_reads;
+extern uint16_t gpio_mock_port_reads;
+
+void        gpio_mock_reset(void);
+void        gpio_mock_set_pin(pin_t pin, bool level);
+bool        gpio_mock_read_pin(pin_t pin);
+port_data_t gpio_mock_read_port(pin_t pin);
+
+/* Operation of GPIO by pin. */
+
+#define setPinInput(pin) ((void)(pin))
+#define setPinInputHigh(pin) ((void)(pin))
+#define setPinInputLow(pin) ((void)(pin))
+#define setPinOutputPushPull(pin) ((void)(pin))
+#define setPinOutputOpenDrain(pin) ((void)(pin))
+#define setPinOutput(pin) setPinOutputPushPull(pin)
+
+#define writePinHigh(pin) gpio_mock_set_pin((pin), true)
+#define writePinLow(pin) gpio_mock_set_pin((pin), false)
+#define writePin(pin, level) gpio_mock_set_pin((pin), (level))
+
+#define readPin(pin) gpio_mock_read_pin(pin)
+
+#define togglePin(pin) gpio_mock_set_pin((pin), !gpio_mock_read_pin(pin))
+
+/* Operation of GPIO by port. */
+
+#define readPort(pin) gpio_mock_read_port(pin)
+#define getPinPort(pin) ((pin) >> 4)
+#define getPinPad(pin) ((pin)&0xF)
@@ -0,0 +1,57 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gpio.h"
+
+static port_data_t ports[GPIO_MOCK_PORT_COUNT];
+
+uint16_t gpio_mock_pin_reads;
+uint16_t gpio_mock_port_reads;
+
+void gpio_mock_reset(void) {
+    for (uint8_t i = 0; i < GPIO_MOCK_PORT_COUNT; i++) {
+        ports[i] = (port_data_t)~0;
+    }
+    gpio_mock_pin_reads  = 0;
+    gpio_mock_port_reads = 0;
+}
+
+void gpio_mock_set_pin(pin_t pin, bool level) {
+    if (getPinPort(pin) >= GPIO_MOCK_PORT_COUNT) {
+        return;
+    }
+    if (level) {
+        ports[getPinPort(pin)] |= (port_data_t)1 << getPinPad(pin);
+    } else {
+        ports[getPinPort(pin)] &= ~((port_data_t)1 << getPinPad(pin));
+    }
+}
+
+bool gpio_mock_read_pin(pin_t pin) {
+    gpio_mock_pin_reads++;
+    if (getPinPort(pin) >= GPIO_MOCK_PORT_COUNT) {
+        return true;
+    }
+    return ports[getPinPort(pin)] & ((port_data_t)1 << getPinPad(pin));
+}
+
+port_data_t gpio_mock_read_port(pin_t pin) {
+    gpio_mock_port_reads++;
+    if (getPinPort(pin) >= GPIO_MOCK_PORT_COUNT) {
+        return (port_data_t)~0;
+    }
+    return ports[getPinPort(pin)];
+}
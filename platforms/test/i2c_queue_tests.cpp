@@ -0,0 +1,279 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "i2c_queue.h"
+}
+
+/* Simulated bus: executes queued transfers one at a time and records what
+ * went over the wire. Bus time assumes 400kHz, 9 clocks per byte plus the
+ * address byte and start/stop overhead.
+ */
+struct BusRecord {
+    uint8_t              address;
+    std::vector<uint8_t> tx;
+    uint16_t             rx_length;
+};
+
+static std::vector<BusRecord> bus_log;
+static uint32_t               bus_time_us;
+static i2c_status_t           bus_status = I2C_STATUS_SUCCESS;
+
+static bool bus_step(void) {
+    const i2c_transfer_t *transfer = i2c_queue_begin();
+    if (transfer == NULL) {
+        return false;
+    }
+    BusRecord record = {transfer->address, std::vector<uint8_t>(transfer->tx_data, transfer->tx_data + transfer->tx_length), transfer->rx_length};
+    for (uint16_t i = 0; i < transfer->rx_length; i++) {
+        transfer->rx_data[i] = (uint8_t)(0xA0 + i);
+    }
+    bus_log.push_back(record);
+    bus_time_us += ((1 + transfer->tx_length + transfer->rx_length) * 9 + 2) * 10 / 4;
+    i2c_queue_end(bus_status);
+    return true;
+}
+
+static void bus_run(void) {
+    while (bus_step()) {
+    }
+}
+
+struct CallbackRecord {
+    i2c_status_t status;
+    int          id;
+};
+
+static std::vector<CallbackRecord> callback_log;
+
+static void record_callback(i2c_status_t status, void *context) {
+    callback_log.push_back({status, (int)(intptr_t)context});
+}
+
+static i2c_transfer_t make_write(uint8_t address, const uint8_t *data, uint16_t length, uint8_t priority, int id) {
+    i2c_transfer_t transfer = {};
+    transfer.address        = address;
+    transfer.priority       = priority;
+    transfer.tx_data        = data;
+    transfer.tx_length      = length;
+    transfer.timeout        = 100;
+    transfer.callback       = record_callback;
+    transfer.context        = (void *)(intptr_t)id;
+    return transfer;
+}
+
+class I2CQueue : public testing::Test {
+   protected:
+    void SetUp() override {
+        bus_log.clear();
+        callback_log.clear();
+        bus_time_us = 0;
+        bus_status  = I2C_STATUS_SUCCESS;
+    }
+    void TearDown() override {
+        bus_run();
+        i2c_queue_task();
+        EXPECT_TRUE(i2c_queue_is_idle());
+    }
+};
+
+static const uint8_t oled_data[]  = {0x40, 0x00, 0x01, 0x02, 0x03};
+static const uint8_t led_data[]   = {0x24, 0xFF, 0xFF, 0xFF};
+static const uint8_t other_data[] = {0x10, 0x20};
+
+TEST_F(I2CQueue, HigherPriorityGoesFirst) {
+    i2c_transfer_t low    = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_LOW, 1);
+    i2c_transfer_t normal = make_write(0xE8, led_data, sizeof(led_data), I2C_PRIORITY_NORMAL, 2);
+    i2c_transfer_t high   = make_write(0xA0, other_data, sizeof(other_data), I2C_PRIORITY_HIGH, 3);
+    ASSERT_TRUE(i2c_queue_submit(&low));
+    ASSERT_TRUE(i2c_queue_submit(&normal));
+    ASSERT_TRUE(i2c_queue_submit(&high));
+
+    bus_run();
+    ASSERT_EQ(bus_log.size(), 3u);
+    EXPECT_EQ(bus_log[0].address, 0xA0);
+    EXPECT_EQ(bus_log[1].address, 0xE8);
+    EXPECT_EQ(bus_log[2].address, 0x78);
+}
+
+TEST_F(I2CQueue, SubmissionOrderWithinPriority) {
+    i2c_transfer_t first  = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_NORMAL, 1);
+    i2c_transfer_t second = make_write(0x78, led_data, sizeof(led_data), I2C_PRIORITY_NORMAL, 2);
+    i2c_transfer_t third  = make_write(0x78, other_data, sizeof(other_data), I2C_PRIORITY_NORMAL, 3);
+    ASSERT_TRUE(i2c_queue_submit(&first));
+    ASSERT_TRUE(i2c_queue_submit(&second));
+    ASSERT_TRUE(i2c_queue_submit(&third));
+
+    bus_run();
+    i2c_queue_task();
+    ASSERT_EQ(callback_log.size(), 3u);
+    EXPECT_EQ(callback_log[0].id, 1);
+    EXPECT_EQ(callback_log[1].id, 2);
+    EXPECT_EQ(callback_log[2].id, 3);
+    EXPECT_EQ(bus_log[1].tx, std::vector<uint8_t>(led_data, led_data + sizeof(led_data)));
+}
+
+TEST_F(I2CQueue, InFlightTransferIsNotPreempted) {
+    i2c_transfer_t low  = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_LOW, 1);
+    i2c_transfer_t high = make_write(0xA0, other_data, sizeof(other_data), I2C_PRIORITY_HIGH, 2);
+    ASSERT_TRUE(i2c_queue_submit(&low));
+    const i2c_transfer_t *active = i2c_queue_begin();
+    ASSERT_NE(active, nullptr);
+    EXPECT_EQ(active->address, 0x78);
+
+    ASSERT_TRUE(i2c_queue_submit(&high));
+    EXPECT_EQ(i2c_queue_begin(), nullptr);
+    i2c_queue_end(I2C_STATUS_SUCCESS);
+
+    bus_run();
+    ASSERT_EQ(bus_log.size(), 1u);
+    EXPECT_EQ(bus_log[0].address, 0xA0);
+}
+
+TEST_F(I2CQueue, CallbacksRunFromTaskWithStatus) {
+    i2c_transfer_t transfer = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_NORMAL, 7);
+    bus_status              = I2C_STATUS_TIMEOUT;
+    ASSERT_TRUE(i2c_queue_submit(&transfer));
+    bus_run();
+    EXPECT_TRUE(callback_log.empty());
+    EXPECT_FALSE(i2c_queue_is_idle());
+
+    i2c_queue_task();
+    ASSERT_EQ(callback_log.size(), 1u);
+    EXPECT_EQ(callback_log[0].id, 7);
+    EXPECT_EQ(callback_log[0].status, I2C_STATUS_TIMEOUT);
+    EXPECT_TRUE(i2c_queue_is_idle());
+}
+
+TEST_F(I2CQueue, IdenticalPendingWritesAreCoalesced) {
+    uint32_t       before   = i2c_queue_coalesced_count();
+    i2c_transfer_t transfer = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_LOW, 1);
+    ASSERT_TRUE(i2c_queue_submit(&transfer));
+    ASSERT_TRUE(i2c_queue_submit(&transfer));
+    transfer.priority = I2C_PRIORITY_HIGH;
+    ASSERT_TRUE(i2c_queue_submit(&transfer));
+
+    i2c_transfer_t normal = make_write(0xE8, led_data, sizeof(led_data), I2C_PRIORITY_NORMAL, 2);
+    ASSERT_TRUE(i2c_queue_submit(&normal));
+
+    bus_run();
+    ASSERT_EQ(bus_log.size(), 2u);
+    // The merged transfer inherits the highest priority it was submitted with
+    EXPECT_EQ(bus_log[0].address, 0x78);
+    EXPECT_EQ(i2c_queue_coalesced_count() - before, 2u);
+}
+
+TEST_F(I2CQueue, ReadsAreNotCoalesced) {
+    uint32_t       before = i2c_queue_coalesced_count();
+    uint8_t        reg    = 0x00;
+    uint8_t        rx[2]  = {0};
+    i2c_transfer_t read   = make_write(0xA0, &reg, 1, I2C_PRIORITY_NORMAL, 1);
+    read.rx_data          = rx;
+    read.rx_length        = sizeof(rx);
+    ASSERT_TRUE(i2c_queue_submit(&read));
+    ASSERT_TRUE(i2c_queue_submit(&read));
+
+    bus_run();
+    EXPECT_EQ(bus_log.size(), 2u);
+    EXPECT_EQ(i2c_queue_coalesced_count(), before);
+    EXPECT_EQ(rx[0], 0xA0);
+    EXPECT_EQ(rx[1], 0xA1);
+}
+
+TEST_F(I2CQueue, FullQueueRejectsUntilTaskReleasesSlots) {
+    uint8_t buffers[I2C_QUEUE_SIZE + 1][2] = {{0}};
+    for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+        i2c_transfer_t transfer = make_write(0x78, buffers[i], 2, I2C_PRIORITY_NORMAL, i);
+        ASSERT_TRUE(i2c_queue_submit(&transfer));
+    }
+    i2c_transfer_t extra = make_write(0x78, buffers[I2C_QUEUE_SIZE], 2, I2C_PRIORITY_NORMAL, I2C_QUEUE_SIZE);
+    EXPECT_FALSE(i2c_queue_submit(&extra));
+
+    // Completed transfers hold their slot until the callback has run
+    bus_run();
+    EXPECT_FALSE(i2c_queue_submit(&extra));
+    i2c_queue_task();
+    EXPECT_TRUE(i2c_queue_submit(&extra));
+}
+
+static int resubmit_remaining;
+
+static void resubmit_callback(i2c_status_t status, void *context) {
+    if (resubmit_remaining-- > 0) {
+        EXPECT_TRUE(i2c_queue_submit((const i2c_transfer_t *)context));
+    }
+}
+
+TEST_F(I2CQueue, CallbackCanQueueNextTransfer) {
+    i2c_transfer_t transfer = make_write(0x78, oled_data, sizeof(oled_data), I2C_PRIORITY_NORMAL, 0);
+    transfer.callback       = resubmit_callback;
+    transfer.context        = &transfer;
+    resubmit_remaining      = 3;
+    ASSERT_TRUE(i2c_queue_submit(&transfer));
+
+    for (int i = 0; i < 5; i++) {
+        bus_run();
+        i2c_queue_task();
+    }
+    EXPECT_EQ(bus_log.size(), 4u);
+}
+
+TEST_F(I2CQueue, RepeatedFlushesDoNotOutrunTheBus) {
+    /* A display flushing its buffer every main loop iteration while the bus
+     * only completes one transfer every fourth iteration: the display buffer
+     * must not pile up, and interleaved register writes keep their order.
+     */
+    uint8_t        framebuffer[129] = {0x40};
+    i2c_transfer_t flush            = make_write(0x78, framebuffer, sizeof(framebuffer), I2C_PRIORITY_LOW, 1);
+    int            submitted        = 0;
+    int            led_writes       = 0;
+    uint8_t        led_regs[8][2];
+
+    for (int loop = 0; loop < 64; loop++) {
+        ASSERT_TRUE(i2c_queue_submit(&flush));
+        submitted++;
+        if (loop % 8 == 0) {
+            led_regs[led_writes][0] = 0x24;
+            led_regs[led_writes][1] = (uint8_t)led_writes;
+            i2c_transfer_t led      = make_write(0xE8, led_regs[led_writes], 2, I2C_PRIORITY_HIGH, 100 + led_writes);
+            ASSERT_TRUE(i2c_queue_submit(&led));
+            led_writes++;
+        }
+        if (loop % 4 == 3) {
+            bus_step();
+        }
+        i2c_queue_task();
+    }
+    bus_run();
+    i2c_queue_task();
+
+    int flushes = 0;
+    int led_seq = 0;
+    for (const BusRecord &record : bus_log) {
+        if (record.address == 0x78) {
+            flushes++;
+        } else {
+            EXPECT_EQ(record.tx[1], led_seq++);
+        }
+    }
+    EXPECT_EQ(led_seq, led_writes);
+    EXPECT_LE(flushes, submitted / 4 + 1);
+    EXPECT_LT(bus_time_us, (uint32_t)submitted * (130 * 9 + 2) * 10 / 4);
+}
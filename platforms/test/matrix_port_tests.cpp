@@ -0,0 +1,117 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_port.h"
+}
+
+#define PIN(port, pad) GPIO_MOCK_PIN(port, pad)
+
+static uint32_t random_state;
+
+static uint32_t next_random(void) {
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 16;
+}
+
+class MatrixPort : public testing::Test {
+   protected:
+    void SetUp() override {
+        gpio_mock_reset();
+        random_state = 1;
+    }
+
+    // Reference result, read pin by pin
+    uint32_t read_pins(const pin_t *pins, uint8_t count) {
+        uint32_t bits = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (pins[i] != NO_PIN && gpio_mock_read_pin(pins[i])) {
+                bits |= (uint32_t)1 << i;
+            }
+        }
+        return bits;
+    }
+
+    void randomize(const pin_t *pins, uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            gpio_mock_set_pin(pins[i], next_random() & 1);
+        }
+    }
+};
+
+TEST_F(MatrixPort, ConsecutivePadsShareAGroup) {
+    const pin_t         pins[] = {PIN(1, 2), PIN(1, 3), PIN(1, 4), PIN(1, 5)};
+    matrix_port_group_t groups[4];
+    ASSERT_EQ(matrix_port_groups_init(groups, 4, pins, 4), 1);
+    EXPECT_EQ(groups[0].mask, 0x3C);
+    EXPECT_EQ(groups[0].shift, 2);
+
+    gpio_mock_set_pin(PIN(1, 3), false);
+    gpio_mock_port_reads = 0;
+    EXPECT_EQ(matrix_port_read(groups, 1), 0b1101u);
+    EXPECT_EQ(gpio_mock_port_reads, 1);
+}
+
+TEST_F(MatrixPort, EachPortIsReadOnce) {
+    // Reversed and interleaved pads need several groups, but not several reads
+    const pin_t         pins[] = {PIN(0, 7), PIN(2, 0), PIN(0, 6), PIN(2, 1), PIN(0, 5), PIN(2, 9), PIN(0, 4)};
+    matrix_port_group_t groups[8];
+    uint8_t             count = matrix_port_groups_init(groups, 8, pins, 7);
+    ASSERT_EQ(count, 7);
+
+    for (int i = 0; i < 100; i++) {
+        randomize(pins, 7);
+        gpio_mock_port_reads = 0;
+        ASSERT_EQ(matrix_port_read(groups, count), read_pins(pins, 7));
+        ASSERT_EQ(gpio_mock_port_reads, 2);
+    }
+}
+
+TEST_F(MatrixPort, SixByTwentyOneBoard) {
+    // Columns split over three ports the way a typical PCB routes them
+    const pin_t pins[21] = {
+        PIN(1, 0),  PIN(1, 1),  PIN(1, 2),  PIN(1, 3),  PIN(1, 4),  PIN(1, 5),  PIN(1, 6), //
+        PIN(2, 15), PIN(2, 14), PIN(2, 13), PIN(2, 12), PIN(3, 0),  PIN(3, 1),  PIN(3, 2), //
+        PIN(3, 3),  PIN(3, 4),  PIN(3, 5),  PIN(3, 6),  PIN(1, 8),  PIN(1, 9),  PIN(1, 10),
+    };
+    matrix_port_group_t groups[21];
+    uint8_t             count = matrix_port_groups_init(groups, 21, pins, 21);
+    EXPECT_EQ(count, 7);
+
+    for (int i = 0; i < 100; i++) {
+        randomize(pins, 21);
+        gpio_mock_pin_reads  = 0;
+        gpio_mock_port_reads = 0;
+        ASSERT_EQ(matrix_port_read(groups, count), read_pins(pins, 21));
+        ASSERT_EQ(gpio_mock_port_reads, 3);
+    }
+}
+
+TEST_F(MatrixPort, NoPinReadsZero) {
+    const pin_t         pins[] = {PIN(4, 0), NO_PIN, PIN(4, 2)};
+    matrix_port_group_t groups[3];
+    uint8_t             count = matrix_port_groups_init(groups, 3, pins, 3);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(matrix_port_read(groups, count), 0b101u);
+}
+
+TEST_F(MatrixPort, TooManyGroupsFails) {
+    const pin_t         pins[] = {PIN(0, 0), PIN(1, 0), PIN(2, 0)};
+    matrix_port_group_t groups[2];
+    EXPECT_EQ(matrix_port_groups_init(groups, 2, pins, 3), 0);
+}
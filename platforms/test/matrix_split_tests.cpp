@@ -0,0 +1,92 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "gpio.h"
+#include "matrix.h"
+#include "suspend.h"
+
+// Split transport mocks, this half is the master on the left
+volatile bool isLeftHand = true;
+
+static matrix_row_t slave_keys[MATRIX_ROWS / 2];
+static bool         slave_connected;
+static int          transport_exchanges;
+
+bool is_keyboard_master(void) {
+    return true;
+}
+
+bool transport_master_if_connected(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    transport_exchanges++;
+    if (slave_connected) {
+        memcpy(slave_matrix, slave_keys, sizeof(slave_keys));
+    }
+    return slave_connected;
+}
+
+void transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {}
+void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {}
+
+void matrix_init_quantum(void) {}
+void matrix_scan_quantum(void) {}
+}
+
+// The direct pins of the left half, see rules.mk
+#define KEY_PIN GPIO_MOCK_PIN(1, 3)
+
+class MatrixSplit : public testing::Test {
+   protected:
+    void SetUp() override {
+        gpio_mock_reset();
+        memset(slave_keys, 0, sizeof(slave_keys));
+        slave_connected     = true;
+        transport_exchanges = 0;
+        matrix_init();
+    }
+};
+
+TEST_F(MatrixSplit, NothingDownDoesNotWake) {
+    EXPECT_FALSE(suspend_wakeup_condition());
+    EXPECT_FALSE(matrix_wake_check());
+}
+
+TEST_F(MatrixSplit, LocalKeyWakesWithoutTransport) {
+    gpio_mock_set_pin(KEY_PIN, false);
+    EXPECT_TRUE(suspend_wakeup_condition());
+    EXPECT_EQ(transport_exchanges, 0);
+}
+
+TEST_F(MatrixSplit, SlaveKeyWakesHost) {
+    slave_keys[1] = 0b10;
+    EXPECT_TRUE(suspend_wakeup_condition());
+    EXPECT_EQ(transport_exchanges, 1);
+    EXPECT_EQ(matrix_get_row(MATRIX_ROWS / 2 + 1), 0b10);
+
+    slave_keys[1] = 0;
+    EXPECT_FALSE(suspend_wakeup_condition());
+}
+
+TEST_F(MatrixSplit, DisconnectedSlaveDoesNotWake) {
+    slave_keys[0]   = 0b01;
+    slave_connected = false;
+    EXPECT_FALSE(suspend_wakeup_condition());
+    EXPECT_EQ(transport_exchanges, 1);
+}
@@ -22,3 +22,46 @@ eeprom_stm32_SRC := \
 	$(PLATFORM_PATH)/chibios/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+
+i2c_queue_DEFS := -DIGNORE_ATOMIC_BLOCK -DI2C_QUEUE_SIZE=4
+
+i2c_queue_INC := \
+	$(PLATFORM_PATH)/chibios/drivers
+
+i2c_queue_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_queue_tests.cpp \
+	$(PLATFORM_PATH)/chibios/drivers/i2c_queue.c
+
+spi_queue_DEFS := -DIGNORE_ATOMIC_BLOCK -DSPI_QUEUE_SIZE=6 -DSPI_QUEUE_BATCH_LIMIT=2
+
+spi_queue_INC := \
+	$(PLATFORM_PATH)/chibios/drivers
+
+spi_queue_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/spi_queue_tests.cpp \
+	$(PLATFORM_PATH)/chibios/drivers/spi_queue.c
+
+matrix_port_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/matrix_port_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/gpio_mock.c \
+	$(QUANTUM_PATH)/matrix_port.c
+
+matrix_split_DEFS := -DIGNORE_ATOMIC_BLOCK -DSPLIT_KEYBOARD -DMATRIX_ROWS=4 -DMATRIX_COLS=2 \
+	"-DDIRECT_PINS={{0x10,0x11},{0x12,0x13}}"
+
+matrix_split_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/matrix_split_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/gpio_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/suspend.c \
+	$(QUANTUM_PATH)/matrix.c \
+	$(QUANTUM_PATH)/matrix_common.c \
+	$(QUANTUM_PATH)/bitwise.c \
+	$(QUANTUM_PATH)/debounce/none.c
+
+usb_report_queue_INC := \
+	$(TMK_PATH)/protocol/chibios
+
+usb_report_queue_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/usb_report_queue_tests.cpp \
+	$(TMK_PATH)/protocol/chibios/usb_report_queue.c
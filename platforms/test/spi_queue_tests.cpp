@@ -0,0 +1,191 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "spi_queue.h"
+}
+
+/* Simulated bus: every byte clocked out is logged, and received bytes are
+ * the running byte count on the bus. Delays are accumulated separately.
+ */
+struct BusTransaction {
+    const spi_device_t * device;
+    std::vector<uint8_t> mosi;
+    uint32_t             delay_us;
+};
+
+static std::vector<BusTransaction> bus_log;
+static uint8_t                     miso_counter;
+
+static bool bus_step(void) {
+    const spi_transaction_t *transaction = spi_queue_begin();
+    if (transaction == NULL) {
+        return false;
+    }
+    BusTransaction record = {transaction->device, {}, 0};
+    for (uint8_t i = 0; i < transaction->segment_count; i++) {
+        const spi_segment_t *segment = &transaction->segments[i];
+        for (uint16_t j = 0; j < segment->length; j++) {
+            record.mosi.push_back(segment->tx_data ? segment->tx_data[j] : 0);
+            if (segment->rx_data) {
+                segment->rx_data[j] = miso_counter;
+            }
+            miso_counter++;
+        }
+        record.delay_us += segment->delay_us;
+    }
+    bus_log.push_back(record);
+    spi_queue_end(transaction->device->slave_pin != NO_PIN);
+    return true;
+}
+
+static void bus_run(void) {
+    while (bus_step()) {
+    }
+}
+
+static std::vector<int> completed;
+static std::vector<int> failed;
+
+static void record_callback(bool success, void *context) {
+    (success ? completed : failed).push_back((int)(intptr_t)context);
+}
+
+static const spi_device_t sensor  = {1, false, 3, 16};
+static const spi_device_t flash   = {2, false, 0, 2};
+static const spi_device_t unbound = {NO_PIN, false, 0, 2};
+
+static const uint8_t       write_enable[]         = {0x06};
+static const spi_segment_t write_enable_segment[] = {{write_enable, NULL, sizeof(write_enable), 0}};
+static const uint8_t       motion_burst[]         = {0x50};
+static uint8_t             burst_data[12];
+static const spi_segment_t burst_segments[] = {{motion_burst, NULL, sizeof(motion_burst), 35}, {NULL, burst_data, sizeof(burst_data), 0}};
+
+static spi_transaction_t make_transaction(const spi_device_t *device, const spi_segment_t *segments, uint8_t count, int id) {
+    spi_transaction_t transaction = {};
+    transaction.device            = device;
+    transaction.segments          = segments;
+    transaction.segment_count     = count;
+    transaction.callback          = record_callback;
+    transaction.context           = (void *)(intptr_t)id;
+    return transaction;
+}
+
+class SPIQueue : public testing::Test {
+   protected:
+    void SetUp() override {
+        bus_log.clear();
+        completed.clear();
+        failed.clear();
+        miso_counter = 0;
+    }
+    void TearDown() override {
+        bus_run();
+        spi_queue_task();
+        EXPECT_TRUE(spi_queue_is_idle());
+    }
+};
+
+TEST_F(SPIQueue, SegmentsRunInOneTransaction) {
+    spi_transaction_t burst = make_transaction(&sensor, burst_segments, 2, 1);
+    ASSERT_TRUE(spi_queue_submit(&burst));
+    bus_run();
+
+    ASSERT_EQ(bus_log.size(), 1u);
+    EXPECT_EQ(bus_log[0].device, &sensor);
+    ASSERT_EQ(bus_log[0].mosi.size(), 1u + sizeof(burst_data));
+    EXPECT_EQ(bus_log[0].mosi[0], 0x50);
+    EXPECT_EQ(bus_log[0].mosi[1], 0x00);
+    EXPECT_EQ(bus_log[0].delay_us, 35u);
+    for (uint8_t i = 0; i < sizeof(burst_data); i++) {
+        EXPECT_EQ(burst_data[i], i + 1);
+    }
+}
+
+TEST_F(SPIQueue, CallbacksRunFromTask) {
+    spi_transaction_t good = make_transaction(&flash, write_enable_segment, 1, 1);
+    spi_transaction_t bad  = make_transaction(&unbound, write_enable_segment, 1, 2);
+    ASSERT_TRUE(spi_queue_submit(&good));
+    ASSERT_TRUE(spi_queue_submit(&bad));
+    bus_run();
+    EXPECT_TRUE(completed.empty());
+    EXPECT_FALSE(spi_queue_is_idle());
+
+    spi_queue_task();
+    EXPECT_EQ(completed, std::vector<int>({1}));
+    EXPECT_EQ(failed, std::vector<int>({2}));
+    EXPECT_TRUE(spi_queue_is_idle());
+}
+
+TEST_F(SPIQueue, SameDeviceTransactionsAreBatched) {
+    spi_transaction_t a1 = make_transaction(&sensor, burst_segments, 2, 1);
+    spi_transaction_t b1 = make_transaction(&flash, write_enable_segment, 1, 2);
+    spi_transaction_t a2 = make_transaction(&sensor, burst_segments, 2, 3);
+    spi_transaction_t a3 = make_transaction(&sensor, burst_segments, 2, 4);
+    spi_transaction_t b2 = make_transaction(&flash, write_enable_segment, 1, 5);
+    // Finish with the flash, so batching starts from a clean slate
+    spi_transaction_t warmup = make_transaction(&flash, write_enable_segment, 1, 0);
+    ASSERT_TRUE(spi_queue_submit(&warmup));
+    bus_run();
+
+    ASSERT_TRUE(spi_queue_submit(&a1));
+    ASSERT_TRUE(spi_queue_submit(&b1));
+    ASSERT_TRUE(spi_queue_submit(&a2));
+    ASSERT_TRUE(spi_queue_submit(&a3));
+    ASSERT_TRUE(spi_queue_submit(&b2));
+    EXPECT_TRUE(spi_queue_has_pending(&sensor));
+    EXPECT_TRUE(spi_queue_has_pending(&flash));
+
+    bus_run();
+    spi_queue_task();
+    // The pending flash transaction is pulled ahead of the older sensor one,
+    // then the batch limit of two hands the bus back to the oldest transaction.
+    EXPECT_EQ(completed, std::vector<int>({0, 2, 1, 3, 4, 5}));
+    EXPECT_FALSE(spi_queue_has_pending(&sensor));
+}
+
+TEST_F(SPIQueue, FullQueueRejectsUntilTaskReleasesSlots) {
+    spi_transaction_t transaction = make_transaction(&flash, write_enable_segment, 1, 0);
+    for (int i = 0; i < SPI_QUEUE_SIZE; i++) {
+        ASSERT_TRUE(spi_queue_submit(&transaction));
+    }
+    EXPECT_FALSE(spi_queue_submit(&transaction));
+
+    bus_run();
+    EXPECT_FALSE(spi_queue_submit(&transaction));
+    spi_queue_task();
+    EXPECT_EQ(completed.size(), (size_t)SPI_QUEUE_SIZE);
+    EXPECT_TRUE(spi_queue_submit(&transaction));
+}
+
+TEST_F(SPIQueue, InFlightTransactionBlocksNext) {
+    spi_transaction_t first  = make_transaction(&sensor, burst_segments, 2, 1);
+    spi_transaction_t second = make_transaction(&flash, write_enable_segment, 1, 2);
+    ASSERT_TRUE(spi_queue_submit(&first));
+    ASSERT_TRUE(spi_queue_submit(&second));
+
+    ASSERT_NE(spi_queue_begin(), nullptr);
+    EXPECT_EQ(spi_queue_begin(), nullptr);
+    spi_queue_end(true);
+
+    bus_run();
+    ASSERT_EQ(bus_log.size(), 1u);
+    EXPECT_EQ(bus_log[0].device, &flash);
+}
@@ -0,0 +1,170 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "usb_report_queue.h"
+}
+
+/* Keyboard like report: modifiers followed by two key slots */
+typedef std::vector<uint8_t> Report;
+
+static const uint8_t KEYBOARD = 0;
+static const uint8_t CONSUMER = 3;
+static const uint8_t MOUSE    = 2;
+
+class UsbReportQueue : public ::testing::Test {
+   protected:
+    usb_report_queue_t queue;
+
+    void SetUp() override {
+        usb_report_queue_init(&queue);
+    }
+
+    bool push(uint8_t kind, const Report &report, bool merge = true) {
+        return usb_report_queue_push(&queue, kind, report.data(), report.size(), merge);
+    }
+
+    /* What the host receives, one report per frame */
+    std::vector<Report> drain(void) {
+        std::vector<Report> sent;
+        const usb_report_t *report;
+        while ((report = usb_report_queue_pop(&queue)) != NULL) {
+            sent.push_back(Report(report->data, report->data + report->size));
+        }
+        return sent;
+    }
+};
+
+TEST_F(UsbReportQueue, EmptyQueuePopsNothing) {
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+    EXPECT_EQ(usb_report_queue_pop(&queue), nullptr);
+}
+
+TEST_F(UsbReportQueue, ReportsAreSentInOrder) {
+    EXPECT_TRUE(push(KEYBOARD, {0, 4, 0}));
+    EXPECT_TRUE(push(CONSUMER, {0xE9, 0}));
+    EXPECT_FALSE(usb_report_queue_is_empty(&queue));
+
+    std::vector<Report> expected = {{0, 4, 0}, {0xE9, 0}};
+    EXPECT_EQ(drain(), expected);
+    EXPECT_TRUE(usb_report_queue_is_empty(&queue));
+}
+
+TEST_F(UsbReportQueue, PressesInOneFrameAreMerged) {
+    push(KEYBOARD, {0, 0, 0});
+    drain();
+
+    push(KEYBOARD, {0x02, 0, 0});
+    push(KEYBOARD, {0x02, 4, 0});
+    push(KEYBOARD, {0x02, 4, 5});
+
+    std::vector<Report> expected = {{0x02, 4, 5}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, PressAndReleaseInOneFrameArePreserved) {
+    push(KEYBOARD, {0, 0, 0});
+    drain();
+
+    push(KEYBOARD, {0, 4, 0});
+    push(KEYBOARD, {0, 0, 0});
+    push(KEYBOARD, {0, 5, 0});
+    push(KEYBOARD, {0, 0, 0});
+
+    std::vector<Report> expected = {{0, 4, 0}, {0, 0, 0}, {0, 5, 0}, {0, 0, 0}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, KeyReplacedInASlotIsPreserved) {
+    push(KEYBOARD, {0, 0, 0});
+    drain();
+
+    /* The slot changes twice, the press of 0x04 must reach the host */
+    push(KEYBOARD, {0, 0x04, 0});
+    push(KEYBOARD, {0, 0x05, 0});
+
+    std::vector<Report> expected = {{0, 0x04, 0}, {0, 0x05, 0}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, MergeComparesWithTheSentReport) {
+    push(KEYBOARD, {0, 4, 0});
+    drain();
+
+    /* Release of 4 and press of 5 touch different slots */
+    push(KEYBOARD, {0, 0, 0});
+    push(KEYBOARD, {0, 0, 5});
+    push(KEYBOARD, {0, 4, 5});
+
+    std::vector<Report> expected = {{0, 0, 5}, {0, 4, 5}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, OtherKindsAreNotMerged) {
+    push(KEYBOARD, {0, 0, 0});
+    drain();
+
+    push(KEYBOARD, {0, 4, 0});
+    push(CONSUMER, {0xE9, 0});
+    push(KEYBOARD, {0, 4, 5});
+
+    std::vector<Report> expected = {{0, 4, 0}, {0xE9, 0}, {0, 4, 5}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, UnmergeableReportsAreKept) {
+    push(MOUSE, {0, 1, 0}, false);
+    drain();
+
+    push(MOUSE, {0, 1, 0}, false);
+    push(MOUSE, {0, 1, 0}, false);
+
+    std::vector<Report> expected = {{0, 1, 0}, {0, 1, 0}};
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(UsbReportQueue, FullQueueKeepsTheLatestState) {
+    for (uint8_t i = 0; i < USB_REPORT_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(push(KEYBOARD, {0, (uint8_t)(i % 2 ? 0 : 4), 0}));
+    }
+    EXPECT_TRUE(push(KEYBOARD, {0x02, 0, 0}));
+
+    std::vector<Report> sent = drain();
+    ASSERT_EQ(sent.size(), (size_t)USB_REPORT_QUEUE_SIZE);
+    EXPECT_EQ(sent.back(), Report({0x02, 0, 0}));
+}
+
+TEST_F(UsbReportQueue, FullQueueDropsOtherKinds) {
+    for (uint8_t i = 0; i < USB_REPORT_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(push(KEYBOARD, {0, (uint8_t)(i % 2 ? 0 : 4), 0}));
+    }
+    EXPECT_FALSE(push(CONSUMER, {0xE9, 0}));
+    EXPECT_FALSE(push(MOUSE, {0, 1, 0}, false));
+    EXPECT_EQ(drain().size(), (size_t)USB_REPORT_QUEUE_SIZE);
+}
+
+TEST_F(UsbReportQueue, PoppedReportStaysValidUntilTheNextPop) {
+    push(KEYBOARD, {0, 4, 0});
+    const usb_report_t *report = usb_report_queue_pop(&queue);
+    ASSERT_NE(report, nullptr);
+
+    push(KEYBOARD, {0, 0, 0});
+    EXPECT_EQ(Report(report->data, report->data + report->size), Report({0, 4, 0}));
+}
@@ -1,9 +1,11 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "timer.h"
 
 #ifdef DEBUG_ACTION
@@ -30,10 +32,16 @@ __attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *r
     return g_tapping_term;
 }
 
+#    ifdef KEYEVENT_TIME_US
+#        define WITHIN_TERM(e, term) (TIMER_DIFF_32((e).time_us, tapping_key.event.time_us) < (uint32_t)(term)*1000)
+#    else
+#        define WITHIN_TERM(e, term) (TIMER_DIFF_16((e).time, tapping_key.event.time) < (term))
+#    endif
+
 #    ifdef TAPPING_TERM_PER_KEY
-#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_term(get_record_keycode(&tapping_key, false), &tapping_key))
+#        define WITHIN_TAPPING_TERM(e) WITHIN_TERM(e, get_tapping_term(get_record_keycode(&tapping_key, false), &tapping_key))
 #    else
-#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < g_tapping_term)
+#        define WITHIN_TAPPING_TERM(e) WITHIN_TERM(e, g_tapping_term)
 #    endif
 
 #    ifdef TAPPING_FORCE_HOLD_PER_KEY
@@ -58,13 +66,39 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 #        include "process_auto_shift.h"
 #    endif
 
+#    ifdef TAPPING_PREDICT_ENABLE
+#        include "tapping_predict.h"
+#        define WITHIN_PREDICTED_TERM(e) (tapping_key.tap.count > 0 || WITHIN_TERM(e, tapping_predict_term(&tapping_key)))
+#        define TAPPING_DECIDED(e, predicted) tapping_predict_decided(&tapping_key, (e).time, (predicted))
+#    else
+#        define WITHIN_PREDICTED_TERM(e) true
+#        define TAPPING_DECIDED(e, predicted)
+#    endif
+
+_Static_assert(WAITING_BUFFER_SIZE > 0 && WAITING_BUFFER_SIZE <= 128 && (WAITING_BUFFER_SIZE & (WAITING_BUFFER_SIZE - 1)) == 0, "WAITING_BUFFER_SIZE must be a power of two, up to 128");
+
+#    define WAITING_BUFFER_INDEX(i) ((uint8_t)(i) & (WAITING_BUFFER_SIZE - 1))
+#    define WAITING_BUFFER_COUNT() ((uint8_t)(waiting_buffer_head - waiting_buffer_tail))
+#    define IS_MATRIX_KEY(k) ((k).row < MATRIX_ROWS && (k).col < MATRIX_COLS)
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+// Free running, only masked when indexing, so all slots are usable
+static uint8_t waiting_buffer_head = 0;
+static uint8_t waiting_buffer_tail = 0;
+
+// Keys with a press or a release in the waiting buffer. Buffered events of
+// keys outside the matrix, and repeated events of a key, are counted so the
+// lookups only need to fall back to scanning the buffer while there are any.
+static matrix_row_t waiting_buffer_pressed[MATRIX_ROWS]  = {};
+static matrix_row_t waiting_buffer_released[MATRIX_ROWS] = {};
+static uint8_t      waiting_buffer_presses               = 0;
+static uint8_t      waiting_buffer_repeats               = 0;
+static uint8_t      waiting_buffer_others                = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -77,6 +111,9 @@ static void debug_waiting_buffer(void);
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
+#    ifdef TAPPING_PREDICT_ENABLE
+    tapping_predict_event(&record);
+#    endif
     if (process_tapping(&record)) {
         if (!IS_NOEVENT(record.event)) {
             debug("processed: ");
@@ -97,13 +134,15 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        keyrecord_t *waiting = &waiting_buffer[WAITING_BUFFER_INDEX(waiting_buffer_tail)];
+        if (process_tapping(waiting)) {
             debug("processed: waiting_buffer[");
-            debug_dec(waiting_buffer_tail);
+            debug_dec(WAITING_BUFFER_INDEX(waiting_buffer_tail));
             debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]);
+            debug_record(*waiting);
             debug("\n\n");
+            waiting_buffer_deq();
         } else {
             break;
         }
@@ -128,13 +167,13 @@ bool process_tapping(keyrecord_t *keyp) {
     // if tapping
     if (IS_TAPPING_PRESSED()) {
         // clang-format off
-        if (WITHIN_TAPPING_TERM(event)
+        if ((WITHIN_TAPPING_TERM(event) && WITHIN_PREDICTED_TERM(event))
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
             || (
 #        ifdef RETRO_TAPPING_PER_KEY
                 get_retro_tapping(tapping_keycode, &tapping_key) &&
 #        endif
-                (RETRO_SHIFT + 0) != 0 && TIMER_DIFF_16(event.time, tapping_key.event.time) < (RETRO_SHIFT + 0)
+                (RETRO_SHIFT + 0) != 0 && WITHIN_TERM(event, RETRO_SHIFT + 0)
             )
 #    endif
         ) {
@@ -146,6 +185,7 @@ bool process_tapping(keyrecord_t *keyp) {
 #    endif
                     // first tap!
                     debug("Tapping: First tap(0->1).\n");
+                    TAPPING_DECIDED(event, false);
                     tapping_key.tap.count = 1;
                     debug_tapping_key();
                     process_record(&tapping_key);
@@ -224,6 +264,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 ) {
                     // clang-format on
                     debug("Tapping: End. No tap. Interfered by typing key\n");
+                    TAPPING_DECIDED(event, false);
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
                     debug_tapping_key();
@@ -258,12 +299,37 @@ bool process_tapping(keyrecord_t *keyp) {
                     // set interrupted flag when other key preesed during tapping
                     if (event.pressed) {
                         tapping_key.tap.interrupted = true;
+#    ifdef TAPPING_PREDICT_ENABLE
+                        switch (tapping_predict_interrupt(&tapping_key)) {
+                            case TAPPING_PREDICT_TAP:
+                                // Tap now, the key stays registered until its release
+                                debug("Tapping: Predicted tap. Interfered by pressed key\n");
+                                TAPPING_DECIDED(event, true);
+                                tapping_key.tap.count = 1;
+                                process_record(&tapping_key);
+                                tapping_predict_tapped(&tapping_key);
+                                debug_tapping_key();
+                                // enqueue
+                                return false;
+                            case TAPPING_PREDICT_HOLD:
+                                debug("Tapping: End. Predicted hold. Interfered by pressed key\n");
+                                TAPPING_DECIDED(event, true);
+                                process_record(&tapping_key);
+                                tapping_key = (keyrecord_t){};
+                                debug_tapping_key();
+                                // enqueue
+                                return false;
+                            default:
+                                break;
+                        }
+#    endif
 #    if defined(HOLD_ON_OTHER_KEY_PRESS) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
 #        if defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
                         if (get_hold_on_other_key_press(tapping_keycode, &tapping_key))
 #        endif
                         {
                             debug("Tapping: End. No tap. Interfered by pressed key\n");
+                            TAPPING_DECIDED(event, false);
                             process_record(&tapping_key);
                             tapping_key = (keyrecord_t){};
                             debug_tapping_key();
@@ -322,6 +388,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 debug("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event);
                 debug("\n");
+                TAPPING_DECIDED(event, WITHIN_TAPPING_TERM(event));
                 process_record(&tapping_key);
                 tapping_key = (keyrecord_t){};
                 debug_tapping_key();
@@ -370,7 +437,7 @@ bool process_tapping(keyrecord_t *keyp) {
 #        ifdef RETRO_TAPPING_PER_KEY
                 get_retro_tapping(tapping_keycode, &tapping_key) &&
 #        endif
-                (RETRO_SHIFT + 0) != 0 && TIMER_DIFF_16(event.time, tapping_key.event.time) < (RETRO_SHIFT + 0)
+                (RETRO_SHIFT + 0) != 0 && WITHIN_TERM(event, RETRO_SHIFT + 0)
             )
 #    endif
         ) {
@@ -445,44 +512,105 @@ bool process_tapping(keyrecord_t *keyp) {
     }
 }
 
+static matrix_row_t *waiting_buffer_keys(keyevent_t event) {
+    return event.pressed ? waiting_buffer_pressed : waiting_buffer_released;
+}
+
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Appends an event to the waiting buffer, returns false if it is full.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_COUNT() == WAITING_BUFFER_SIZE) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
-    waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer[WAITING_BUFFER_INDEX(waiting_buffer_head)] = record;
+    waiting_buffer_head++;
+
+    keypos_t key = record.event.key;
+    if (record.event.pressed) {
+        waiting_buffer_presses++;
+    }
+    if (IS_MATRIX_KEY(key)) {
+        matrix_row_t *keys = waiting_buffer_keys(record.event);
+        if (keys[key.row] & ((matrix_row_t)1 << key.col)) {
+            waiting_buffer_repeats++;
+        }
+        keys[key.row] |= (matrix_row_t)1 << key.col;
+    } else {
+        waiting_buffer_others++;
+    }
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Drops the oldest event from the waiting buffer.
+ */
+void waiting_buffer_deq(void) {
+    keyevent_t event = waiting_buffer[WAITING_BUFFER_INDEX(waiting_buffer_tail)].event;
+    waiting_buffer_tail++;
+
+    if (event.pressed) {
+        waiting_buffer_presses--;
+    }
+    if (!IS_MATRIX_KEY(event.key)) {
+        waiting_buffer_others--;
+        return;
+    }
+
+    // Without repeated events the key cannot have another one buffered
+    if (waiting_buffer_repeats) {
+        for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
+            keyevent_t *other = &waiting_buffer[WAITING_BUFFER_INDEX(i)].event;
+            if (KEYEQ(event.key, other->key) && event.pressed == other->pressed) {
+                waiting_buffer_repeats--;
+                return;
+            }
+        }
+    }
+    waiting_buffer_keys(event)[event.key.row] &= ~((matrix_row_t)1 << event.key.col);
+}
+
 /** \brief Waiting buffer clear
  *
- * FIXME: Needs docs
+ * Drops all events from the waiting buffer.
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head    = 0;
+    waiting_buffer_tail    = 0;
+    waiting_buffer_presses = 0;
+    waiting_buffer_repeats = 0;
+    waiting_buffer_others  = 0;
+    memset(waiting_buffer_pressed, 0, sizeof(waiting_buffer_pressed));
+    memset(waiting_buffer_released, 0, sizeof(waiting_buffer_released));
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Checks whether the waiting buffer holds the opposite event of the same key,
+ * e.g. the press of a key that is now released.
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
+    if (IS_MATRIX_KEY(event.key)) {
+        matrix_row_t *keys = event.pressed ? waiting_buffer_released : waiting_buffer_pressed;
+        return keys[event.key.row] & ((matrix_row_t)1 << event.key.col);
+    }
+    if (!waiting_buffer_others) {
+        return false;
+    }
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
+        keyevent_t *other = &waiting_buffer[WAITING_BUFFER_INDEX(i)].event;
+        if (KEYEQ(event.key, other->key) && event.pressed != other->pressed) {
             return true;
         }
     }
@@ -491,33 +619,34 @@ bool waiting_buffer_typed(keyevent_t event) {
 
 /** \brief Waiting buffer has anykey pressed
  *
- * FIXME: Needs docs
+ * Checks whether the waiting buffer holds any key press.
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_presses;
 }
 
 /** \brief Scan buffer for tapping
  *
- * FIXME: Needs docs
+ * Settles the tapping key as a tap if its release is in the waiting buffer,
+ * within the tapping term.
  */
 void waiting_buffer_scan_tap(void) {
     // tapping already is settled
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // the release has not been buffered yet
+    if (IS_MATRIX_KEY(tapping_key.event.key) && !(waiting_buffer_released[tapping_key.event.key.row] & ((matrix_row_t)1 << tapping_key.event.key.col))) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
-            tapping_key.tap.count       = 1;
-            waiting_buffer[i].tap.count = 1;
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
+        keyrecord_t *waiting = &waiting_buffer[WAITING_BUFFER_INDEX(i)];
+        if (IS_TAPPING_KEY(waiting->event.key) && !waiting->event.pressed && WITHIN_TAPPING_TERM(waiting->event)) {
+            tapping_key.tap.count = 1;
+            waiting->tap.count    = 1;
             process_record(&tapping_key);
 
             debug("waiting_buffer_scan_tap: found at [");
-            debug_dec(i);
+            debug_dec(WAITING_BUFFER_INDEX(i));
             debug("]\n");
             debug_waiting_buffer();
             return;
@@ -541,11 +670,11 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
         debug("[");
-        debug_dec(i);
+        debug_dec(WAITING_BUFFER_INDEX(i));
         debug("]=");
-        debug_record(waiting_buffer[i]);
+        debug_record(waiting_buffer[WAITING_BUFFER_INDEX(i)]);
         debug(" ");
     }
     debug("}\n");
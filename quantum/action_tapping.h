@@ -27,7 +27,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* events buffered while a tap-hold key is undecided, must be a power of two */
+#ifndef WAITING_BUFFER_SIZE
+#    ifdef __AVR__
+#        define WAITING_BUFFER_SIZE 16
+#    else
+#        define WAITING_BUFFER_SIZE 32
+#    endif
+#endif
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
@@ -41,6 +48,6 @@ bool     get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record);
 bool     get_tapping_force_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_retro_tapping(uint16_t keycode, keyrecord_t *record);
 
-#ifdef DYNAMIC_TAPPING_TERM_ENABLE
+#if defined(DYNAMIC_TAPPING_TERM_ENABLE) || defined(TAPPING_PREDICT_ENABLE)
 extern uint16_t g_tapping_term;
 #endif
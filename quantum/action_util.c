@@ -36,9 +36,20 @@ static uint8_t suppressed_mods    = 0;
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
-extern inline void add_key(uint8_t key);
-extern inline void del_key(uint8_t key);
-extern inline void clear_keys(void);
+// Whether keys were added to or removed from keyboard_report since it was last sent
+static bool keys_dirty = false;
+
+void add_key(uint8_t key) {
+    keys_dirty |= add_key_to_report(keyboard_report, key);
+}
+
+void del_key(uint8_t key) {
+    keys_dirty |= del_key_from_report(keyboard_report, key);
+}
+
+void clear_keys(void) {
+    keys_dirty |= clear_keys_from_report(keyboard_report);
+}
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -275,8 +286,14 @@ void send_keyboard_report(void) {
 #else
     static report_keyboard_t last_report;
 
-    /* Only send the report if there are changes to propagate to the host. */
-    if (memcmp(keyboard_report, &last_report, sizeof(report_keyboard_t)) != 0) {
+    /* Only send the report if there are changes to propagate to the host.
+     * The keys are only compared if they were touched since the last report. */
+    bool changed = keyboard_report->mods != last_report.mods;
+    if (keys_dirty) {
+        keys_dirty = false;
+        changed    = changed || memcmp(keyboard_report, &last_report, sizeof(report_keyboard_t)) != 0;
+    }
+    if (changed) {
         memcpy(&last_report, keyboard_report, sizeof(report_keyboard_t));
         host_keyboard_send(keyboard_report);
     }
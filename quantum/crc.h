@@ -41,4 +41,15 @@ __attribute__((weak)) void crc_init(void);
  * \param[in] data_len Number of bytes in the \a data buffer.
  * \return             The calculated crc value.
  */
-__attribute__((weak)) uint8_t crc8(const void *data, size_t data_len);
\ No newline at end of file
+__attribute__((weak)) uint8_t crc8(const void *data, size_t data_len);
+
+/**
+ * Continue a CRC8 calculation over further data, so that data which is not
+ * contiguous in memory can be checksummed. crc8() is crc8_update(0xff, ...).
+ *
+ * \param[in] previous The CRC8 value of the preceding data.
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The calculated crc value.
+ */
+__attribute__((weak)) uint8_t crc8_update(uint8_t previous, const void *data, size_t data_len);
\ No newline at end of file
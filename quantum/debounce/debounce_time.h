@@ -0,0 +1,72 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Time base of the debounce algorithms.
+ * DEBOUNCE and the counters of the algorithms are in milliseconds, unless
+ * DEBOUNCE_US is defined. Then they count ticks of DEBOUNCE_TICK_US
+ * microseconds, and DEBOUNCE is derived from DEBOUNCE_US.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "timer.h"
+
+#ifdef DEBOUNCE_US
+#    ifndef DEBOUNCE_TICK_US
+#        define DEBOUNCE_TICK_US 100
+#    endif
+#    undef DEBOUNCE
+#    define DEBOUNCE (((DEBOUNCE_US) + DEBOUNCE_TICK_US - 1) / DEBOUNCE_TICK_US)
+// The algorithms count in bytes and would silently cut it short
+#    if DEBOUNCE > UINT8_MAX
+#        error DEBOUNCE_US is more than 255 ticks of DEBOUNCE_TICK_US, raise DEBOUNCE_TICK_US
+#    endif
+
+typedef uint32_t debounce_time_t;
+
+static inline debounce_time_t debounce_time_read(void) {
+    return timer_read_us();
+}
+
+/* Ticks since the given time */
+static inline uint32_t debounce_time_since(debounce_time_t last) {
+    return timer_elapsed_us(last) / DEBOUNCE_TICK_US;
+}
+
+/* Ticks since the given time, which is advanced by as many whole ticks */
+static inline uint32_t debounce_time_update(debounce_time_t *last) {
+    uint32_t ticks = debounce_time_since(*last);
+    *last += ticks * DEBOUNCE_TICK_US;
+    return ticks;
+}
+#else
+typedef fast_timer_t debounce_time_t;
+
+static inline debounce_time_t debounce_time_read(void) {
+    return timer_read_fast();
+}
+
+static inline fast_timer_t debounce_time_since(debounce_time_t last) {
+    return timer_elapsed_fast(last);
+}
+
+static inline fast_timer_t debounce_time_update(debounce_time_t *last) {
+    fast_timer_t now     = timer_read_fast();
+    fast_timer_t elapsed = TIMER_DIFF_FAST(now, *last);
+    *last                = now;
+    return elapsed;
+}
+#endif
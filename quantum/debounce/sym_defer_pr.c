@@ -20,13 +20,14 @@ DEBOUNCE milliseconds have elapsed since the last change.
 #include "matrix.h"
 #include "timer.h"
 #include "quantum.h"
+#include "debounce_time.h"
 #include <stdlib.h>
 
 #ifndef DEBOUNCE
 #    define DEBOUNCE 5
 #endif
 
-static uint16_t last_time;
+static debounce_time_t last_time;
 // [row] milliseconds until key's state is considered debounced.
 static uint8_t* countdowns;
 // [row]
@@ -36,7 +37,7 @@ void debounce_init(uint8_t num_rows) {
     countdowns = (uint8_t*)calloc(num_rows, sizeof(uint8_t));
     last_raw   = (matrix_row_t*)calloc(num_rows, sizeof(matrix_row_t));
 
-    last_time = timer_read();
+    last_time = debounce_time_read();
 }
 
 void debounce_free(void) {
@@ -47,10 +48,8 @@ void debounce_free(void) {
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
-    uint16_t now       = timer_read();
-    uint16_t elapsed16 = TIMER_DIFF_16(now, last_time);
-    last_time          = now;
-    uint8_t elapsed    = (elapsed16 > 255) ? 255 : elapsed16;
+    debounce_time_t elapsed_time = debounce_time_update(&last_time);
+    uint8_t         elapsed      = (elapsed_time > 255) ? 255 : elapsed_time;
 
     uint8_t* countdown = countdowns;
 
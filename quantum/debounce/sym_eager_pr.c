@@ -22,6 +22,7 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 #include "matrix.h"
 #include "timer.h"
 #include "quantum.h"
+#include "debounce_time.h"
 #include <stdlib.h>
 
 #ifdef PROTOCOL_CHIBIOS
@@ -46,7 +47,7 @@ typedef uint8_t debounce_counter_t;
 static bool matrix_need_update;
 
 static debounce_counter_t *debounce_counters;
-static fast_timer_t        last_time;
+static debounce_time_t     last_time;
 static bool                counters_need_update;
 
 #    define DEBOUNCE_ELAPSED 0
@@ -71,11 +72,8 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     bool updated_last = false;
 
     if (counters_need_update) {
-        fast_timer_t now          = timer_read_fast();
-        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
-
-        last_time    = now;
-        updated_last = true;
+        debounce_time_t elapsed_time = debounce_time_update(&last_time);
+        updated_last                 = true;
         if (elapsed_time > UINT8_MAX) {
             elapsed_time = UINT8_MAX;
         }
@@ -87,7 +85,7 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 
     if (changed || matrix_need_update) {
         if (!updated_last) {
-            last_time = timer_read_fast();
+            last_time = debounce_time_read();
         }
 
         transfer_matrix_values(raw, cooked, num_rows);
@@ -15,6 +15,9 @@
 
 DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5
 
+# The same tests again, counting in microseconds
+DEBOUNCE_US_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE_US=5000
+
 DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
 
@@ -47,3 +50,22 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_sym_defer_g_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_defer_g_us_SRC := $(debounce_sym_defer_g_SRC)
+
+debounce_sym_defer_pk_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_defer_pk_us_SRC := $(debounce_sym_defer_pk_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_us_tests.cpp
+
+debounce_sym_defer_pr_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_defer_pr_us_SRC := $(debounce_sym_defer_pr_SRC)
+
+debounce_sym_eager_pk_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_eager_pk_us_SRC := $(debounce_sym_eager_pk_SRC)
+
+debounce_sym_eager_pr_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_sym_eager_pr_us_SRC := $(debounce_sym_eager_pr_SRC)
+
+debounce_asym_eager_defer_pk_us_DEFS := $(DEBOUNCE_US_DEFS)
+debounce_asym_eager_defer_pk_us_SRC := $(debounce_asym_eager_defer_pk_SRC)
@@ -0,0 +1,77 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+extern "C" {
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time_us(uint32_t us);
+}
+
+/* Scans every 100us, starting 300us into a millisecond */
+TEST(DebounceUs, ChangeIsReportedAfterTheDebounceTime) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    set_time(7777);
+    advance_time_us(300);
+    debounce_init(MATRIX_ROWS);
+
+    raw[0] = 1;
+    debounce(raw, cooked, MATRIX_ROWS, true);
+    for (uint32_t us = 100; us < DEBOUNCE_US; us += 100) {
+        advance_time_us(100);
+        debounce(raw, cooked, MATRIX_ROWS, false);
+        ASSERT_EQ(cooked[0], 0) << "after " << us << "us";
+    }
+
+    advance_time_us(100);
+    debounce(raw, cooked, MATRIX_ROWS, false);
+    EXPECT_EQ(cooked[0], 1);
+
+    debounce_free();
+}
+
+TEST(DebounceUs, BounceWithinATickRestartsTheDebounceTime) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    set_time(7777);
+    debounce_init(MATRIX_ROWS);
+
+    raw[0] = 1;
+    debounce(raw, cooked, MATRIX_ROWS, true);
+    advance_time_us(DEBOUNCE_US - 50);
+    raw[0] = 0;
+    debounce(raw, cooked, MATRIX_ROWS, true);
+    advance_time_us(30);
+    raw[0] = 1;
+    debounce(raw, cooked, MATRIX_ROWS, true);
+
+    advance_time_us(DEBOUNCE_US - 100);
+    debounce(raw, cooked, MATRIX_ROWS, false);
+    EXPECT_EQ(cooked[0], 0);
+
+    advance_time_us(100);
+    debounce(raw, cooked, MATRIX_ROWS, false);
+    EXPECT_EQ(cooked[0], 1);
+
+    debounce_free();
+}
@@ -53,8 +53,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 // TODO: Combine these into a single word and single block of EEPROM
 #define EECONFIG_KEYMAP_UPPER_BYTE (uint8_t *)34
+#ifdef TAPPING_PREDICT_ENABLE
+#    ifndef TAPPING_PREDICT_KEYS
+#        define TAPPING_PREDICT_KEYS 8
+#    endif
+// Version, then 10 bytes of statistics per key
+#    define EECONFIG_TAPPING_PREDICT (uint8_t *)35
+#    define EECONFIG_TAPPING_PREDICT_SIZE (1 + 10 * TAPPING_PREDICT_KEYS)
 // Size of EEPROM being used, other code can refer to this for available EEPROM
-#define EECONFIG_SIZE 35
+#    define EECONFIG_SIZE (35 + EECONFIG_TAPPING_PREDICT_SIZE)
+#else
+// Size of EEPROM being used, other code can refer to this for available EEPROM
+#    define EECONFIG_SIZE 35
+#endif
 /* debug bit */
 #define EECONFIG_DEBUG_ENABLE (1 << 0)
 #define EECONFIG_DEBUG_MATRIX (1 << 1)
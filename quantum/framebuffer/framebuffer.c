@@ -0,0 +1,209 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "framebuffer.h"
+#include "timer.h"
+#include <lib/lib8tion/lib8tion.h>
+
+#if FRAMEBUFFER_SPLAT_RADIUS < 1 || FRAMEBUFFER_SPLAT_RADIUS > 128
+#    error FRAMEBUFFER_SPLAT_RADIUS must be between 1 and 128
+#endif
+
+#define FRAMEBUFFER_CELLS (MATRIX_ROWS * MATRIX_COLS)
+
+#if FRAMEBUFFER_CELLS > 256
+typedef uint16_t framebuffer_cell_t;
+#else
+typedef uint8_t framebuffer_cell_t;
+#endif
+
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > UINT8_MAX
+#    error FRAMEBUFFER_SPLAT_NEIGHBOURS must be at most 255
+#endif
+
+static framebuffer_position_f splat_position;
+
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > 0
+// the neighbours of cell c are splat_cell[c][0] to splat_cell[c][splat_count[c] - 1]
+static uint8_t            splat_count[FRAMEBUFFER_CELLS];
+static framebuffer_cell_t splat_cell[FRAMEBUFFER_CELLS][FRAMEBUFFER_SPLAT_NEIGHBOURS];
+static uint8_t            splat_weight[FRAMEBUFFER_CELLS][FRAMEBUFFER_SPLAT_NEIGHBOURS];
+#endif
+
+static uint16_t framebuffer_timer;
+
+// Splat weight of the cell at other from x, y, 0 outside of the radius
+static uint8_t splat_weight_of(uint16_t other, uint8_t x, uint8_t y) {
+    uint8_t other_x, other_y;
+    if (!splat_position(other / MATRIX_COLS, other % MATRIX_COLS, &other_x, &other_y)) {
+        return 0;
+    }
+    int16_t dx = other_x - x;
+    int16_t dy = other_y - y;
+    if (dx <= -FRAMEBUFFER_SPLAT_RADIUS || dx >= FRAMEBUFFER_SPLAT_RADIUS || dy <= -FRAMEBUFFER_SPLAT_RADIUS || dy >= FRAMEBUFFER_SPLAT_RADIUS) {
+        return 0;
+    }
+    uint8_t dist = sqrt16(dx * dx + dy * dy);
+    if (dist >= FRAMEBUFFER_SPLAT_RADIUS) {
+        return 0;
+    }
+    // at least 1 inside the radius, as the radius is at most 128
+    return (FRAMEBUFFER_SPLAT_RADIUS - dist) * 255 / FRAMEBUFFER_SPLAT_RADIUS;
+}
+
+uint16_t framebuffer_init(framebuffer_position_f position) {
+    splat_position = position;
+
+    uint16_t dropped = 0;
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > 0
+    for (uint16_t cell = 0; cell < FRAMEBUFFER_CELLS; cell++) {
+        uint8_t x, y;
+        splat_count[cell] = 0;
+        if (!position(cell / MATRIX_COLS, cell % MATRIX_COLS, &x, &y)) {
+            continue;
+        }
+        for (uint16_t other = 0; other < FRAMEBUFFER_CELLS; other++) {
+            uint8_t weight = other == cell ? 0 : splat_weight_of(other, x, y);
+            if (!weight) {
+                continue;
+            }
+            if (splat_count[cell] < FRAMEBUFFER_SPLAT_NEIGHBOURS) {
+                splat_cell[cell][splat_count[cell]]   = other;
+                splat_weight[cell][splat_count[cell]] = weight;
+                splat_count[cell]++;
+                continue;
+            }
+
+            // full, the farthest neighbour makes way for a nearer one
+            dropped++;
+            uint8_t farthest = 0;
+            for (uint8_t i = 1; i < FRAMEBUFFER_SPLAT_NEIGHBOURS; i++) {
+                if (splat_weight[cell][i] < splat_weight[cell][farthest]) {
+                    farthest = i;
+                }
+            }
+            if (weight > splat_weight[cell][farthest]) {
+                splat_cell[cell][farthest]   = other;
+                splat_weight[cell][farthest] = weight;
+            }
+        }
+    }
+#endif
+    return dropped;
+}
+
+bool framebuffer_run(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], const framebuffer_kernels_t *kernels) {
+    if (kernels->interval) {
+        if (timer_elapsed(framebuffer_timer) < kernels->interval) {
+            return false;
+        }
+        framebuffer_timer = timer_read();
+    }
+
+    if (kernels->advect_row || kernels->advect_col) {
+        framebuffer_advect(buffer, kernels->advect_row, kernels->advect_col);
+    }
+    if (kernels->diffuse) {
+        framebuffer_diffuse(buffer, kernels->diffuse);
+    }
+    if (kernels->decay) {
+        framebuffer_decay(buffer, kernels->decay);
+    }
+    return true;
+}
+
+void framebuffer_advect(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], int8_t rows, int8_t cols) {
+    if (rows >= MATRIX_ROWS || -rows >= MATRIX_ROWS || cols >= MATRIX_COLS || -cols >= MATRIX_COLS) {
+        memset(buffer, 0, FRAMEBUFFER_CELLS);
+        return;
+    }
+
+    if (rows > 0) {
+        memmove(buffer[rows], buffer[0], (MATRIX_ROWS - rows) * MATRIX_COLS);
+        memset(buffer[0], 0, rows * MATRIX_COLS);
+    } else if (rows < 0) {
+        memmove(buffer[0], buffer[-rows], (MATRIX_ROWS + rows) * MATRIX_COLS);
+        memset(buffer[MATRIX_ROWS + rows], 0, -rows * MATRIX_COLS);
+    }
+
+    if (cols > 0) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            memmove(&buffer[row][cols], &buffer[row][0], MATRIX_COLS - cols);
+            memset(&buffer[row][0], 0, cols);
+        }
+    } else if (cols < 0) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            memmove(&buffer[row][0], &buffer[row][-cols], MATRIX_COLS + cols);
+            memset(&buffer[row][MATRIX_COLS + cols], 0, -cols);
+        }
+    }
+}
+
+void framebuffer_diffuse(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t amount) {
+    // the blur needs the values from before this step, keep the rows that were overwritten already
+    uint8_t above[MATRIX_COLS];
+    uint8_t current[MATRIX_COLS];
+
+    memcpy(above, buffer[0], MATRIX_COLS);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        memcpy(current, buffer[row], MATRIX_COLS);
+        // edges repeat the outermost cells
+        const uint8_t *below = row + 1 < MATRIX_ROWS ? buffer[row + 1] : current;
+
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t  left  = col > 0 ? col - 1 : col;
+            uint8_t  right = col + 1 < MATRIX_COLS ? col + 1 : col;
+            uint16_t sum   = above[left] + 2 * above[col] + above[right];
+            sum += 2 * current[left] + 4 * current[col] + 2 * current[right];
+            sum += below[left] + 2 * below[col] + below[right];
+            buffer[row][col] = lerp8by8(current[col], sum >> 4, amount);
+        }
+        memcpy(above, current, MATRIX_COLS);
+    }
+}
+
+void framebuffer_decay(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t amount) {
+    uint8_t *cell = &buffer[0][0];
+    for (uint16_t i = 0; i < FRAMEBUFFER_CELLS; i++) {
+        cell[i] = qsub8(cell[i], amount);
+    }
+}
+
+void framebuffer_splat(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t row, uint8_t col, uint8_t amount) {
+    uint8_t *cell  = &buffer[0][0];
+    uint16_t index = row * MATRIX_COLS + col;
+
+    cell[index] = qadd8(cell[index], amount);
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > 0
+    for (uint8_t i = 0; i < splat_count[index]; i++) {
+        framebuffer_cell_t other = splat_cell[index][i];
+        cell[other]              = qadd8(cell[other], scale8(amount, splat_weight[index][i]));
+    }
+#else
+    uint8_t x, y;
+    if (!splat_position || !splat_position(row, col, &x, &y)) {
+        return;
+    }
+    for (uint16_t other = 0; other < FRAMEBUFFER_CELLS; other++) {
+        uint8_t weight = other == index ? 0 : splat_weight_of(other, x, y);
+        if (weight) {
+            cell[other] = qadd8(cell[other], scale8(amount, weight));
+        }
+    }
+#endif
+}
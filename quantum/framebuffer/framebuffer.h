@@ -0,0 +1,93 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Kernels for effects that keep state per matrix position.
+ *
+ * An effect describes the kernels it needs in a framebuffer_kernels_t and
+ * runs them with framebuffer_run() at the start of every frame. The kernels
+ * stream through the buffer row by row and only use 8 bit fixed point math:
+ *   advect   shift the buffer by a cell, emptying the cells moved away from
+ *   diffuse  blend every cell towards a 3x3 blur of its neighbourhood
+ *   decay    subtract a constant from every cell
+ * framebuffer_splat() adds to a cell and, scaled by physical distance, to the
+ * cells around it. The nearest FRAMEBUFFER_SPLAT_NEIGHBOURS neighbours of
+ * each cell and their weights are looked up once by framebuffer_init()
+ * instead of on every key press. The table takes 1 + 2 bytes per neighbour
+ * for every cell, 1 + 3 bytes per neighbour above 256 cells, so AVR defaults
+ * to no table and finds the neighbours on every splat.
+ */
+
+#ifndef FRAMEBUFFER_SPLAT_RADIUS
+#    define FRAMEBUFFER_SPLAT_RADIUS 32
+#endif // FRAMEBUFFER_SPLAT_RADIUS
+
+// Neighbours remembered per cell, 0 keeps no table. Defaults to the keys
+// within the radius on a grid with a 16 unit pitch, 8 at the default radius.
+#ifndef FRAMEBUFFER_SPLAT_NEIGHBOURS
+#    if defined(__AVR__)
+#        define FRAMEBUFFER_SPLAT_NEIGHBOURS 0
+#    elif FRAMEBUFFER_SPLAT_RADIUS <= 48
+#        define FRAMEBUFFER_SPLAT_NEIGHBOURS ((2 * ((FRAMEBUFFER_SPLAT_RADIUS - 1) / 16) + 1) * (2 * ((FRAMEBUFFER_SPLAT_RADIUS - 1) / 16) + 1) - 1)
+#    else
+#        define FRAMEBUFFER_SPLAT_NEIGHBOURS 24
+#    endif
+#endif // FRAMEBUFFER_SPLAT_NEIGHBOURS
+
+typedef struct {
+    uint16_t interval;   // milliseconds between steps, 0 steps on every call
+    int8_t   advect_row; // -1, 0 or 1 rows per step
+    int8_t   advect_col; // -1, 0 or 1 columns per step
+    uint8_t  diffuse;    // fraction of the blur blended in per step, 0 disables
+    uint8_t  decay;      // subtracted from every cell per step, 0 disables
+} framebuffer_kernels_t;
+
+/**
+ * @brief Returns the physical position of the LED at a matrix position.
+ *
+ * @return false if there is no LED at that position.
+ */
+typedef bool (*framebuffer_position_f)(uint8_t row, uint8_t col, uint8_t *x, uint8_t *y);
+
+/**
+ * @brief Build the splat neighbour table from the LED positions.
+ *
+ * @return the number of neighbours within FRAMEBUFFER_SPLAT_RADIUS that were
+ * dropped because their cell already had FRAMEBUFFER_SPLAT_NEIGHBOURS nearer
+ * ones, 0 when every key press reaches all of its neighbours.
+ */
+uint16_t framebuffer_init(framebuffer_position_f position);
+
+/**
+ * @brief Run one step of the kernels if their interval has elapsed.
+ *
+ * @return true if a step was run.
+ */
+bool framebuffer_run(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], const framebuffer_kernels_t *kernels);
+
+void framebuffer_advect(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], int8_t rows, int8_t cols);
+void framebuffer_diffuse(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t amount);
+void framebuffer_decay(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t amount);
+
+/**
+ * @brief Add amount to a cell and a share of it to the cells within
+ * FRAMEBUFFER_SPLAT_RADIUS, falling off linearly with distance.
+ */
+void framebuffer_splat(uint8_t buffer[MATRIX_ROWS][MATRIX_COLS], uint8_t row, uint8_t col, uint8_t amount);
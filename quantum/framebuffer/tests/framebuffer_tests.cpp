@@ -0,0 +1,240 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "framebuffer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// One key every 16 units, with no LED at the bottom right
+static bool grid_position(uint8_t row, uint8_t col, uint8_t *x, uint8_t *y) {
+    if (row == MATRIX_ROWS - 1 && col == MATRIX_COLS - 1) {
+        return false;
+    }
+    *x = col * 16;
+    *y = row * 16;
+    return true;
+}
+
+// Keys 15 units apart with rows 12 units apart, up to 16 neighbours each
+static bool dense_position(uint8_t row, uint8_t col, uint8_t *x, uint8_t *y) {
+    *x = col * 15;
+    *y = row * 12;
+    return true;
+}
+
+// Keys 6 units apart, the whole matrix is within the radius of every key
+static bool packed_position(uint8_t row, uint8_t col, uint8_t *x, uint8_t *y) {
+    *x = col * 6;
+    *y = row * 6;
+    return true;
+}
+
+class FramebufferTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(buffer, 0, sizeof(buffer));
+        set_time(0);
+        framebuffer_init(grid_position);
+    }
+
+    uint16_t total(void) {
+        uint16_t sum = 0;
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                sum += buffer[row][col];
+            }
+        }
+        return sum;
+    }
+
+    uint8_t buffer[MATRIX_ROWS][MATRIX_COLS];
+};
+
+TEST_F(FramebufferTest, DecaySaturatesAtZero) {
+    buffer[0][0] = 10;
+    buffer[1][2] = 1;
+    framebuffer_decay(buffer, 3);
+    EXPECT_EQ(buffer[0][0], 7);
+    EXPECT_EQ(buffer[1][2], 0);
+    EXPECT_EQ(total(), 7);
+}
+
+TEST_F(FramebufferTest, SplatFallsOffWithDistance) {
+    framebuffer_splat(buffer, 1, 1, 64);
+
+    EXPECT_EQ(buffer[1][1], 64);
+    // 16 units away
+    EXPECT_EQ(buffer[0][1], buffer[1][0]);
+    EXPECT_GT(buffer[0][1], 0);
+    EXPECT_LT(buffer[0][1], 64);
+    // 22 units away
+    EXPECT_GT(buffer[0][0], 0);
+    EXPECT_LT(buffer[0][0], buffer[0][1]);
+    // 32 units away, outside of the radius
+    EXPECT_EQ(buffer[1][3], 0);
+    EXPECT_EQ(buffer[3][1], 0);
+}
+
+TEST_F(FramebufferTest, SplatSkipsCellsWithoutLed) {
+    framebuffer_splat(buffer, 2, 4, 64);
+
+    EXPECT_EQ(buffer[2][4], 64);
+    EXPECT_GT(buffer[2][3], 0);
+    EXPECT_EQ(buffer[3][4], 0);
+}
+
+TEST_F(FramebufferTest, SplatReachesEveryNeighbourOfDenseGrid) {
+    EXPECT_EQ(framebuffer_init(dense_position), 0);
+
+    framebuffer_splat(buffer, 1, 2, 64);
+    // 30 and 28 units away
+    EXPECT_GT(buffer[1][0], 0);
+    EXPECT_GT(buffer[1][4], 0);
+    EXPECT_GT(buffer[3][1], 0);
+    EXPECT_GT(buffer[3][3], 0);
+    // 32 units away
+    EXPECT_EQ(buffer[3][0], 0);
+
+    // every key reaches its neighbours, not only the first ones in the matrix
+    memset(buffer, 0, sizeof(buffer));
+    framebuffer_splat(buffer, 3, 4, 64);
+    EXPECT_GT(buffer[3][3], 0);
+    EXPECT_GT(buffer[2][4], 0);
+    EXPECT_GT(buffer[1][3], 0);
+}
+
+TEST_F(FramebufferTest, SplatKeepsNearestNeighbours) {
+    uint16_t dropped = framebuffer_init(packed_position);
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > 0
+    // all 19 other keys are within the radius of every key
+    EXPECT_EQ(dropped, MATRIX_ROWS * MATRIX_COLS * (MATRIX_ROWS * MATRIX_COLS - 1 - FRAMEBUFFER_SPLAT_NEIGHBOURS));
+#else
+    EXPECT_EQ(dropped, 0);
+#endif
+
+    framebuffer_splat(buffer, 0, 0, 128);
+    EXPECT_EQ(buffer[0][0], 128);
+    // 6 and 8 units away
+    EXPECT_GT(buffer[0][1], buffer[1][1]);
+    EXPECT_GT(buffer[1][1], 0);
+    // 18 and 24 units away
+    EXPECT_GT(buffer[3][0], 0);
+    EXPECT_GT(buffer[0][4], 0);
+#if FRAMEBUFFER_SPLAT_NEIGHBOURS > 0
+    // the three farthest keys, 25 to 30 units away, made way
+    EXPECT_EQ(buffer[3][3], 0);
+    EXPECT_EQ(buffer[2][4], 0);
+    EXPECT_EQ(buffer[3][4], 0);
+#else
+    EXPECT_GT(buffer[3][4], 0);
+#endif
+}
+
+TEST_F(FramebufferTest, SplatSaturates) {
+    for (int i = 0; i < 10; i++) {
+        framebuffer_splat(buffer, 0, 0, 64);
+    }
+    EXPECT_EQ(buffer[0][0], 255);
+}
+
+TEST_F(FramebufferTest, DiffuseSpreadsAndKeepsUniformBuffer) {
+    memset(buffer, 100, sizeof(buffer));
+    framebuffer_diffuse(buffer, 255);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            EXPECT_EQ(buffer[row][col], 100);
+        }
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer[1][2] = 160;
+    framebuffer_diffuse(buffer, 255);
+    // 4/16, 2/16 and 1/16 of the cell, blended in by 255/256
+    EXPECT_EQ(buffer[1][2], 41);
+    EXPECT_EQ(buffer[0][2], 19);
+    EXPECT_EQ(buffer[1][1], 19);
+    EXPECT_EQ(buffer[2][3], 9);
+    EXPECT_EQ(buffer[3][2], 0);
+}
+
+TEST_F(FramebufferTest, DiffuseAmountBlends) {
+    buffer[1][2] = 160;
+    framebuffer_diffuse(buffer, 0);
+    EXPECT_EQ(buffer[1][2], 160);
+    EXPECT_EQ(buffer[0][2], 0);
+}
+
+TEST_F(FramebufferTest, AdvectShiftsAndEmpties) {
+    buffer[0][0] = 1;
+    buffer[2][3] = 2;
+
+    framebuffer_advect(buffer, 1, 0);
+    EXPECT_EQ(buffer[1][0], 1);
+    EXPECT_EQ(buffer[3][3], 2);
+    EXPECT_EQ(total(), 3);
+
+    framebuffer_advect(buffer, 1, 0);
+    EXPECT_EQ(buffer[2][0], 1);
+    EXPECT_EQ(total(), 1);
+
+    framebuffer_advect(buffer, -2, 1);
+    EXPECT_EQ(buffer[0][1], 1);
+    EXPECT_EQ(total(), 1);
+
+    framebuffer_advect(buffer, 0, -1);
+    EXPECT_EQ(buffer[0][0], 1);
+    framebuffer_advect(buffer, 0, -1);
+    EXPECT_EQ(total(), 0);
+}
+
+TEST_F(FramebufferTest, RunHonoursInterval) {
+    const framebuffer_kernels_t kernels = {
+        .interval = 25,
+        .decay    = 1,
+    };
+    buffer[0][0] = 10;
+
+    advance_time(25);
+    EXPECT_TRUE(framebuffer_run(buffer, &kernels));
+    EXPECT_EQ(buffer[0][0], 9);
+
+    advance_time(24);
+    EXPECT_FALSE(framebuffer_run(buffer, &kernels));
+    EXPECT_EQ(buffer[0][0], 9);
+
+    advance_time(1);
+    EXPECT_TRUE(framebuffer_run(buffer, &kernels));
+    EXPECT_EQ(buffer[0][0], 8);
+}
+
+TEST_F(FramebufferTest, RunAppliesKernelsInOrder) {
+    const framebuffer_kernels_t kernels = {
+        .advect_row = 1,
+        .decay      = 5,
+    };
+    buffer[0][0] = 10;
+
+    EXPECT_TRUE(framebuffer_run(buffer, &kernels));
+    EXPECT_EQ(buffer[0][0], 0);
+    EXPECT_EQ(buffer[1][0], 5);
+}
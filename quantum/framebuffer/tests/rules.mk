@@ -0,0 +1,19 @@
+framebuffer_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=5 -DFRAMEBUFFER_SPLAT_NEIGHBOURS=16
+
+framebuffer_SRC := \
+	$(QUANTUM_PATH)/framebuffer/tests/framebuffer_tests.cpp \
+	$(QUANTUM_PATH)/framebuffer/framebuffer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+framebuffer_INC := \
+	$(QUANTUM_PATH)/framebuffer
+
+framebuffer_direct_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=5 -DFRAMEBUFFER_SPLAT_NEIGHBOURS=0
+
+framebuffer_direct_SRC := \
+	$(QUANTUM_PATH)/framebuffer/tests/framebuffer_tests.cpp \
+	$(QUANTUM_PATH)/framebuffer/framebuffer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+framebuffer_direct_INC := \
+	$(QUANTUM_PATH)/framebuffer
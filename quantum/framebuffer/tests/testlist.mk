@@ -0,0 +1,3 @@
+TEST_LIST += \
+	framebuffer \
+	framebuffer_direct
@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "telemetry.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -72,6 +73,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef HD44780_ENABLE
 #    include "hd44780.h"
 #endif
+#ifdef I2C_ASYNC_ENABLE
+#    include "i2c_queue.h"
+#endif
+#ifdef SPI_ASYNC_ENABLE
+#    include "spi_queue.h"
+#endif
 #ifdef OLED_ENABLE
 #    include "oled_driver.h"
 #endif
@@ -108,6 +115,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
 #endif
+#ifdef TAPPING_PREDICT_ENABLE
+#    include "tapping_predict.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -139,6 +149,74 @@ void last_encoder_activity_trigger(void) {
     last_encoder_modification_time = last_input_modification_time = timer_read32();
 }
 
+#ifdef MATRIX_IDLE_TIMEOUT
+#    ifdef SPLIT_KEYBOARD
+#        error MATRIX_IDLE_TIMEOUT is not supported on split keyboards
+#    endif
+#    ifndef MATRIX_IDLE_SCAN_INTERVAL
+#        define MATRIX_IDLE_SCAN_INTERVAL 50
+#    endif
+
+static bool     matrix_idle = false;
+static uint16_t matrix_idle_scan_time;
+static uint16_t matrix_idle_check_time;
+
+bool matrix_is_idle(void) {
+    return matrix_idle;
+}
+
+static bool matrix_is_released(void) {
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r)) return false;
+    }
+    return true;
+}
+
+/** \brief Scan the matrix, at a reduced rate while idle
+ *
+ * Once nothing is held and the matrix has been quiet for MATRIX_IDLE_TIMEOUT ms,
+ * full scans only run every MATRIX_IDLE_SCAN_INTERVAL ms. In between,
+ * matrix_wake_check() is polled once per ms and returns to full rate on the
+ * first press. matrix_scan_quantum() keeps running on every loop, so the
+ * keyboard and keymap scan hooks are not slowed down.
+ */
+static uint8_t matrix_scan_adaptive(void) {
+    if (matrix_idle) {
+        uint16_t now  = timer_read();
+        bool     wake = false;
+        if (now != matrix_idle_check_time) {
+            matrix_idle_check_time = now;
+            wake                   = matrix_wake_check();
+        }
+        if (wake) {
+            matrix_idle = false;
+            last_matrix_activity_trigger();
+        } else if (TIMER_DIFF_16(now, matrix_idle_scan_time) < MATRIX_IDLE_SCAN_INTERVAL) {
+            // only the pin reads slow down, the scan hooks still run every loop
+            matrix_scan_quantum();
+            return 0;
+        }
+        matrix_idle_scan_time = now;
+    }
+
+    uint8_t matrix_changed = matrix_scan();
+    if (matrix_changed || !matrix_is_released()) {
+        matrix_idle = false;
+    } else if (!matrix_idle && last_matrix_activity_elapsed() >= MATRIX_IDLE_TIMEOUT) {
+        matrix_idle            = true;
+        matrix_idle_scan_time  = timer_read();
+        matrix_idle_check_time = matrix_idle_scan_time;
+    }
+    return matrix_changed;
+}
+#else
+bool matrix_is_idle(void) {
+    return false;
+}
+
+#    define matrix_scan_adaptive() matrix_scan()
+#endif
+
 // Only enable this if console is enabled to print to
 #if defined(DEBUG_MATRIX_SCAN_RATE)
 static uint32_t matrix_timer           = 0;
@@ -405,6 +483,12 @@ void keyboard_init(void) {
 #ifdef DIP_SWITCH_ENABLE
     dip_switch_init();
 #endif
+#ifdef TAPPING_PREDICT_ENABLE
+    tapping_predict_init();
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
 #ifdef SLEEP_LED_ENABLE
     sleep_led_init();
 #endif
@@ -448,7 +532,7 @@ bool matrix_scan_task(void) {
     uint8_t keys_processed = 0;
 #endif
 
-    uint8_t matrix_changed = matrix_scan();
+    uint8_t matrix_changed = matrix_scan_adaptive();
     if (matrix_changed) last_matrix_activity_trigger();
 
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
@@ -465,9 +549,7 @@ bool matrix_scan_task(void) {
             for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                 if (matrix_change & col_mask) {
                     if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
+                        action_exec(make_keyevent((keypos_t){.row = r, .col = c}, (matrix_row & col_mask)));
                     }
                     // record a processed key
                     matrix_prev[r] ^= col_mask;
@@ -551,6 +633,18 @@ void quantum_task(void) {
     decay_wpm();
 #endif
 
+#ifdef TAPPING_PREDICT_ENABLE
+    tapping_predict_task();
+#endif
+
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_task();
+#endif
+
+#ifdef VIA_ENABLE
+    via_task();
+#endif
+
 #ifdef HAPTIC_ENABLE
     haptic_task();
 #endif
@@ -576,11 +670,16 @@ void quantum_task(void) {
  * This is repeatedly called as fast as possible.
  */
 void keyboard_task(void) {
-    bool matrix_changed = matrix_scan_task();
+    uint32_t telemetry_start = telemetry_time_start();
+    bool     matrix_changed  = matrix_scan_task();
     (void)matrix_changed;
+    telemetry_time_end(TELEMETRY_MATRIX_SCAN, telemetry_start);
 
+    telemetry_start = telemetry_time_start();
     quantum_task();
+    telemetry_time_end(TELEMETRY_QUANTUM_TASKS, telemetry_start);
 
+    telemetry_start = telemetry_time_start();
 #if defined(RGBLIGHT_ENABLE)
     rgblight_task();
 #endif
@@ -597,6 +696,7 @@ void keyboard_task(void) {
     backlight_task();
 #    endif
 #endif
+    telemetry_time_end(TELEMETRY_LIGHTING, telemetry_start);
 
 #ifdef ENCODER_ENABLE
     bool encoders_changed = encoder_read();
@@ -662,5 +762,17 @@ void keyboard_task(void) {
     programmable_button_send();
 #endif
 
+#ifdef I2C_ASYNC_ENABLE
+    i2c_queue_task();
+#endif
+
+#ifdef SPI_ASYNC_ENABLE
+    spi_queue_task();
+#endif
+
     led_task();
+
+#ifdef TELEMETRY_ENABLE
+    telemetry_task();
+#endif
 }
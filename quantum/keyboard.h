@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "timer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +36,9 @@ typedef struct {
     keypos_t key;
     bool     pressed;
     uint16_t time;
+#ifdef KEYEVENT_TIME_US
+    uint32_t time_us;
+#endif
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -54,11 +58,18 @@ static inline bool IS_RELEASED(keyevent_t event) {
     return (!IS_NOEVENT(event) && !event.pressed);
 }
 
+/* key event stamped with the current time */
+static inline keyevent_t make_keyevent(keypos_t key, bool pressed) {
+    return (keyevent_t){
+        .key = key, .pressed = pressed, .time = (timer_read() | 1), /* time should not be 0 */
+#ifdef KEYEVENT_TIME_US
+        .time_us = timer_read_us(),
+#endif
+    };
+}
+
 /* Tick event */
-#define TICK                                                                                    \
-    (keyevent_t) {                                                                              \
-        .key = (keypos_t){.row = 255, .col = 255}, .pressed = false, .time = (timer_read() | 1) \
-    }
+#define TICK make_keyevent((keypos_t){.row = 255, .col = 255}, false)
 
 /* it runs once at early stage of startup before keyboard_init. */
 void keyboard_setup(void);
@@ -91,6 +102,8 @@ uint32_t last_encoder_activity_elapsed(void); // Number of milliseconds since th
 
 uint32_t get_matrix_scan_rate(void);
 
+bool matrix_is_idle(void); // Whether the matrix is scanned at the idle rate, see MATRIX_IDLE_TIMEOUT
+
 #ifdef __cplusplus
 }
 #endif
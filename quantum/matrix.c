@@ -21,6 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#ifdef MATRIX_READ_BY_PORT
+#    include "matrix_port.h"
+#endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -57,6 +60,42 @@ static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS]   = MATRIX_COL_PINS;
 #    endif // MATRIX_COL_PINS
 #endif
 
+#ifdef MATRIX_READ_BY_PORT
+#    if defined(DIRECT_PINS) || !defined(MATRIX_ROW_PINS) || !defined(MATRIX_COL_PINS)
+#        error MATRIX_READ_BY_PORT requires MATRIX_ROW_PINS and MATRIX_COL_PINS
+#    endif
+
+// Size the group tables from the build time pin grouping when available
+#    if defined(MATRIX_COL_PINS_RIGHT) && !defined(MATRIX_COL_PORT_GROUPS_RIGHT)
+#        define MATRIX_COL_PORT_GROUPS_MAX MATRIX_COLS
+#    elif defined(MATRIX_COL_PORT_GROUPS_RIGHT) && (!defined(MATRIX_COL_PORT_GROUPS) || MATRIX_COL_PORT_GROUPS_RIGHT > MATRIX_COL_PORT_GROUPS)
+#        define MATRIX_COL_PORT_GROUPS_MAX MATRIX_COL_PORT_GROUPS_RIGHT
+#    elif defined(MATRIX_COL_PORT_GROUPS)
+#        define MATRIX_COL_PORT_GROUPS_MAX MATRIX_COL_PORT_GROUPS
+#    else
+#        define MATRIX_COL_PORT_GROUPS_MAX MATRIX_COLS
+#    endif
+#    if defined(MATRIX_ROW_PINS_RIGHT) && !defined(MATRIX_ROW_PORT_GROUPS_RIGHT)
+#        define MATRIX_ROW_PORT_GROUPS_MAX ROWS_PER_HAND
+#    elif defined(MATRIX_ROW_PORT_GROUPS_RIGHT) && (!defined(MATRIX_ROW_PORT_GROUPS) || MATRIX_ROW_PORT_GROUPS_RIGHT > MATRIX_ROW_PORT_GROUPS)
+#        define MATRIX_ROW_PORT_GROUPS_MAX MATRIX_ROW_PORT_GROUPS_RIGHT
+#    elif defined(MATRIX_ROW_PORT_GROUPS)
+#        define MATRIX_ROW_PORT_GROUPS_MAX MATRIX_ROW_PORT_GROUPS
+#    else
+#        define MATRIX_ROW_PORT_GROUPS_MAX ROWS_PER_HAND
+#    endif
+
+#    if (DIODE_DIRECTION == COL2ROW)
+static matrix_port_group_t col_port_groups[MATRIX_COL_PORT_GROUPS_MAX];
+static uint8_t             col_port_group_count;
+static matrix_row_t        col_pin_mask; // Columns with a pin
+#    elif (DIODE_DIRECTION == ROW2COL)
+static matrix_port_group_t row_port_groups[MATRIX_ROW_PORT_GROUPS_MAX];
+static uint8_t             row_port_group_count;
+static uint32_t            row_pin_mask; // Rows with a pin
+#    endif
+#endif // MATRIX_READ_BY_PORT
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS]; // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];     // debounced values
@@ -130,6 +169,18 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+static bool read_any_key(void) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pin_t pin = direct_pins[row][col];
+            if (pin != NO_PIN && !readPin(pin)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 #elif defined(DIODE_DIRECTION)
 #    if defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
 #        if (DIODE_DIRECTION == COL2ROW)
@@ -178,13 +229,21 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
-    // For each col...
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
-        uint8_t pin_state = readMatrixPin(col_pins[col_index]);
-
-        // Populate the matrix row with the state of the col pin
-        current_row_value |= pin_state ? 0 : row_shifter;
+#            ifdef MATRIX_READ_BY_PORT
+    if (col_port_group_count) {
+        // Gather all cols with one read per port
+        current_row_value = ~(matrix_row_t)matrix_port_read(col_port_groups, col_port_group_count) & col_pin_mask;
+    } else
+#            endif
+    {
+        // For each col...
+        matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+        for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
+            uint8_t pin_state = readMatrixPin(col_pins[col_index]);
+
+            // Populate the matrix row with the state of the col pin
+            current_row_value |= pin_state ? 0 : row_shifter;
+        }
     }
 
     // Unselect row
@@ -195,6 +254,34 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+static bool read_any_key(void) {
+    // Select every row at once, any pressed key then pulls its col low
+    bool selected = false;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        selected |= select_row(row);
+    }
+    if (!selected) {
+        return false;
+    }
+    matrix_output_select_delay();
+
+    bool pressed = false;
+#            ifdef MATRIX_READ_BY_PORT
+    if (col_port_group_count) {
+        pressed = ~matrix_port_read(col_port_groups, col_port_group_count) & col_pin_mask;
+    } else
+#            endif
+    {
+        for (uint8_t col = 0; col < MATRIX_COLS && !pressed; col++) {
+            pressed = !readMatrixPin(col_pins[col]);
+        }
+    }
+
+    unselect_rows();
+    matrix_output_unselect_delay(0, pressed);
+    return pressed;
+}
+
 #        elif (DIODE_DIRECTION == ROW2COL)
 
 static bool select_col(uint8_t col) {
@@ -241,10 +328,20 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_READ_BY_PORT
+    // Gather all rows with one read per port, NO_PIN rows read high
+    uint32_t row_levels = row_port_group_count ? matrix_port_read(row_port_groups, row_port_group_count) | ~row_pin_mask : 0;
+#            endif
+
     // For each row...
     for (uint8_t row_index = 0; row_index < ROWS_PER_HAND; row_index++) {
         // Check row pin state
-        if (readMatrixPin(row_pins[row_index]) == 0) {
+#            ifdef MATRIX_READ_BY_PORT
+        uint8_t pin_state = row_port_group_count ? (row_levels >> row_index) & 1 : readMatrixPin(row_pins[row_index]);
+#            else
+        uint8_t pin_state = readMatrixPin(row_pins[row_index]);
+#            endif
+        if (pin_state == 0) {
             // Pin LO, set col bit
             current_matrix[row_index] |= row_shifter;
             key_pressed = true;
@@ -259,6 +356,34 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     matrix_output_unselect_delay(current_col, key_pressed); // wait for all Row signals to go HIGH
 }
 
+static bool read_any_key(void) {
+    // Select every col at once, any pressed key then pulls its row low
+    bool selected = false;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        selected |= select_col(col);
+    }
+    if (!selected) {
+        return false;
+    }
+    matrix_output_select_delay();
+
+    bool pressed = false;
+#            ifdef MATRIX_READ_BY_PORT
+    if (row_port_group_count) {
+        pressed = ~matrix_port_read(row_port_groups, row_port_group_count) & row_pin_mask;
+    } else
+#            endif
+    {
+        for (uint8_t row = 0; row < ROWS_PER_HAND && !pressed; row++) {
+            pressed = !readMatrixPin(row_pins[row]);
+        }
+    }
+
+    unselect_cols();
+    matrix_output_unselect_delay(0, pressed);
+    return pressed;
+}
+
 #        else
 #            error DIODE_DIRECTION must be one of COL2ROW or ROW2COL!
 #        endif
@@ -297,6 +422,27 @@ void matrix_init(void) {
     thatHand = ROWS_PER_HAND - thisHand;
 #endif
 
+#ifdef MATRIX_READ_BY_PORT
+    // Falls back to reading pin by pin if the pins do not fit the tables
+#    if (DIODE_DIRECTION == COL2ROW)
+    col_port_group_count = matrix_port_groups_init(col_port_groups, MATRIX_COL_PORT_GROUPS_MAX, col_pins, MATRIX_COLS);
+    col_pin_mask         = 0;
+    for (uint8_t i = 0; i < MATRIX_COLS; i++) {
+        if (col_pins[i] != NO_PIN) {
+            col_pin_mask |= MATRIX_ROW_SHIFTER << i;
+        }
+    }
+#    elif (DIODE_DIRECTION == ROW2COL)
+    row_port_group_count = matrix_port_groups_init(row_port_groups, MATRIX_ROW_PORT_GROUPS_MAX, row_pins, ROWS_PER_HAND);
+    row_pin_mask         = 0;
+    for (uint8_t i = 0; row_port_group_count && i < ROWS_PER_HAND; i++) {
+        if (row_pins[i] != NO_PIN) {
+            row_pin_mask |= (uint32_t)1 << i;
+        }
+    }
+#    endif
+#endif
+
     // initialize key pins
     matrix_init_pins();
 
@@ -345,3 +491,18 @@ uint8_t matrix_scan(void) {
 #endif
     return (uint8_t)changed;
 }
+
+bool matrix_wake_check(void) {
+    if (read_any_key()) {
+        return true;
+    }
+#ifdef SPLIT_KEYBOARD
+    /* Keys of the other half only arrive with the transport exchange of a
+     * full scan, so fall back to one when nothing is down on this half. */
+    matrix_scan();
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix_get_row(row)) return true;
+    }
+#endif
+    return false;
+}
@@ -61,6 +61,8 @@ void matrix_io_delay(void);
 /* power control */
 void matrix_power_up(void);
 void matrix_power_down(void);
+/* whether any key is down, checked as cheaply as the matrix allows */
+bool matrix_wake_check(void);
 
 /* executes code for Quantum */
 void matrix_init_quantum(void);
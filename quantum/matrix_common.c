@@ -130,6 +130,12 @@ __attribute__((weak)) void matrix_output_select_delay(void) {
     waitInputPinDelay();
 }
 __attribute__((weak)) void matrix_output_unselect_delay(uint8_t line, bool key_pressed) {
+#ifdef MATRIX_IO_DELAY_ON_PRESS_ONLY
+    // Inputs that were never pulled low have nothing to recover from
+    if (!key_pressed) {
+        return;
+    }
+#endif
     matrix_io_delay();
 }
 
@@ -0,0 +1,79 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "matrix_port.h"
+
+uint8_t matrix_port_groups_init(matrix_port_group_t *groups, uint8_t max_groups, const pin_t *pins, uint8_t count) {
+    uint8_t used = 0;
+
+    if (count > 32) {
+        return 0;
+    }
+
+    for (uint8_t index = 0; index < count; index++) {
+        pin_t pin = pins[index];
+        if (pin == NO_PIN) {
+            continue;
+        }
+        int8_t shift = (int8_t)getPinPad(pin) - (int8_t)index;
+
+        // Find the group to join, or where to insert a new one after the others on the port
+        uint8_t slot = used;
+        bool    same = false;
+        for (uint8_t i = 0; i < used; i++) {
+            if (getPinPort(groups[i].pin) == getPinPort(pin)) {
+                slot = i + 1;
+                if (groups[i].shift == shift) {
+                    same = true;
+                    slot = i;
+                    break;
+                }
+            }
+        }
+
+        if (!same) {
+            if (used == max_groups) {
+                return 0;
+            }
+            memmove(&groups[slot + 1], &groups[slot], (used - slot) * sizeof(matrix_port_group_t));
+            groups[slot] = (matrix_port_group_t){.pin = pin, .mask = 0, .shift = shift, .read_port = false};
+            used++;
+        }
+        groups[slot].mask |= (port_data_t)1 << getPinPad(pin);
+    }
+
+    for (uint8_t i = 0; i < used; i++) {
+        groups[i].read_port = i == 0 || getPinPort(groups[i - 1].pin) != getPinPort(groups[i].pin);
+    }
+    return used;
+}
+
+uint32_t matrix_port_read(const matrix_port_group_t *groups, uint8_t count) {
+    uint32_t    bits = 0;
+    port_data_t port = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const matrix_port_group_t *group = &groups[i];
+        if (group->read_port) {
+            port = readPort(group->pin);
+        }
+        uint32_t gathered = port & group->mask;
+        bits |= group->shift >= 0 ? gathered >> group->shift : gathered << -group->shift;
+    }
+    return bits;
+}
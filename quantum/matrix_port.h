@@ -0,0 +1,50 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+/* Port parallel pin reads.
+ *
+ * A set of up to 32 pins is split into groups of pins that share a GPIO port
+ * and the same distance between their pad and their index in the set, so each
+ * group is gathered with a single mask and shift. Groups on the same port are
+ * kept next to each other, and share a single read of the port.
+ */
+
+typedef struct {
+    pin_t       pin;       // Any pin of the port
+    port_data_t mask;      // Pads belonging to the group
+    int8_t      shift;     // Pad minus index
+    bool        read_port; // First group of its port
+} matrix_port_group_t;
+
+/**
+ * @brief Build the groups for a set of pins, NO_PIN entries are skipped.
+ *
+ * @return the number of groups used, or 0 if the pins do not fit.
+ */
+uint8_t matrix_port_groups_init(matrix_port_group_t *groups, uint8_t max_groups, const pin_t *pins, uint8_t count);
+
+/**
+ * @brief Read the level of every pin of the set, bit n holding pin n.
+ *
+ * Bits of NO_PIN entries are 0.
+ */
+uint32_t matrix_port_read(const matrix_port_group_t *groups, uint8_t count);
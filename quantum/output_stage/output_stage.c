@@ -0,0 +1,109 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output_stage.h"
+
+// clang-format off
+
+// CIE 1931 lightness to linear light, Y = ((L + 16) / 116)^3 or L / 902.3 for L <= 8
+// with L = value * 100 / 255, scaled to 16 bits
+const uint16_t OUTPUT_STAGE_GAMMA[256] PROGMEM = {
+        0,    28,    57,    85,   114,   142,   171,   199,   228,   256,   285,   313,   342,   370,   399,   427,
+      456,   484,   513,   541,   570,   598,   627,   658,   689,   721,   755,   789,   825,   861,   899,   937,
+      977,  1018,  1060,  1103,  1147,  1192,  1239,  1287,  1336,  1386,  1437,  1490,  1544,  1599,  1656,  1714,
+     1773,  1834,  1896,  1959,  2024,  2090,  2157,  2226,  2297,  2369,  2442,  2517,  2593,  2671,  2751,  2832,
+     2914,  2999,  3085,  3172,  3261,  3352,  3444,  3538,  3634,  3732,  3831,  3932,  4035,  4139,  4245,  4354,
+     4464,  4575,  4689,  4804,  4922,  5041,  5162,  5285,  5410,  5537,  5666,  5797,  5930,  6065,  6202,  6341,
+     6482,  6626,  6771,  6918,  7068,  7220,  7373,  7529,  7687,  7848,  8010,  8175,  8342,  8512,  8683,  8857,
+     9033,  9212,  9393,  9576,  9762,  9949, 10140, 10333, 10528, 10725, 10926, 11128, 11333, 11541, 11751, 11963,
+    12179, 12396, 12617, 12840, 13065, 13293, 13524, 13757, 13993, 14232, 14474, 14718, 14965, 15215, 15467, 15722,
+    15980, 16241, 16505, 16771, 17041, 17313, 17588, 17866, 18147, 18431, 18717, 19007, 19300, 19596, 19894, 20196,
+    20501, 20809, 21119, 21433, 21750, 22071, 22394, 22720, 23050, 23383, 23719, 24058, 24400, 24746, 25095, 25447,
+    25802, 26161, 26523, 26888, 27257, 27629, 28004, 28383, 28765, 29151, 29540, 29932, 30328, 30728, 31131, 31537,
+    31947, 32360, 32777, 33198, 33622, 34050, 34481, 34916, 35355, 35797, 36243, 36693, 37146, 37603, 38064, 38529,
+    38997, 39469, 39945, 40425, 40908, 41396, 41887, 42382, 42881, 43384, 43891, 44401, 44916, 45435, 45957, 46484,
+    47015, 47549, 48088, 48631, 49178, 49728, 50283, 50843, 51406, 51973, 52545, 53120, 53700, 54284, 54873, 55465,
+    56062, 56663, 57269, 57878, 58492, 59111, 59733, 60360, 60992, 61627, 62268, 62912, 63561, 64215, 64873, 65535
+};
+
+// clang-format on
+
+static void output_stage_set_gains(output_stage_t *stage, uint16_t scale) {
+    for (uint8_t c = 0; c < stage->channels; c++) {
+        stage->gain[c] = ((uint32_t)stage->white_balance[c] * 257 * ((uint32_t)scale + 1)) >> 16;
+        // 8 bit output is linear / 257, so 8.8 fixed point is linear * 256 / 257, close to linear * 0xFF00 / 0x10000
+        stage->dither_gain[c] = (((uint32_t)stage->gain[c] + 1) * 0xFF00) >> 16;
+    }
+}
+
+void output_stage_init(output_stage_t *stage, uint8_t channels, const uint8_t *white_balance, uint8_t channel_current, uint16_t current_limit) {
+    stage->channels        = channels < OUTPUT_STAGE_MAX_CHANNELS ? channels : OUTPUT_STAGE_MAX_CHANNELS;
+    stage->channel_current = channel_current;
+    stage->current_limit   = current_limit;
+    stage->current         = 0;
+    for (uint8_t c = 0; c < stage->channels; c++) {
+        stage->white_balance[c] = white_balance ? white_balance[c] : UINT8_MAX;
+    }
+    output_stage_set_gains(stage, UINT16_MAX);
+}
+
+void output_stage_prepare(output_stage_t *stage, const uint8_t *frame, uint8_t pixels) {
+    // 12 bits per value keep the weighted sums of 255 pixels within 32 bits
+    uint32_t sum[OUTPUT_STAGE_MAX_CHANNELS] = {0};
+    for (uint8_t i = 0; i < pixels; i++) {
+        for (uint8_t c = 0; c < stage->channels; c++) {
+            sum[c] += output_stage_gamma(*frame++) >> 4;
+        }
+    }
+
+    // channels at full drive, times 4095
+    uint32_t load = 0;
+    for (uint8_t c = 0; c < stage->channels; c++) {
+        load += (sum[c] * ((uint32_t)stage->white_balance[c] + 1)) >> 8;
+    }
+    uint32_t current = load * stage->channel_current / 4095;
+    stage->current   = current < UINT16_MAX ? current : UINT16_MAX;
+
+    uint16_t scale = UINT16_MAX;
+    if (stage->current_limit && current > stage->current_limit) {
+        scale = ((uint32_t)stage->current_limit << 16) / current;
+    }
+    output_stage_set_gains(stage, scale);
+}
+
+void output_stage_render(const output_stage_t *stage, const uint8_t *frame, uint8_t *out, uint8_t *residual, uint8_t pixels) {
+    if (residual) {
+        for (uint8_t i = 0; i < pixels; i++) {
+            for (uint8_t c = 0; c < stage->channels; c++) {
+                *out++ = output_stage_dither(stage, c, *frame++, residual++);
+            }
+        }
+    } else {
+        for (uint8_t i = 0; i < pixels; i++) {
+            for (uint8_t c = 0; c < stage->channels; c++) {
+                *out++ = output_stage_apply(stage, c, *frame++);
+            }
+        }
+    }
+}
+
+void output_stage_seed_dither(uint8_t *residual, uint16_t count) {
+    // steps of 256 / golden ratio spread the residuals evenly, so neighbouring
+    // LEDs at the same level do not step up on the same frame
+    for (uint16_t i = 0; i < count; i++) {
+        residual[i] = i * 159;
+    }
+}
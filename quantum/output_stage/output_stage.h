@@ -0,0 +1,85 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+
+/* Final correction of a frame before it is sent to the LED driver.
+ *
+ * Frames are stored as 8 bit channel values, channels interleaved per pixel.
+ * On the way out every value goes through
+ *   gamma          CIE 1931 lightness to 16 bit linear light
+ *   white balance  a gain per channel, 255 leaves the channel as it is
+ *   current limit  one gain for the whole frame that keeps the estimated
+ *                  LED current under the configured budget
+ * and is narrowed back to 8 bits. output_stage_prepare() estimates the
+ * current of a frame and folds the white balance and current limit into
+ * one gain per channel, so the output pass is a table lookup and a multiply
+ * per value.
+ *
+ * Narrowing to 8 bits loses the steps between the lowest driver levels that
+ * slow fades at low brightness go through. output_stage_dither() keeps the
+ * part below 8 bits of every value in a residual byte and adds it to the
+ * next frame, so over successive frames the output averages to the 16 bit
+ * value.
+ */
+
+#define OUTPUT_STAGE_MAX_CHANNELS 4
+
+typedef struct {
+    uint8_t  channels;
+    uint8_t  white_balance[OUTPUT_STAGE_MAX_CHANNELS];
+    uint8_t  channel_current; // mA one channel draws at full drive
+    uint16_t current_limit;   // mA the whole frame may draw, 0 for no limit
+    uint16_t current;         // mA the last prepared frame would draw without the limit
+    uint16_t gain[OUTPUT_STAGE_MAX_CHANNELS];
+    uint16_t dither_gain[OUTPUT_STAGE_MAX_CHANNELS]; // gain scaled to give 8.8 fixed point output
+} output_stage_t;
+
+extern const uint16_t OUTPUT_STAGE_GAMMA[256] PROGMEM;
+
+void output_stage_init(output_stage_t *stage, uint8_t channels, const uint8_t *white_balance, uint8_t channel_current, uint16_t current_limit);
+void output_stage_prepare(output_stage_t *stage, const uint8_t *frame, uint8_t pixels);
+void output_stage_render(const output_stage_t *stage, const uint8_t *frame, uint8_t *out, uint8_t *residual, uint8_t pixels);
+void output_stage_seed_dither(uint8_t *residual, uint16_t count);
+
+// Linear light of a value, 0 to 65535
+static inline uint16_t output_stage_gamma(uint8_t value) {
+    return pgm_read_word(&OUTPUT_STAGE_GAMMA[value]);
+}
+
+// Linear light of a value after gamma and the gain of its channel, 0 to 65535
+static inline uint16_t output_stage_linear(const output_stage_t *stage, uint8_t channel, uint8_t value) {
+    return ((uint32_t)output_stage_gamma(value) * ((uint32_t)stage->gain[channel] + 1)) >> 16;
+}
+
+// output_stage_linear() rounded to the 8 bits the drivers take
+static inline uint8_t output_stage_apply(const output_stage_t *stage, uint8_t channel, uint8_t value) {
+    // linear * 255 / 65535 rounded, the divide done as a multiply by 65537 / 2^32
+    uint32_t scaled = (uint32_t)output_stage_linear(stage, channel, value) * 255 + 0x7FFF;
+    return (scaled + (scaled >> 16)) >> 16;
+}
+
+// output_stage_apply() with the part below 8 bits carried to the next frame in *residual
+static inline uint8_t output_stage_dither(const output_stage_t *stage, uint8_t channel, uint8_t value, uint8_t *residual) {
+    uint16_t target = ((uint32_t)output_stage_gamma(value) * stage->dither_gain[channel]) >> 16;
+    uint16_t sum    = target + *residual;
+    *residual       = sum & 0xFF;
+    return sum >> 8;
+}
@@ -0,0 +1,187 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <string.h>
+
+extern "C" {
+#include "output_stage.h"
+}
+
+// Floating point reference for the CIE 1931 curve, 0 to 1
+static double reference_gamma(uint8_t value) {
+    double l = value * 100.0 / 255.0;
+    return l <= 8.0 ? l / 902.3 : pow((l + 16.0) / 116.0, 3.0);
+}
+
+// Floating point reference for a whole frame
+static void reference_render(const uint8_t *frame, uint8_t *out, uint8_t pixels, const uint8_t *white_balance, double channel_current, double current_limit) {
+    double current = 0;
+    for (int i = 0; i < pixels * 3; i++) {
+        current += reference_gamma(frame[i]) * white_balance[i % 3] / 255.0 * channel_current;
+    }
+    double scale = current_limit > 0 && current > current_limit ? current_limit / current : 1.0;
+    for (int i = 0; i < pixels * 3; i++) {
+        out[i] = lround(reference_gamma(frame[i]) * white_balance[i % 3] / 255.0 * scale * 255.0);
+    }
+}
+
+class OutputStageTest : public ::testing::Test {
+   protected:
+    output_stage_t stage;
+    uint8_t        frame[30];
+    uint8_t        out[30];
+};
+
+TEST_F(OutputStageTest, GammaTableMatchesReference) {
+    EXPECT_EQ(output_stage_gamma(0), 0);
+    EXPECT_EQ(output_stage_gamma(255), 65535);
+    for (int v = 0; v < 256; v++) {
+        EXPECT_NEAR(output_stage_gamma(v), reference_gamma(v) * 65535, 1) << "value " << v;
+        if (v) {
+            EXPECT_GT(output_stage_gamma(v), output_stage_gamma(v - 1)) << "value " << v;
+        }
+    }
+}
+
+TEST_F(OutputStageTest, DefaultsOnlyApplyGamma) {
+    output_stage_init(&stage, 3, NULL, 20, 0);
+    for (int v = 0; v < 256; v++) {
+        EXPECT_NEAR(output_stage_apply(&stage, v % 3, v), reference_gamma(v) * 255, 0.5 + 1e-9) << "value " << v;
+    }
+    EXPECT_EQ(output_stage_apply(&stage, 0, 255), 255);
+    EXPECT_EQ(output_stage_linear(&stage, 0, 255), 65535);
+}
+
+TEST_F(OutputStageTest, WhiteBalanceScalesEachChannel) {
+    const uint8_t white_balance[3] = {255, 128, 0};
+    output_stage_init(&stage, 3, white_balance, 20, 0);
+    EXPECT_EQ(output_stage_apply(&stage, 0, 255), 255);
+    EXPECT_EQ(output_stage_apply(&stage, 1, 255), 128);
+    EXPECT_EQ(output_stage_apply(&stage, 2, 255), 0);
+}
+
+TEST_F(OutputStageTest, EstimatesCurrentOfWhiteBalancedFrame) {
+    const uint8_t white_balance[3] = {255, 255, 0};
+    output_stage_init(&stage, 3, white_balance, 20, 0);
+    memset(frame, 255, sizeof(frame));
+    output_stage_prepare(&stage, frame, 10);
+    // 10 LEDs with two channels at full drive
+    EXPECT_EQ(stage.current, 400);
+
+    memset(frame, 0, sizeof(frame));
+    output_stage_prepare(&stage, frame, 10);
+    EXPECT_EQ(stage.current, 0);
+}
+
+TEST_F(OutputStageTest, FrameUnderBudgetIsNotScaled) {
+    output_stage_init(&stage, 3, NULL, 20, 1000);
+    memset(frame, 255, sizeof(frame));
+    output_stage_prepare(&stage, frame, 10);
+    EXPECT_EQ(stage.current, 600);
+    EXPECT_EQ(output_stage_apply(&stage, 0, 255), 255);
+}
+
+TEST_F(OutputStageTest, FrameOverBudgetIsScaledToBudget) {
+    output_stage_init(&stage, 3, NULL, 20, 300);
+    memset(frame, 255, sizeof(frame));
+    output_stage_prepare(&stage, frame, 10);
+    EXPECT_EQ(stage.current, 600);
+    EXPECT_EQ(output_stage_apply(&stage, 0, 255), 128);
+
+    double current = 0;
+    for (int i = 0; i < 30; i++) {
+        current += output_stage_linear(&stage, i % 3, frame[i]) / 65535.0 * 20;
+    }
+    EXPECT_NEAR(current, 300, 0.1);
+}
+
+TEST_F(OutputStageTest, RenderMatchesReference) {
+    const uint8_t white_balance[3] = {255, 200, 180};
+    uint8_t       expected[30];
+    for (uint16_t limit : {0, 100, 250}) {
+        for (int i = 0; i < 30; i++) {
+            frame[i] = (i * 37 + limit) & 0xFF;
+        }
+        output_stage_init(&stage, 3, white_balance, 20, limit);
+        output_stage_prepare(&stage, frame, 10);
+        output_stage_render(&stage, frame, out, NULL, 10);
+        reference_render(frame, expected, 10, white_balance, 20, limit);
+        for (int i = 0; i < 30; i++) {
+            EXPECT_NEAR(out[i], expected[i], 1) << "limit " << limit << " value " << i;
+        }
+    }
+}
+
+TEST_F(OutputStageTest, DitherAveragesToTarget) {
+    const uint8_t white_balance[3] = {255, 200, 90};
+    output_stage_init(&stage, 3, white_balance, 20, 0);
+    for (int v = 0; v < 256; v++) {
+        for (uint8_t c = 0; c < 3; c++) {
+            uint8_t  residual = 0;
+            uint32_t sum      = 0;
+            for (int frame = 0; frame < 256; frame++) {
+                sum += output_stage_dither(&stage, c, v, &residual);
+            }
+            double target = reference_gamma(v) * white_balance[c] / 255.0 * 255.0;
+            EXPECT_NEAR(sum / 256.0, target, 1.0 / 256 + 0.005) << "value " << v << " channel " << c;
+        }
+    }
+}
+
+TEST_F(OutputStageTest, DitherConvergesWithinFewFrames) {
+    output_stage_init(&stage, 1, NULL, 20, 0);
+    // the lowest levels of a slow fade, between the first two driver levels
+    for (int v = 1; v < 40; v++) {
+        uint8_t  residual = 0;
+        uint32_t sum      = 0;
+        for (int frame = 0; frame < 16; frame++) {
+            sum += output_stage_dither(&stage, 0, v, &residual);
+        }
+        EXPECT_NEAR(sum / 16.0, reference_gamma(v) * 255.0, 1.0 / 16 + 0.005) << "value " << v;
+    }
+}
+
+TEST_F(OutputStageTest, DitheredRenderFollowsCurrentLimit) {
+    uint8_t residual[30];
+    output_stage_seed_dither(residual, sizeof(residual));
+    output_stage_init(&stage, 3, NULL, 20, 300);
+    memset(frame, 255, sizeof(frame));
+    output_stage_prepare(&stage, frame, 10);
+
+    uint32_t sum[30] = {0};
+    for (int n = 0; n < 256; n++) {
+        output_stage_render(&stage, frame, out, residual, 10);
+        for (int i = 0; i < 30; i++) {
+            sum[i] += out[i];
+        }
+    }
+    for (int i = 0; i < 30; i++) {
+        EXPECT_NEAR(sum[i] / 256.0, 127.5, 1.0 / 256 + 0.01) << "value " << i;
+    }
+}
+
+TEST_F(OutputStageTest, SeededResidualsAreSpread) {
+    uint8_t residual[8];
+    output_stage_seed_dither(residual, sizeof(residual));
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < i; j++) {
+            EXPECT_GE(abs(residual[i] - residual[j]), 16) << i << " and " << j;
+        }
+    }
+}
@@ -0,0 +1,7 @@
+output_stage_SRC := \
+	$(QUANTUM_PATH)/output_stage/tests/output_stage_tests.cpp \
+	$(QUANTUM_PATH)/output_stage/output_stage.c
+
+output_stage_INC := \
+	$(QUANTUM_PATH)/output_stage \
+	$(PLATFORM_PATH)
@@ -0,0 +1 @@
+TEST_LIST += output_stage
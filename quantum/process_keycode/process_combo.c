@@ -140,12 +140,7 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 static inline void release_combo(uint16_t combo_index, combo_t *combo) {
     if (combo->keycode) {
         keyrecord_t record = {
-            .event =
-                {
-                    .key     = COMBO_KEY_POS,
-                    .time    = timer_read() | 1,
-                    .pressed = false,
-                },
+            .event   = make_keyevent(COMBO_KEY_POS, false),
             .keycode = combo->keycode,
         };
 #ifndef NO_ACTION_TAPPING
@@ -45,103 +45,509 @@ __attribute__((weak)) void dynamic_macro_record_end_user(int8_t direction) {
     dynamic_macro_led_blink();
 }
 
-/* Convenience macros used for retrieving the debug info. All of them
- * need a `direction` variable accessible at the call site.
+/* Recorded events are stored in a compact, variable length encoding
+ * instead of as whole keyrecord_t structs. Every event starts with a
+ * tag byte:
+ *
+ *   7        6     5          4..3       2..0
+ * +--------+-----+----------+----------+-----------+
+ * | pressed | tap | delay ext | key form | delay low |
+ * +--------+-----+----------+----------+-----------+
+ *
+ * followed by the rest of the delay since the previous event (a varint
+ * of `delay >> 3`, only if "delay ext" is set), the key and finally the
+ * raw tap state byte (only if "tap" is set). The key is one of:
+ *
+ * - a varint of `row * MATRIX_COLS + col` for keys within the matrix,
+ * - the raw row and column bytes for positions outside of it,
+ * - a varint keycode followed by the raw row and column bytes for
+ *   records that carry their own keycode (combos).
+ *
+ * A typical key event therefore takes 2 or 3 bytes.
+ */
+#define DYNAMIC_MACRO_EVENT_PRESSED 0x80
+#define DYNAMIC_MACRO_EVENT_TAP 0x40
+#define DYNAMIC_MACRO_EVENT_DELAY_EXT 0x20
+#define DYNAMIC_MACRO_EVENT_KEY_MASK 0x18
+#define DYNAMIC_MACRO_EVENT_KEY_INDEX 0x00
+#define DYNAMIC_MACRO_EVENT_KEY_RAW 0x08
+#define DYNAMIC_MACRO_EVENT_KEY_KEYCODE 0x10
+#define DYNAMIC_MACRO_EVENT_DELAY_MASK 0x07
+#define DYNAMIC_MACRO_EVENT_DELAY_BITS 3
+
+/* tag + delay (2) + keycode (3) + row + col + tap */
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 9
+
+/* Both macros use the same buffer but read/write on different ends of
+ * it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of the
+ * buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the buffer,
+ * so its byte stream appears reversed in memory.
+ *
+ *  macro_buffer
+ *  v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *  <-macro_length[0]->       <-------- macro_length[1] ------->
+ *
+ * During the recording when one macro encounters the end of the other
+ * macro, the recording is stopped. Apart from this, there are no
+ * arbitrary limits for the macros' length in relation to each other:
+ * for example one can either have two medium sized macros or one long
+ * macro and one short macro. Or even one empty and one using the whole
+ * buffer.
+ */
+static uint8_t macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE];
+
+/* Number of bytes used by each macro. */
+static uint16_t macro_length[2];
+
+/* 0   - no macro is being recorded right now
+ * 1,2 - either macro 1 or 2 is being recorded */
+static uint8_t macro_id = 0;
+
+/* The number of bytes recorded so far and the time of the last recorded
+ * event. */
+static uint16_t macro_pointer   = 0;
+static uint16_t macro_last_time = 0;
+
+/* Macros being played back. A macro may play the other one, so there
+ * can be at most two of them. */
+typedef struct {
+    uint8_t       macro_id;
+    uint16_t      offset;
+    uint16_t      last_time;
+    layer_state_t saved_layer_state;
+} dynamic_macro_playback_t;
+
+static dynamic_macro_playback_t playback[2];
+static uint8_t                  playback_depth = 0;
+
+#define DYNAMIC_MACRO_DIRECTION(ID) ((ID) == 1 ? +1 : -1)
+#define DYNAMIC_MACRO_CAPACITY(ID) (DYNAMIC_MACRO_BUFFER_SIZE - macro_length[2 - (ID)])
+
+static inline uint8_t *dynamic_macro_byte(uint8_t id, uint16_t offset) {
+    return id == 1 ? &macro_buffer[offset] : &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - 1 - offset];
+}
+
+static inline uint8_t dynamic_macro_read_byte(uint8_t id, uint16_t offset) {
+    return offset < DYNAMIC_MACRO_BUFFER_SIZE ? *dynamic_macro_byte(id, offset) : 0;
+}
+
+static uint8_t dynamic_macro_put_varint(uint8_t *out, uint16_t value) {
+    uint8_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[length++] = value;
+    return length;
+}
+
+static uint16_t dynamic_macro_get_varint(uint8_t id, uint16_t *offset) {
+    uint16_t value = 0;
+    for (uint8_t shift = 0; shift < 16; shift += 7) {
+        uint8_t byte = dynamic_macro_read_byte(id, (*offset)++);
+        value |= (uint16_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+/**
+ * Encode a single event.
+ *
+ * @param[out] out    At least DYNAMIC_MACRO_EVENT_MAX_SIZE bytes.
+ * @param[in]  record The event to encode.
+ * @param[in]  delay  Milliseconds since the previous event.
+ * @return The number of bytes used.
+ */
+static uint8_t dynamic_macro_encode(uint8_t *out, keyrecord_t *record, uint16_t delay) {
+    keypos_t key    = record->event.key;
+    uint8_t  length = 1;
+
+    out[0] = (record->event.pressed ? DYNAMIC_MACRO_EVENT_PRESSED : 0) | (delay & DYNAMIC_MACRO_EVENT_DELAY_MASK);
+    if (delay >> DYNAMIC_MACRO_EVENT_DELAY_BITS) {
+        out[0] |= DYNAMIC_MACRO_EVENT_DELAY_EXT;
+        length += dynamic_macro_put_varint(&out[length], delay >> DYNAMIC_MACRO_EVENT_DELAY_BITS);
+    }
+
+#ifdef COMBO_ENABLE
+    if (record->keycode) {
+        out[0] |= DYNAMIC_MACRO_EVENT_KEY_KEYCODE;
+        length += dynamic_macro_put_varint(&out[length], record->keycode);
+        out[length++] = key.row;
+        out[length++] = key.col;
+    } else
+#endif
+        if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        out[0] |= DYNAMIC_MACRO_EVENT_KEY_INDEX;
+        length += dynamic_macro_put_varint(&out[length], key.row * MATRIX_COLS + key.col);
+    } else {
+        out[0] |= DYNAMIC_MACRO_EVENT_KEY_RAW;
+        out[length++] = key.row;
+        out[length++] = key.col;
+    }
+
+#ifndef NO_ACTION_TAPPING
+    if (record->tap.count || record->tap.interrupted) {
+        out[0] |= DYNAMIC_MACRO_EVENT_TAP;
+        out[length++] = record->tap.count | (record->tap.interrupted << 4);
+    }
+#endif
+
+    return length;
+}
+
+/**
+ * Decode the event at a given offset of a macro.
+ *
+ * @param[in]     id     The macro to read, 1 or 2.
+ * @param[in,out] offset The offset of the event, advanced past it.
+ * @param[out]    record The decoded event, without a timestamp.
+ * @param[out]    delay  Milliseconds since the previous event.
+ */
+static void dynamic_macro_decode(uint8_t id, uint16_t *offset, keyrecord_t *record, uint16_t *delay) {
+    uint8_t tag = dynamic_macro_read_byte(id, (*offset)++);
+
+    *record               = (keyrecord_t){0};
+    record->event.pressed = tag & DYNAMIC_MACRO_EVENT_PRESSED;
+
+    *delay = tag & DYNAMIC_MACRO_EVENT_DELAY_MASK;
+    if (tag & DYNAMIC_MACRO_EVENT_DELAY_EXT) {
+        *delay |= dynamic_macro_get_varint(id, offset) << DYNAMIC_MACRO_EVENT_DELAY_BITS;
+    }
+
+    switch (tag & DYNAMIC_MACRO_EVENT_KEY_MASK) {
+        case DYNAMIC_MACRO_EVENT_KEY_INDEX: {
+            uint16_t index       = dynamic_macro_get_varint(id, offset);
+            record->event.key.row = index / MATRIX_COLS;
+            record->event.key.col = index % MATRIX_COLS;
+            break;
+        }
+        case DYNAMIC_MACRO_EVENT_KEY_KEYCODE:
+#ifdef COMBO_ENABLE
+            record->keycode = dynamic_macro_get_varint(id, offset);
+#else
+            dynamic_macro_get_varint(id, offset);
+#endif
+            // fall through
+        default:
+            record->event.key.row = dynamic_macro_read_byte(id, (*offset)++);
+            record->event.key.col = dynamic_macro_read_byte(id, (*offset)++);
+            break;
+    }
+
+    if (tag & DYNAMIC_MACRO_EVENT_TAP) {
+        uint8_t tap = dynamic_macro_read_byte(id, (*offset)++);
+#ifndef NO_ACTION_TAPPING
+        record->tap.count       = tap & 0x0F;
+        record->tap.interrupted = (tap >> 4) & 1;
+#else
+        (void)tap;
+#endif
+    }
+}
+
+#ifdef DYNAMIC_MACRO_PERSIST
+/* The storage holds a header followed by a copy of the macro buffer in
+ * which only the used parts of both macros are valid. The key indices
+ * depend on the matrix width, hence it is part of the magic number.
+ */
+#    define DYNAMIC_MACRO_STORAGE_MAGIC (uint16_t)(0xD300 | (MATRIX_COLS & 0xFF))
+
+typedef struct {
+    uint16_t magic;
+    uint16_t size;
+    uint16_t length[2];
+} dynamic_macro_storage_header_t;
+
+#    define DYNAMIC_MACRO_STORAGE_SIZE (sizeof(dynamic_macro_storage_header_t) + DYNAMIC_MACRO_BUFFER_SIZE)
+
+#    if defined(FLASH_DRIVER) && defined(DYNAMIC_MACRO_FLASH_ADDR)
+#        include "flash_spi.h"
+
+static void dynamic_macro_storage_init(void) {
+    flash_init();
+}
+
+static void dynamic_macro_storage_read(uint32_t offset, void *data, size_t length) {
+    flash_read_block(DYNAMIC_MACRO_FLASH_ADDR + offset, data, length);
+}
+
+static void dynamic_macro_storage_write(uint32_t offset, const void *data, size_t length) {
+    flash_write_block(DYNAMIC_MACRO_FLASH_ADDR + offset, data, length);
+}
+
+/* Flash has to be erased before it can be written to, which also takes
+ * care of invalidating the header until the new one is written. */
+static void dynamic_macro_storage_begin(void) {
+    for (uint32_t addr = DYNAMIC_MACRO_FLASH_ADDR; addr < DYNAMIC_MACRO_FLASH_ADDR + DYNAMIC_MACRO_STORAGE_SIZE; addr += EXTERNAL_FLASH_SECTOR_SIZE) {
+        flash_erase_sector(addr);
+    }
+}
+#    else
+#        include "eeprom.h"
+
+#        ifndef DYNAMIC_MACRO_EEPROM_ADDR
+#            ifdef DYNAMIC_KEYMAP_ENABLE
+#                error DYNAMIC_MACRO_EEPROM_ADDR must be defined to a free EEPROM range when dynamic keymaps are enabled
+#            endif
+#            define DYNAMIC_MACRO_EEPROM_ADDR (EECONFIG_SIZE)
+#        endif
+
+_Static_assert(DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_STORAGE_SIZE <= TOTAL_EEPROM_BYTE_COUNT, "Dynamic macros do not fit into the EEPROM, reduce DYNAMIC_MACRO_BUFFER_SIZE");
+
+static void dynamic_macro_storage_init(void) {}
+
+static void dynamic_macro_storage_read(uint32_t offset, void *data, size_t length) {
+    eeprom_read_block(data, (const uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR) + offset, length);
+}
+
+static void dynamic_macro_storage_write(uint32_t offset, const void *data, size_t length) {
+    eeprom_update_block(data, (uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR) + offset, length);
+}
+
+/* Invalidate the header first so that an interrupted save is never
+ * loaded. */
+static void dynamic_macro_storage_begin(void) {
+    dynamic_macro_storage_header_t header = {0};
+    dynamic_macro_storage_write(0, &header, sizeof(header));
+}
+#    endif
+
+static void dynamic_macro_save(void) {
+    dynamic_macro_storage_header_t header = {
+        .magic  = DYNAMIC_MACRO_STORAGE_MAGIC,
+        .size   = DYNAMIC_MACRO_BUFFER_SIZE,
+        .length = {macro_length[0], macro_length[1]},
+    };
+
+    dynamic_macro_storage_begin();
+    dynamic_macro_storage_write(sizeof(header), macro_buffer, macro_length[0]);
+    dynamic_macro_storage_write(sizeof(header) + DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1], &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1]], macro_length[1]);
+    dynamic_macro_storage_write(0, &header, sizeof(header));
+}
+
+static void dynamic_macro_load(void) {
+    dynamic_macro_storage_header_t header;
+
+    dynamic_macro_storage_init();
+    dynamic_macro_storage_read(0, &header, sizeof(header));
+    if (header.magic != DYNAMIC_MACRO_STORAGE_MAGIC || header.size != DYNAMIC_MACRO_BUFFER_SIZE || header.length[0] > DYNAMIC_MACRO_BUFFER_SIZE || header.length[1] > DYNAMIC_MACRO_BUFFER_SIZE - header.length[0]) {
+        dprintln("dynamic macro: no saved macros");
+        return;
+    }
+
+    macro_length[0] = header.length[0];
+    macro_length[1] = header.length[1];
+    dynamic_macro_storage_read(sizeof(header), macro_buffer, macro_length[0]);
+    dynamic_macro_storage_read(sizeof(header) + DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1], &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1]], macro_length[1]);
+
+    dprintf("dynamic macro: loaded, lengths: %d, %d\n", macro_length[0], macro_length[1]);
+}
+#endif
+
+/**
+ * Initialize the dynamic macros, loading them from the storage if they
+ * are persisted.
  */
-#define DYNAMIC_MACRO_CURRENT_SLOT() (direction > 0 ? 1 : 2)
-#define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
-#define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
+void dynamic_macro_init(void) {
+    macro_length[0] = 0;
+    macro_length[1] = 0;
+    macro_id        = 0;
+    playback_depth  = 0;
+#ifdef DYNAMIC_MACRO_PERSIST
+    dynamic_macro_load();
+#endif
+}
+
+/**
+ * Stop all macro playback, restoring the layer state from before it
+ * started.
+ */
+void dynamic_macro_stop(void) {
+    if (playback_depth == 0) {
+        return;
+    }
+
+    dprintln("dynamic macro: playback stopped");
+
+    clear_keyboard();
+    layer_state_set(playback[0].saved_layer_state);
+    playback_depth = 0;
+}
 
 /**
  * Start recording of the dynamic macro.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @param[in] id The macro to record, 1 or 2.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer) {
+void dynamic_macro_record_start(uint8_t id) {
     dprintln("dynamic macro recording: started");
 
+    dynamic_macro_stop();
+
     dynamic_macro_record_start_user();
 
     clear_keyboard();
     layer_clear();
-    *macro_pointer = macro_buffer;
+    macro_id      = id;
+    macro_pointer = 0;
 }
 
 /**
- * Play the dynamic macro.
+ * Start playing the dynamic macro. The events are replayed by
+ * dynamic_macro_task() with the same timing they were recorded with.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @param[in] id The macro to play, 1 or 2.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
-    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+void dynamic_macro_play(uint8_t id) {
+    /* A macro can't be played while it is being recorded or from
+     * within itself. */
+    bool busy = id == macro_id;
+    for (uint8_t i = 0; i < playback_depth; i++) {
+        busy |= playback[i].macro_id == id;
+    }
+    if (busy) {
+        dprintf("dynamic macro: slot %d is busy, ignoring playback\n", id);
+        return;
+    }
 
-    layer_state_t saved_layer_state = layer_state;
+    dprintf("dynamic macro: slot %d playback\n", id);
+
+    playback[playback_depth++] = (dynamic_macro_playback_t){
+        .macro_id          = id,
+        .offset            = 0,
+        .last_time         = timer_read(),
+        .saved_layer_state = layer_state,
+    };
 
     clear_keyboard();
     layer_clear();
+}
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
-    }
+/**
+ * Finish the innermost macro playback.
+ */
+static void dynamic_macro_play_end(void) {
+    dynamic_macro_playback_t *current = &playback[--playback_depth];
 
     clear_keyboard();
 
-    layer_state_set(saved_layer_state);
+    layer_state_set(current->saved_layer_state);
+
+    dynamic_macro_play_user(DYNAMIC_MACRO_DIRECTION(current->macro_id));
+
+    /* Delays of the outer macro continue from here. */
+    if (playback_depth > 0) {
+        playback[playback_depth - 1].last_time = timer_read();
+    }
+}
+
+/**
+ * Replay the events of the macros being played whose time has come.
+ * Called from keyboard_task().
+ */
+void dynamic_macro_task(void) {
+    while (playback_depth > 0) {
+        dynamic_macro_playback_t *current = &playback[playback_depth - 1];
+
+        if (current->offset >= macro_length[current->macro_id - 1]) {
+            dynamic_macro_play_end();
+            continue;
+        }
 
-    dynamic_macro_play_user(direction);
+        keyrecord_t record;
+        uint16_t    delay;
+        uint16_t    offset = current->offset;
+        dynamic_macro_decode(current->macro_id, &offset, &record, &delay);
+        if (timer_elapsed(current->last_time) < delay) {
+            return;
+        }
+
+        current->last_time += delay;
+        current->offset = offset;
+
+        record.event.time = timer_read() | 1;
+        process_record(&record);
+    }
 }
 
 /**
  * Record a single key in a dynamic macro.
  *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
- * @param record[in]     The current keypress.
+ * @param[in] record The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+void dynamic_macro_record_key(keyrecord_t *record) {
+    int8_t direction = DYNAMIC_MACRO_DIRECTION(macro_id);
+
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && macro_pointer == 0) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
+    uint8_t  event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint16_t delay  = macro_pointer == 0 ? 0 : TIMER_DIFF_16(record->event.time, macro_last_time);
+    uint8_t  length = dynamic_macro_encode(event, record, delay);
+
     /* The other end of the other macro is the last buffer element it
      * is safe to use before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (macro_pointer + length <= DYNAMIC_MACRO_CAPACITY(macro_id)) {
+        for (uint8_t i = 0; i < length; i++) {
+            *dynamic_macro_byte(macro_id, macro_pointer++) = event[i];
+        }
+        macro_last_time = record->event.time;
     } else {
         dynamic_macro_record_key_user(direction, record);
     }
 
-    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+    dprintf("dynamic macro: slot %d length: %d/%d\n", macro_id, macro_pointer, DYNAMIC_MACRO_CAPACITY(macro_id));
 }
 
 /**
  * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * length of the macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
+void dynamic_macro_record_end(void) {
+    int8_t   direction = DYNAMIC_MACRO_DIRECTION(macro_id);
+    uint16_t length    = 0;
+
     dynamic_macro_record_end_user(direction);
 
     /* Do not save the keys being held when stopping the recording,
-     * i.e. the keys used to access the layer DYN_REC_STOP is on.
+     * i.e. the keys used to access the layer DYN_REC_STOP is on. The
+     * encoding can only be walked forwards, so keep everything up to
+     * the last key-up event.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    for (uint16_t offset = 0; offset < macro_pointer;) {
+        keyrecord_t record;
+        uint16_t    delay;
+        dynamic_macro_decode(macro_id, &offset, &record, &delay);
+        if (!record.event.pressed) {
+            length = offset;
+        }
     }
+    if (length != macro_pointer) {
+        dprintln("dynamic macro: trimming trailing key-down events");
+    }
+
+    dprintf("dynamic macro: slot %d saved, length: %d\n", macro_id, length);
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+    macro_length[macro_id - 1] = length;
+    macro_id                   = 0;
 
-    *macro_end = macro_pointer;
+#ifdef DYNAMIC_MACRO_PERSIST
+    dynamic_macro_save();
+#endif
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -155,69 +561,24 @@ void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_poin
  *   }
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
-    /* Both macros use the same buffer but read/write on different
-     * ends of it.
-     *
-     * Macro1 is written left-to-right starting from the beginning of
-     * the buffer.
-     *
-     * Macro2 is written right-to-left starting from the end of the
-     * buffer.
-     *
-     * &macro_buffer   macro_end
-     *  v                   v
-     * +------------------------------------------------------------+
-     * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
-     * +------------------------------------------------------------+
-     *                           ^                                 ^
-     *                         r_macro_end                  r_macro_buffer
-     *
-     * During the recording when one macro encounters the end of the
-     * other macro, the recording is stopped. Apart from this, there
-     * are no arbitrary limits for the macros' length in relation to
-     * each other: for example one can either have two medium sized
-     * macros or one long macro and one short macro. Or even one empty
-     * and one using the whole buffer.
-     */
-    static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-    /* Pointer to the first buffer element after the first macro.
-     * Initially points to the very beginning of the buffer since the
-     * macro is empty. */
-    static keyrecord_t *macro_end = macro_buffer;
-
-    /* The other end of the macro buffer. Serves as the beginning of
-     * the second macro. */
-    static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-    /* Like macro_end but for the second macro. */
-    static keyrecord_t *r_macro_end = r_macro_buffer;
-
-    /* A persistent pointer to the current macro position (iterator)
-     * used during the recording. */
-    static keyrecord_t *macro_pointer = NULL;
-
-    /* 0   - no macro is being recorded right now
-     * 1,2 - either macro 1 or 2 is being recorded */
-    static uint8_t macro_id = 0;
-
     if (macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
             switch (keycode) {
                 case DYN_REC_START1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer);
-                    macro_id = 1;
+                    dynamic_macro_record_start(1);
                     return false;
                 case DYN_REC_START2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
-                    macro_id = 2;
+                    dynamic_macro_record_start(2);
                     return false;
                 case DYN_MACRO_PLAY1:
-                    dynamic_macro_play(macro_buffer, macro_end, +1);
+                    dynamic_macro_play(1);
                     return false;
                 case DYN_MACRO_PLAY2:
-                    dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+                    dynamic_macro_play(2);
+                    return false;
+                case DYN_REC_STOP:
+                    dynamic_macro_stop();
                     return false;
             }
         }
@@ -231,15 +592,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
                 if (record->event.pressed ^ (keycode != DYN_REC_STOP)) { /* Ignore the initial release
                                                                           * just after the recording
                                                                           * starts for DYN_REC_STOP. */
-                    switch (macro_id) {
-                        case 1:
-                            dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
-                            break;
-                        case 2:
-                            dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
-                            break;
-                    }
-                    macro_id = 0;
+                    dynamic_macro_record_end();
                 }
                 return false;
 #ifdef DYNAMIC_MACRO_NO_NESTING
@@ -250,14 +603,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
 #endif
             default:
                 /* Store the key in the macro buffer and process it normally. */
-                switch (macro_id) {
-                    case 1:
-                        dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
-                        break;
-                    case 2:
-                        dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
-                        break;
-                }
+                dynamic_macro_record_key(record);
                 return true;
                 break;
         }
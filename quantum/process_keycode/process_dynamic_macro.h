@@ -33,6 +33,19 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+/* The events are stored in a compact encoding of 2-3 bytes each, so
+ * the buffer reserves the RAM DYNAMIC_MACRO_SIZE whole records would
+ * take and fits several times as many events in it. It may also be
+ * set in bytes directly, which is also the amount of EEPROM/flash used
+ * by DYNAMIC_MACRO_PERSIST.
+ */
+#ifndef DYNAMIC_MACRO_BUFFER_SIZE
+#    define DYNAMIC_MACRO_BUFFER_SIZE (DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t))
+#endif
+
+void dynamic_macro_init(void);
+void dynamic_macro_task(void);
+void dynamic_macro_stop(void);
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
 void dynamic_macro_record_start_user(void);
@@ -0,0 +1,85 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render_scheduler.h"
+
+#define STATS_WINDOW 1000
+
+void render_scheduler_init(render_scheduler_t *scheduler, uint16_t budget, uint8_t default_slice) {
+    *scheduler = (render_scheduler_t){
+        .budget        = budget,
+        .default_slice = default_slice ? default_slice : 1,
+    };
+}
+
+void render_scheduler_reset(render_scheduler_t *scheduler) {
+    scheduler->led_cost = 0;
+}
+
+uint8_t render_scheduler_slice(render_scheduler_t *scheduler, uint8_t remaining) {
+    uint32_t slice = scheduler->default_slice;
+    if (scheduler->budget && scheduler->led_cost) {
+        slice = ((uint32_t)scheduler->budget << 4) / scheduler->led_cost;
+        if (slice == 0) {
+            slice = 1;
+        }
+    }
+    return slice < remaining ? slice : remaining;
+}
+
+void render_scheduler_slice_done(render_scheduler_t *scheduler, uint8_t leds, uint16_t elapsed_us) {
+    if (elapsed_us > scheduler->slice_max) {
+        scheduler->slice_max = elapsed_us;
+    }
+    if (leds == 0) {
+        return;
+    }
+
+    uint32_t cost = ((uint32_t)elapsed_us << 4) / leds;
+    if (cost == 0) {
+        cost = 1;
+    }
+    if (scheduler->led_cost) {
+        // moving average, reacting to a change within a few slices
+        cost = (3 * (uint32_t)scheduler->led_cost + cost) / 4;
+    }
+    scheduler->led_cost = cost < UINT16_MAX ? cost : UINT16_MAX;
+}
+
+void render_scheduler_frame_done(render_scheduler_t *scheduler, uint16_t now) {
+    scheduler->frames++;
+
+    uint16_t elapsed = now - scheduler->window_start;
+    if (elapsed < STATS_WINDOW) {
+        return;
+    }
+    scheduler->stats.fps       = (uint32_t)scheduler->frames * 1000 / elapsed;
+    scheduler->stats.slice_max = scheduler->slice_max;
+    scheduler->stats.led_cost  = scheduler->led_cost;
+    scheduler->frames          = 0;
+    scheduler->slice_max       = 0;
+    scheduler->window_start    = now;
+}
+
+void render_scheduler_yield(render_scheduler_t *scheduler) {
+    scheduler->yield = scheduler->budget != 0;
+}
+
+bool render_scheduler_should_yield(render_scheduler_t *scheduler) {
+    bool yield       = scheduler->yield;
+    scheduler->yield = false;
+    return yield;
+}
@@ -0,0 +1,89 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Splits the rendering of a lighting frame into slices over several main
+ * loop iterations.
+ *
+ * With a budget, the number of LEDs rendered per slice is the budget divided
+ * by the measured cost of an LED, so cheap effects finish a frame in fewer
+ * slices and expensive ones don't hold up the matrix scan. The cost is
+ * relearned whenever the effect changes. Without a budget every slice has
+ * the fixed default size.
+ */
+
+typedef struct {
+    uint16_t fps;       // frames flushed during the last second
+    uint16_t slice_max; // longest slice during the last second, in microseconds
+    uint16_t led_cost;  // average cost of an LED, in 1/16 microseconds
+} render_stats_t;
+
+typedef struct {
+    uint16_t       budget;  // microseconds per slice, 0 for fixed slices
+    uint8_t        default_slice;
+    bool           yield;
+    uint16_t       led_cost;
+    uint16_t       frames;
+    uint16_t       window_start;
+    uint16_t       slice_max;
+    render_stats_t stats;
+} render_scheduler_t;
+
+/**
+ * @brief Initialise a scheduler.
+ *
+ * @param budget microseconds per slice, 0 to always use default_slice
+ * @param default_slice LEDs per slice while the cost is unknown or without a budget
+ */
+void render_scheduler_init(render_scheduler_t *scheduler, uint16_t budget, uint8_t default_slice);
+
+/**
+ * @brief Forget the measured cost, for example when the effect changes.
+ */
+void render_scheduler_reset(render_scheduler_t *scheduler);
+
+/**
+ * @brief Number of LEDs to render in the next slice, at most remaining.
+ */
+uint8_t render_scheduler_slice(render_scheduler_t *scheduler, uint8_t remaining);
+
+/**
+ * @brief Record how long a slice of the given number of LEDs took.
+ */
+void render_scheduler_slice_done(render_scheduler_t *scheduler, uint8_t leds, uint16_t elapsed_us);
+
+/**
+ * @brief Record that a frame was flushed, now being timer_read().
+ */
+void render_scheduler_frame_done(render_scheduler_t *scheduler, uint16_t now);
+
+/**
+ * @brief Ask the next slice to be skipped, for example after a key event.
+ */
+void render_scheduler_yield(render_scheduler_t *scheduler);
+
+/**
+ * @brief Whether to skip rendering this time. Clears a pending yield.
+ */
+bool render_scheduler_should_yield(render_scheduler_t *scheduler);
+
+static inline render_stats_t render_scheduler_stats(const render_scheduler_t *scheduler) {
+    return scheduler->stats;
+}
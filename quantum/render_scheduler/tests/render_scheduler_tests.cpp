@@ -0,0 +1,112 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "render_scheduler.h"
+}
+
+class RenderScheduler : public ::testing::Test {
+   protected:
+    render_scheduler_t scheduler;
+};
+
+TEST_F(RenderScheduler, FixedSlicesWithoutBudget) {
+    render_scheduler_init(&scheduler, 0, 10);
+
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 100), 10);
+    render_scheduler_slice_done(&scheduler, 10, 1000);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 100), 10);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 4), 4);
+}
+
+TEST_F(RenderScheduler, DefaultSliceUntilCostIsKnown) {
+    render_scheduler_init(&scheduler, 500, 10);
+
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 100), 10);
+    // 20us per LED
+    render_scheduler_slice_done(&scheduler, 10, 200);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 100), 25);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 20), 20);
+}
+
+TEST_F(RenderScheduler, SliceFollowsCost) {
+    render_scheduler_init(&scheduler, 500, 10);
+
+    render_scheduler_slice_done(&scheduler, 10, 200);
+    // the effect gets four times more expensive
+    for (int i = 0; i < 20; i++) {
+        uint8_t leds = render_scheduler_slice(&scheduler, 255);
+        render_scheduler_slice_done(&scheduler, leds, leds * 80);
+    }
+    EXPECT_NEAR(render_scheduler_slice(&scheduler, 255), 6, 1);
+
+    render_scheduler_reset(&scheduler);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 255), 10);
+}
+
+TEST_F(RenderScheduler, AlwaysRendersSomething) {
+    render_scheduler_init(&scheduler, 10, 10);
+
+    render_scheduler_slice_done(&scheduler, 1, 1000);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 100), 1);
+}
+
+TEST_F(RenderScheduler, CheapLedsDontLoseTheirCost) {
+    render_scheduler_init(&scheduler, 1000, 10);
+
+    render_scheduler_slice_done(&scheduler, 100, 0);
+    EXPECT_EQ(render_scheduler_slice(&scheduler, 255), 255);
+}
+
+TEST_F(RenderScheduler, YieldOnlyWithBudget) {
+    render_scheduler_init(&scheduler, 0, 10);
+    render_scheduler_yield(&scheduler);
+    EXPECT_FALSE(render_scheduler_should_yield(&scheduler));
+
+    render_scheduler_init(&scheduler, 500, 10);
+    render_scheduler_yield(&scheduler);
+    EXPECT_TRUE(render_scheduler_should_yield(&scheduler));
+    EXPECT_FALSE(render_scheduler_should_yield(&scheduler));
+}
+
+TEST_F(RenderScheduler, StatsCoverTheLastSecond) {
+    render_scheduler_init(&scheduler, 500, 10);
+    render_scheduler_frame_done(&scheduler, 1000);
+
+    uint16_t now = 1000;
+    for (int i = 0; i < 50; i++) {
+        render_scheduler_slice_done(&scheduler, 10, i == 10 ? 900 : 300);
+        now += 20;
+        render_scheduler_frame_done(&scheduler, now);
+    }
+
+    render_stats_t stats = render_scheduler_stats(&scheduler);
+    EXPECT_EQ(stats.fps, 50);
+    EXPECT_EQ(stats.slice_max, 900);
+    EXPECT_GT(stats.led_cost, 0);
+
+    // the next window starts over
+    for (int i = 0; i < 25; i++) {
+        render_scheduler_slice_done(&scheduler, 10, 300);
+        now += 40;
+        render_scheduler_frame_done(&scheduler, now);
+    }
+    stats = render_scheduler_stats(&scheduler);
+    EXPECT_EQ(stats.fps, 25);
+    EXPECT_EQ(stats.slice_max, 300);
+}
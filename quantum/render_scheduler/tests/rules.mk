@@ -0,0 +1,6 @@
+render_scheduler_SRC := \
+	$(QUANTUM_PATH)/render_scheduler/tests/render_scheduler_tests.cpp \
+	$(QUANTUM_PATH)/render_scheduler/render_scheduler.c
+
+render_scheduler_INC := \
+	$(QUANTUM_PATH)/render_scheduler
@@ -20,6 +20,13 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "telemetry.h"
+#if defined(RGB_MATRIX_DITHER) && !defined(RGB_MATRIX_OUTPUT_STAGE)
+#    define RGB_MATRIX_OUTPUT_STAGE
+#endif
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+#    include "output_stage.h"
+#endif
 #include <string.h>
 #include <math.h>
 
@@ -32,7 +39,12 @@ const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+    // the output stage applies the CIE curve to every channel
+    return hsv_to_rgb_nocie(hsv);
+#else
     return hsv_to_rgb(hsv);
+#endif
 }
 
 // Generic effect runners
@@ -110,37 +122,49 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
 #    define RGB_MATRIX_STARTUP_SPD UINT8_MAX / 2
 #endif
 
+#if !defined(RGB_MATRIX_LED_MAP_SIZE)
+#    define RGB_MATRIX_LED_MAP_SIZE DRIVER_LED_TOTAL
+#endif
+
+#if RGB_MATRIX_LED_MAP_SIZE > UINT8_MAX
+#    error RGB_MATRIX_LED_MAP_SIZE must not exceed 255
+#endif
+
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+#    if !defined(RGB_MATRIX_WHITE_BALANCE)
+#        define RGB_MATRIX_WHITE_BALANCE \
+            { 255, 255, 255 }
+#    endif
+#    if !defined(RGB_MATRIX_CHANNEL_CURRENT)
+#        define RGB_MATRIX_CHANNEL_CURRENT 20
+#    endif
+#    if !defined(RGB_MATRIX_CURRENT_LIMIT)
+#        define RGB_MATRIX_CURRENT_LIMIT 0
+#    endif
+#endif // RGB_MATRIX_OUTPUT_STAGE
+
 // globals
 rgb_config_t rgb_matrix_config; // TODO: would like to prefix this with g_ for global consistancy, do this in another pr
 uint32_t     g_rgb_timer;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #endif // RGB_MATRIX_FRAMEBUFFER_EFFECTS
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-last_hit_t g_last_hit_tracker;
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-// internals
-static bool            suspend_state     = false;
-static uint8_t         rgb_last_enable   = UINT8_MAX;
-static uint8_t         rgb_last_effect   = UINT8_MAX;
-static effect_params_t rgb_effect_params = {0, LED_FLAG_ALL, false};
-static rgb_task_states rgb_task_state    = SYNCING;
-#if RGB_DISABLE_TIMEOUT > 0
-static uint32_t rgb_anykey_timer;
-#endif // RGB_DISABLE_TIMEOUT > 0
-
-// double buffers
-static uint32_t rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 // split rgb matrix
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
 
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+// effects draw here, rgb_matrix_update_pwm_buffers() corrects the frame on its way to the driver
+static uint8_t        rgb_matrix_frame[DRIVER_LED_TOTAL][3];
+static output_stage_t rgb_output_stage;
+static const uint8_t  k_rgb_matrix_white_balance[3] = RGB_MATRIX_WHITE_BALANCE;
+#    ifdef RGB_MATRIX_DITHER
+static uint8_t rgb_matrix_dither[DRIVER_LED_TOTAL][3];
+#    endif
+#endif // RGB_MATRIX_OUTPUT_STAGE
+
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, EECONFIG_RGB_MATRIX, rgb_matrix_config);
 
 void eeconfig_update_rgb_matrix(void) {
@@ -178,30 +202,42 @@ void rgb_matrix_reload_from_eeprom(void) {
     }
 }
 
-__attribute__((weak)) uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i) {
-    return 0;
-}
-
-uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
-    uint8_t led_count = rgb_matrix_map_row_column_to_led_kb(row, column, led_i);
-    uint8_t led_index = g_led_config.matrix_co[row][column];
-    if (led_index != NO_LED) {
-        led_i[led_count] = led_index;
-        led_count++;
-    }
-    return led_count;
-}
-
 void rgb_matrix_update_pwm_buffers(void) {
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+    // only this half's LEDs count towards its current budget
+#    if defined(RGB_MATRIX_SPLIT)
+    uint8_t first = is_keyboard_left() ? 0 : k_rgb_matrix_split[0];
+    uint8_t count = is_keyboard_left() ? k_rgb_matrix_split[0] : k_rgb_matrix_split[1];
+#    else
+    uint8_t first = 0;
+    uint8_t count = DRIVER_LED_TOTAL;
+#    endif
+    output_stage_prepare(&rgb_output_stage, rgb_matrix_frame[first], count);
+    for (uint8_t i = first; i < first + count; i++) {
+#    ifdef RGB_MATRIX_DITHER
+        rgb_matrix_driver.set_color(i, output_stage_dither(&rgb_output_stage, 0, rgb_matrix_frame[i][0], &rgb_matrix_dither[i][0]), output_stage_dither(&rgb_output_stage, 1, rgb_matrix_frame[i][1], &rgb_matrix_dither[i][1]), output_stage_dither(&rgb_output_stage, 2, rgb_matrix_frame[i][2], &rgb_matrix_dither[i][2]));
+#    else
+        rgb_matrix_driver.set_color(i, output_stage_apply(&rgb_output_stage, 0, rgb_matrix_frame[i][0]), output_stage_apply(&rgb_output_stage, 1, rgb_matrix_frame[i][1]), output_stage_apply(&rgb_output_stage, 2, rgb_matrix_frame[i][2]));
+#    endif
+    }
+#endif // RGB_MATRIX_OUTPUT_STAGE
     rgb_matrix_driver.flush();
 }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+    // keymap code may pass any index, the drivers ignore ones out of range too
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+    rgb_matrix_frame[index][0] = red;
+    rgb_matrix_frame[index][1] = green;
+    rgb_matrix_frame[index][2] = blue;
+#else
     rgb_matrix_driver.set_color(index, red, green, blue);
+#endif
 }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#if defined(RGB_MATRIX_OUTPUT_STAGE) || (defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT))
     for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++)
         rgb_matrix_set_color(i, red, green, blue);
 #else
@@ -209,52 +245,6 @@ void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
 #endif
 }
 
-void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
-#ifndef RGB_MATRIX_SPLIT
-    if (!is_keyboard_master()) return;
-#endif
-#if RGB_DISABLE_TIMEOUT > 0
-    rgb_anykey_timer = 0;
-#endif // RGB_DISABLE_TIMEOUT > 0
-
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t led[LED_HITS_TO_REMEMBER];
-    uint8_t led_count = 0;
-
-#    if defined(RGB_MATRIX_KEYRELEASES)
-    if (!pressed)
-#    elif defined(RGB_MATRIX_KEYPRESSES)
-    if (pressed)
-#    endif // defined(RGB_MATRIX_KEYRELEASES)
-    {
-        led_count = rgb_matrix_map_row_column_to_led(row, col, led);
-    }
-
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2); // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
-    }
-
-    for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-#if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
-    if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP) {
-        process_rgb_matrix_typing_heatmap(row, col);
-    }
-#endif // defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
-}
-
 void rgb_matrix_test(void) {
     // Mask out bits 4 and 5
     // Increase the factor to make the test animation slower (and reduce to make it faster)
@@ -279,90 +269,20 @@ void rgb_matrix_test(void) {
     }
 }
 
-static bool rgb_matrix_none(effect_params_t *params) {
-    if (!params->init) {
-        return false;
-    }
-
-    rgb_matrix_set_color_all(0, 0, 0);
-    return false;
-}
-
-static void rgb_task_timers(void) {
-#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_DISABLE_TIMEOUT > 0
-    uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
-#endif // defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_DISABLE_TIMEOUT > 0
-    rgb_timer_buffer = sync_timer_read32();
-
-    // Update double buffer timers
-#if RGB_DISABLE_TIMEOUT > 0
-    if (rgb_anykey_timer + deltaTime <= UINT32_MAX) {
-        rgb_anykey_timer += deltaTime;
-    }
-#endif // RGB_DISABLE_TIMEOUT > 0
-
-    // Update double buffer last hit timers
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-}
-
-static void rgb_task_sync(void) {
-    eeconfig_flush_rgb_matrix(false);
-    // next task
-    if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
-}
-
-static void rgb_task_start(void) {
-    // reset iter
-    rgb_effect_params.iter = 0;
-
-    // update double buffers
-    g_rgb_timer = rgb_timer_buffer;
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-    // next task
-    rgb_task_state = RENDERING;
-}
-
-static void rgb_task_render(uint8_t effect) {
-    bool rendering         = false;
-    rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
-    if (rgb_effect_params.flags != rgb_matrix_config.flags) {
-        rgb_effect_params.flags = rgb_matrix_config.flags;
-        rgb_matrix_set_color_all(0, 0, 0);
-    }
-
-    // each effect can opt to do calculations
-    // and/or request PWM buffer updates.
+static bool led_engine_effect(uint8_t effect, effect_params_t *params) {
     switch (effect) {
-        case RGB_MATRIX_NONE:
-            rendering = rgb_matrix_none(&rgb_effect_params);
-            break;
-
 // ---------------------------------------------
 // -----Begin rgb effect switch case macros-----
-#define RGB_MATRIX_EFFECT(name, ...)          \
-    case RGB_MATRIX_##name:                   \
-        rendering = name(&rgb_effect_params); \
-        break;
+#define RGB_MATRIX_EFFECT(name, ...) \
+    case RGB_MATRIX_##name:          \
+        return name(params);
 #include "rgb_matrix_effects.inc"
 #undef RGB_MATRIX_EFFECT
 
 #if defined(RGB_MATRIX_CUSTOM_KB) || defined(RGB_MATRIX_CUSTOM_USER)
-#    define RGB_MATRIX_EFFECT(name, ...)          \
-        case RGB_MATRIX_CUSTOM_##name:            \
-            rendering = name(&rgb_effect_params); \
-            break;
+#    define RGB_MATRIX_EFFECT(name, ...) \
+        case RGB_MATRIX_CUSTOM_##name:   \
+            return name(params);
 #    ifdef RGB_MATRIX_CUSTOM_KB
 #        include "rgb_matrix_kb.inc"
 #    endif
@@ -375,228 +295,72 @@ static void rgb_task_render(uint8_t effect) {
             // ---------------------------------------------
 
         // Factory default magic value
-        case UINT8_MAX: {
+        case UINT8_MAX:
             rgb_matrix_test();
-            rgb_task_state = FLUSHING;
-        }
-            return;
-    }
-
-    rgb_effect_params.iter++;
-
-    // next task
-    if (!rendering) {
-        rgb_task_state = FLUSHING;
-        if (!rgb_effect_params.init && effect == RGB_MATRIX_NONE) {
-            // We only need to flush once if we are RGB_MATRIX_NONE
-            rgb_task_state = SYNCING;
-        }
-    }
-}
-
-static void rgb_task_flush(uint8_t effect) {
-    // update last trackers after the first full render so we can init over several frames
-    rgb_last_effect = effect;
-    rgb_last_enable = rgb_matrix_config.enable;
-
-    // update pwm buffers
-    rgb_matrix_update_pwm_buffers();
-
-    // next task
-    rgb_task_state = SYNCING;
-}
-
-void rgb_matrix_task(void) {
-    rgb_task_timers();
-
-    // Ideally we would also stop sending zeros to the LED driver PWM buffers
-    // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool suspend_backlight = suspend_state ||
-#if RGB_DISABLE_TIMEOUT > 0
-                             (rgb_anykey_timer > (uint32_t)RGB_DISABLE_TIMEOUT) ||
-#endif // RGB_DISABLE_TIMEOUT > 0
-                             false;
-
-    uint8_t effect = suspend_backlight || !rgb_matrix_config.enable ? 0 : rgb_matrix_config.mode;
-
-    switch (rgb_task_state) {
-        case STARTING:
-            rgb_task_start();
-            break;
-        case RENDERING:
-            rgb_task_render(effect);
-            if (effect) {
-                rgb_matrix_indicators();
-                rgb_matrix_indicators_advanced(&rgb_effect_params);
-            }
-            break;
-        case FLUSHING:
-            rgb_task_flush(effect);
-            break;
-        case SYNCING:
-            rgb_task_sync();
             break;
     }
+    return false;
 }
 
-void rgb_matrix_indicators(void) {
-    rgb_matrix_indicators_kb();
-    rgb_matrix_indicators_user();
-}
-
-__attribute__((weak)) void rgb_matrix_indicators_kb(void) {}
-
-__attribute__((weak)) void rgb_matrix_indicators_user(void) {}
-
-void rgb_matrix_indicators_advanced(effect_params_t *params) {
-    /* special handling is needed for "params->iter", since it's already been incremented.
-     * Could move the invocations to rgb_task_render, but then it's missing a few checks
-     * and not sure which would be better. Otherwise, this should be called from
-     * rgb_task_render, right before the iter++ line.
-     */
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
-    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
-    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
-#else
-    uint8_t min = 0;
-    uint8_t max = DRIVER_LED_TOTAL;
-#endif
-    rgb_matrix_indicators_advanced_kb(min, max);
-    rgb_matrix_indicators_advanced_user(min, max);
-}
-
-__attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max) {}
-
-__attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
-
-void rgb_matrix_init(void) {
-    rgb_matrix_driver.init();
-
-#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        g_last_hit_tracker.tick[i] = UINT16_MAX;
-    }
-
-    last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
-#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
-
-    if (!eeconfig_is_enabled()) {
-        dprintf("rgb_matrix_init_drivers eeconfig is not enabled.\n");
-        eeconfig_init();
-        eeconfig_update_rgb_matrix_default();
-    }
-
-    eeconfig_init_rgb_matrix();
-    if (!rgb_matrix_config.mode) {
-        dprintf("rgb_matrix_init_drivers rgb_matrix_config.mode = 0. Write default values to EEPROM.\n");
-        eeconfig_update_rgb_matrix_default();
+static void led_engine_key_event(uint8_t row, uint8_t col, bool pressed) {
+#if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
+    if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP) {
+        process_rgb_matrix_typing_heatmap(row, col);
     }
-    eeconfig_debug_rgb_matrix(); // display current eeprom values
+#endif // defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
 }
 
-void rgb_matrix_set_suspend_state(bool state) {
+#define LED_ENGINE(name) rgb_matrix_##name
+#define LED_ENGINE_PROCESS process_rgb_matrix
+#define LED_ENGINE_NAME "rgb matrix"
+#define LED_ENGINE_PIXEL LED_ENGINE_PIXEL_RGB888
+#define LED_ENGINE_CONFIG rgb_matrix_config
+#define LED_ENGINE_TIMER g_rgb_timer
+#define LED_ENGINE_EECONFIG(op) eeconfig_##op##_rgb_matrix
+#define LED_ENGINE_EECONFIG_DEFAULT eeconfig_update_rgb_matrix_default
+#define LED_ENGINE_EFFECT_MAX RGB_MATRIX_EFFECT_MAX
+#define LED_ENGINE_DISABLE_TIMEOUT RGB_DISABLE_TIMEOUT
+#define LED_ENGINE_LED_MAP_SIZE RGB_MATRIX_LED_MAP_SIZE
+#define LED_ENGINE_FLUSH_LIMIT RGB_MATRIX_LED_FLUSH_LIMIT
+#define LED_ENGINE_PROCESS_LIMIT RGB_MATRIX_LED_PROCESS_LIMIT
+#define LED_ENGINE_RENDER_BUDGET_US RGB_MATRIX_RENDER_BUDGET_US
+#define LED_ENGINE_SPD_STEP RGB_MATRIX_SPD_STEP
+#if defined(RGB_MATRIX_KEYRELEASES)
+#    define LED_ENGINE_KEYRELEASES
+#elif defined(RGB_MATRIX_KEYPRESSES)
+#    define LED_ENGINE_KEYPRESSES
+#endif
+#ifdef RGB_MATRIX_EXTRA_KEY_LEDS
+#    define LED_ENGINE_EXTRA_KEY_LEDS RGB_MATRIX_EXTRA_KEY_LEDS
+#endif
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#    define LED_ENGINE_SPLIT k_rgb_matrix_split
+#endif
+#ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
+#    define LED_ENGINE_FRAMEBUFFER_EFFECTS
+#endif
 #ifdef RGB_DISABLE_WHEN_USB_SUSPENDED
-    if (state && !suspend_state) { // only run if turning off, and only once
-        rgb_task_render(0);        // turn off all LEDs when suspending
-        rgb_task_flush(0);         // and actually flash led state to LEDs
-    }
-    suspend_state = state;
+#    define LED_ENGINE_DISABLE_WHEN_USB_SUSPENDED
 #endif
+#ifdef RGB_MATRIX_OUTPUT_STAGE
+static void rgb_matrix_init_output_stage(void) {
+    output_stage_init(&rgb_output_stage, 3, k_rgb_matrix_white_balance, RGB_MATRIX_CHANNEL_CURRENT, RGB_MATRIX_CURRENT_LIMIT);
+#    ifdef RGB_MATRIX_DITHER
+    output_stage_seed_dither(&rgb_matrix_dither[0][0], sizeof(rgb_matrix_dither));
+#    endif
 }
+#    define LED_ENGINE_INIT() rgb_matrix_init_output_stage()
+#endif
+#define LED_ENGINE_FRAME_START() rgb_frame_start = telemetry_time_start()
+#define LED_ENGINE_FRAME_END()                                    \
+    do {                                                          \
+        telemetry_time_end(TELEMETRY_RGB_FRAME, rgb_frame_start); \
+        telemetry_count(TELEMETRY_RGB_FRAMES);                    \
+    } while (0)
 
-bool rgb_matrix_get_suspend_state(void) {
-    return suspend_state;
-}
-
-void rgb_matrix_toggle_eeprom_helper(bool write_to_eeprom) {
-    rgb_matrix_config.enable ^= 1;
-    rgb_task_state = STARTING;
-    eeconfig_flag_rgb_matrix(write_to_eeprom);
-    dprintf("rgb matrix toggle [%s]: rgb_matrix_config.enable = %u\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", rgb_matrix_config.enable);
-}
-void rgb_matrix_toggle_noeeprom(void) {
-    rgb_matrix_toggle_eeprom_helper(false);
-}
-void rgb_matrix_toggle(void) {
-    rgb_matrix_toggle_eeprom_helper(true);
-}
-
-void rgb_matrix_enable(void) {
-    rgb_matrix_enable_noeeprom();
-    eeconfig_flag_rgb_matrix(true);
-}
-
-void rgb_matrix_enable_noeeprom(void) {
-    if (!rgb_matrix_config.enable) rgb_task_state = STARTING;
-    rgb_matrix_config.enable = 1;
-}
-
-void rgb_matrix_disable(void) {
-    rgb_matrix_disable_noeeprom();
-    eeconfig_flag_rgb_matrix(true);
-}
-
-void rgb_matrix_disable_noeeprom(void) {
-    if (rgb_matrix_config.enable) rgb_task_state = STARTING;
-    rgb_matrix_config.enable = 0;
-}
-
-uint8_t rgb_matrix_is_enabled(void) {
-    return rgb_matrix_config.enable;
-}
-
-void rgb_matrix_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
-    if (!rgb_matrix_config.enable) {
-        return;
-    }
-    if (mode < 1) {
-        rgb_matrix_config.mode = 1;
-    } else if (mode >= RGB_MATRIX_EFFECT_MAX) {
-        rgb_matrix_config.mode = RGB_MATRIX_EFFECT_MAX - 1;
-    } else {
-        rgb_matrix_config.mode = mode;
-    }
-    rgb_task_state = STARTING;
-    eeconfig_flag_rgb_matrix(write_to_eeprom);
-    dprintf("rgb matrix mode [%s]: %u\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", rgb_matrix_config.mode);
-}
-void rgb_matrix_mode_noeeprom(uint8_t mode) {
-    rgb_matrix_mode_eeprom_helper(mode, false);
-}
-void rgb_matrix_mode(uint8_t mode) {
-    rgb_matrix_mode_eeprom_helper(mode, true);
-}
-
-uint8_t rgb_matrix_get_mode(void) {
-    return rgb_matrix_config.mode;
-}
-
-void rgb_matrix_step_helper(bool write_to_eeprom) {
-    uint8_t mode = rgb_matrix_config.mode + 1;
-    rgb_matrix_mode_eeprom_helper((mode < RGB_MATRIX_EFFECT_MAX) ? mode : 1, write_to_eeprom);
-}
-void rgb_matrix_step_noeeprom(void) {
-    rgb_matrix_step_helper(false);
-}
-void rgb_matrix_step(void) {
-    rgb_matrix_step_helper(true);
-}
+static uint32_t rgb_frame_start;
 
-void rgb_matrix_step_reverse_helper(bool write_to_eeprom) {
-    uint8_t mode = rgb_matrix_config.mode - 1;
-    rgb_matrix_mode_eeprom_helper((mode < 1) ? RGB_MATRIX_EFFECT_MAX - 1 : mode, write_to_eeprom);
-}
-void rgb_matrix_step_reverse_noeeprom(void) {
-    rgb_matrix_step_reverse_helper(false);
-}
-void rgb_matrix_step_reverse(void) {
-    rgb_matrix_step_reverse_helper(true);
-}
+#include "led_engine.inc"
 
 void rgb_matrix_sethsv_eeprom_helper(uint16_t hue, uint8_t sat, uint8_t val, bool write_to_eeprom) {
     if (!rgb_matrix_config.enable) {
@@ -687,47 +451,3 @@ void rgb_matrix_decrease_val_noeeprom(void) {
 void rgb_matrix_decrease_val(void) {
     rgb_matrix_decrease_val_helper(true);
 }
-
-void rgb_matrix_set_speed_eeprom_helper(uint8_t speed, bool write_to_eeprom) {
-    rgb_matrix_config.speed = speed;
-    eeconfig_flag_rgb_matrix(write_to_eeprom);
-    dprintf("rgb matrix set speed [%s]: %u\n", (write_to_eeprom) ? "EEPROM" : "NOEEPROM", rgb_matrix_config.speed);
-}
-void rgb_matrix_set_speed_noeeprom(uint8_t speed) {
-    rgb_matrix_set_speed_eeprom_helper(speed, false);
-}
-void rgb_matrix_set_speed(uint8_t speed) {
-    rgb_matrix_set_speed_eeprom_helper(speed, true);
-}
-
-uint8_t rgb_matrix_get_speed(void) {
-    return rgb_matrix_config.speed;
-}
-
-void rgb_matrix_increase_speed_helper(bool write_to_eeprom) {
-    rgb_matrix_set_speed_eeprom_helper(qadd8(rgb_matrix_config.speed, RGB_MATRIX_SPD_STEP), write_to_eeprom);
-}
-void rgb_matrix_increase_speed_noeeprom(void) {
-    rgb_matrix_increase_speed_helper(false);
-}
-void rgb_matrix_increase_speed(void) {
-    rgb_matrix_increase_speed_helper(true);
-}
-
-void rgb_matrix_decrease_speed_helper(bool write_to_eeprom) {
-    rgb_matrix_set_speed_eeprom_helper(qsub8(rgb_matrix_config.speed, RGB_MATRIX_SPD_STEP), write_to_eeprom);
-}
-void rgb_matrix_decrease_speed_noeeprom(void) {
-    rgb_matrix_decrease_speed_helper(false);
-}
-void rgb_matrix_decrease_speed(void) {
-    rgb_matrix_decrease_speed_helper(true);
-}
-
-led_flags_t rgb_matrix_get_flags(void) {
-    return rgb_matrix_config.flags;
-}
-
-void rgb_matrix_set_flags(led_flags_t flags) {
-    rgb_matrix_config.flags = flags;
-}
@@ -0,0 +1,206 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "serial_link.h"
+
+#define SERIAL_LINK_CRC_INIT 0xFFFF
+
+typedef enum { REPLY_OK, REPLY_NACK, REPLY_BAD, REPLY_TIMEOUT } serial_link_reply_t;
+
+// CRC-16/CCITT of every nibble, polynomial 0x1021
+static const uint16_t crc16_table[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7, 0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+uint16_t serial_link_crc16(uint16_t crc, const uint8_t *data, size_t size) {
+    while (size--) {
+        crc = (crc << 4) ^ crc16_table[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ crc16_table[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+    }
+    return crc;
+}
+
+static size_t append_crc(uint8_t *frame, size_t size) {
+    uint16_t crc    = serial_link_crc16(SERIAL_LINK_CRC_INIT, frame, size);
+    frame[size]     = crc >> 8;
+    frame[size + 1] = crc & 0xFF;
+    return size + SERIAL_LINK_CRC_SIZE;
+}
+
+size_t serial_link_encode_request(uint8_t *frame, uint8_t index, uint8_t sequence, const uint8_t *payload, uint8_t size) {
+    frame[0] = index;
+    frame[1] = sequence;
+    if (size) {
+        memcpy(&frame[2], payload, size);
+    }
+    return append_crc(frame, 2 + size);
+}
+
+size_t serial_link_encode_reply(uint8_t *frame, uint8_t status, const uint8_t *payload, uint8_t size) {
+    frame[0] = status;
+    if (size) {
+        memcpy(&frame[1], payload, size);
+    }
+    return append_crc(frame, 1 + size);
+}
+
+bool serial_link_check(const uint8_t *frame, size_t size) {
+    if (size < SERIAL_LINK_CRC_SIZE) {
+        return false;
+    }
+    size -= SERIAL_LINK_CRC_SIZE;
+    uint16_t crc = serial_link_crc16(SERIAL_LINK_CRC_INIT, frame, size);
+    return frame[size] == (crc >> 8) && frame[size + 1] == (crc & 0xFF);
+}
+
+static void count(uint16_t *counter) {
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+}
+
+void serial_link_init(serial_link_t *link, const serial_link_io_t *io) {
+    memset(link, 0, sizeof(serial_link_t));
+    link->io         = io;
+    link->last_index = UINT8_MAX;
+}
+
+static serial_link_reply_t receive_reply(serial_link_t *link, const serial_link_buffers_t *buffers) {
+    uint8_t *frame = link->frame;
+
+    if (!link->io->receive(frame, 1)) {
+        return REPLY_TIMEOUT;
+    }
+
+    if (frame[0] & SERIAL_LINK_NACK) {
+        if (!link->io->receive(&frame[1], SERIAL_LINK_CRC_SIZE)) {
+            return REPLY_TIMEOUT;
+        }
+        // Whatever sequence it carries, the request did not arrive
+        return serial_link_check(frame, SERIAL_LINK_REPLY_OVERHEAD) ? REPLY_NACK : REPLY_BAD;
+    }
+
+    size_t size = SERIAL_LINK_REPLY_OVERHEAD + buffers->reply_size;
+    if (!link->io->receive(&frame[1], size - 1)) {
+        return REPLY_TIMEOUT;
+    }
+    if (!serial_link_check(frame, size) || frame[0] != link->sequence) {
+        return REPLY_BAD;
+    }
+
+    if (buffers->reply_size) {
+        memcpy(buffers->reply, &frame[1], buffers->reply_size);
+    }
+    return REPLY_OK;
+}
+
+bool serial_link_initiate(serial_link_t *link, uint8_t index) {
+    const serial_link_io_t *io = link->io;
+    serial_link_buffers_t   buffers;
+
+    if (!io->buffers(index, &buffers)) {
+        return false;
+    }
+
+    link->sequence = (link->sequence + 1) & SERIAL_LINK_SEQUENCE_MASK;
+
+    for (uint8_t attempt = 0; attempt <= SERIAL_LINK_RETRIES; attempt++) {
+        if (attempt) {
+            count(&link->counters.retransmissions);
+        }
+
+        /* Start with a clean slate, parts of a failed reply or spurious
+         * bytes could still be in the receive queue. The reply overwrites
+         * the frame, so the request is encoded again on every attempt. */
+        io->clear();
+        size_t size = serial_link_encode_request(link->frame, index, link->sequence, buffers.request, buffers.request_size);
+        if (!io->send(link->frame, size)) {
+            count(&link->counters.timeouts);
+            break;
+        }
+
+        serial_link_reply_t reply = receive_reply(link, &buffers);
+        if (reply == REPLY_OK) {
+            count(&link->counters.transactions);
+            return true;
+        }
+        if (reply == REPLY_TIMEOUT) {
+            /* Nothing answers, sending again would only block for another
+             * timeout. The transport decides whether to try again later. */
+            count(&link->counters.timeouts);
+            break;
+        }
+        count(reply == REPLY_NACK ? &link->counters.nacks : &link->counters.frame_errors);
+    }
+
+    count(&link->counters.failures);
+    return false;
+}
+
+bool serial_link_react(serial_link_t *link, uint8_t index) {
+    const serial_link_io_t *io    = link->io;
+    uint8_t *               frame = link->frame;
+    serial_link_buffers_t   buffers;
+
+    /* Without the payload size the rest of the request cannot be found,
+     * the initiator times out and sends it again. */
+    if (!io->buffers(index, &buffers)) {
+        count(&link->counters.frame_errors);
+        return false;
+    }
+
+    size_t size = SERIAL_LINK_REQUEST_OVERHEAD + buffers.request_size;
+    frame[0]    = index;
+    if (!io->receive(&frame[1], size - 1)) {
+        count(&link->counters.timeouts);
+        return false;
+    }
+
+    uint8_t sequence = frame[1];
+    if (!serial_link_check(frame, size) || sequence > SERIAL_LINK_SEQUENCE_MASK) {
+        count(&link->counters.frame_errors);
+        count(&link->counters.nacks);
+        /* Drop the rest of the bad request before answering, the initiator
+         * only sends again once it has the NACK. */
+        io->clear();
+        size = serial_link_encode_reply(frame, (sequence & SERIAL_LINK_SEQUENCE_MASK) | SERIAL_LINK_NACK, NULL, 0);
+        return io->send(frame, size);
+    }
+
+    if (index == link->last_index && sequence == link->sequence) {
+        // The reply got lost, answer again without executing twice
+        count(&link->counters.retransmissions);
+    } else {
+        if (buffers.request_size) {
+            memcpy(buffers.request, &frame[2], buffers.request_size);
+        }
+        if (io->execute) {
+            io->execute(index);
+        }
+        link->last_index = index;
+        link->sequence   = sequence;
+    }
+
+    size = serial_link_encode_reply(frame, sequence, buffers.reply, buffers.reply_size);
+    if (!io->send(frame, size)) {
+        count(&link->counters.timeouts);
+        return false;
+    }
+
+    count(&link->counters.transactions);
+    return true;
+}
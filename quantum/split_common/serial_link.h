@@ -0,0 +1,103 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Checked split transactions over a serial line, independent of the
+ * hardware that moves the bytes.
+ *
+ * Request, initiator to target:  [index, sequence, payload..., crc (2)]
+ * Reply, target to initiator:    [sequence, payload..., crc (2)]
+ *                                [sequence | SERIAL_LINK_NACK, crc (2)]
+ *
+ * Both halves know the payload sizes of every transaction, so frames carry
+ * no length. The crc is CRC-16/CCITT over the rest of the frame, big endian.
+ * A transaction is one frame each way, so a half-duplex line turns around
+ * once per transaction.
+ *
+ * The target answers a request with a bad crc with a NACK. The initiator
+ * sends a request again after a NACK or a bad reply, up to
+ * SERIAL_LINK_RETRIES times. A request sent again keeps its sequence, so a
+ * target that already executed it only sends the reply again. A timeout
+ * fails the transaction straight away, retrying an unresponsive target is
+ * left to the split transactions.
+ */
+
+#ifndef SERIAL_LINK_RETRIES
+#    define SERIAL_LINK_RETRIES 2
+#endif
+
+#define SERIAL_LINK_NACK 0x80
+#define SERIAL_LINK_SEQUENCE_MASK 0x7F
+#define SERIAL_LINK_CRC_SIZE 2
+#define SERIAL_LINK_REQUEST_OVERHEAD (2 + SERIAL_LINK_CRC_SIZE)
+#define SERIAL_LINK_REPLY_OVERHEAD (1 + SERIAL_LINK_CRC_SIZE)
+#define SERIAL_LINK_FRAME_SIZE (UINT8_MAX + SERIAL_LINK_REQUEST_OVERHEAD)
+
+typedef struct {
+    uint8_t  request_size;
+    uint8_t *request;
+    uint8_t  reply_size;
+    uint8_t *reply;
+} serial_link_buffers_t;
+
+typedef struct {
+    // Blocking transfers with a timeout, false when not all bytes went through
+    bool (*send)(const uint8_t *data, size_t size);
+    bool (*receive)(uint8_t *data, size_t size);
+    // Drop whatever is left in the receive queue
+    void (*clear)(void);
+    // Buffers of a transaction, false for an unknown index
+    bool (*buffers)(uint8_t index, serial_link_buffers_t *buffers);
+    // Target only, act on a request once its payload is in place
+    void (*execute)(uint8_t index);
+} serial_link_io_t;
+
+// Saturating event counters
+typedef struct {
+    uint16_t transactions;    // completed
+    uint16_t retransmissions; // requests sent or received again
+    uint16_t frame_errors;    // frames with a bad crc or an unexpected header
+    uint16_t nacks;           // NACKs sent or received
+    uint16_t timeouts;        // frames that did not go through in full
+    uint16_t failures;        // transactions given up after all retries
+} serial_link_counters_t;
+
+typedef struct {
+    const serial_link_io_t *io;
+    uint8_t                 sequence;   // of the last request sent or executed
+    uint8_t                 last_index; // target only, of the last request executed
+    serial_link_counters_t  counters;
+    uint8_t                 frame[SERIAL_LINK_FRAME_SIZE];
+} serial_link_t;
+
+void serial_link_init(serial_link_t *link, const serial_link_io_t *io);
+
+// Initiator side, runs one transaction
+bool serial_link_initiate(serial_link_t *link, uint8_t index);
+// Target side, handles the request whose index byte was just received.
+// Returns false when the rest of the receive queue should be dropped.
+bool serial_link_react(serial_link_t *link, uint8_t index);
+
+// The frame codec
+uint16_t serial_link_crc16(uint16_t crc, const uint8_t *data, size_t size);
+size_t   serial_link_encode_request(uint8_t *frame, uint8_t index, uint8_t sequence, const uint8_t *payload, uint8_t size);
+size_t   serial_link_encode_reply(uint8_t *frame, uint8_t status, const uint8_t *payload, uint8_t size);
+bool     serial_link_check(const uint8_t *frame, size_t size);
@@ -0,0 +1,297 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stddef.h>
+
+#include "split_framebuffer.h"
+#include "atomic_util.h"
+
+#define TOKEN_SKIP 0x00
+#define TOKEN_LITERAL 0x40
+#define TOKEN_REPEAT 0x80
+
+#define MAX_SKIP 64
+#define MAX_LITERAL 64
+#define MAX_REPEAT 128
+
+// Transaction buffer sizes are 8 bit
+_Static_assert(sizeof(split_framebuffer_packet_t) <= UINT8_MAX, "SPLIT_FRAMEBUFFER_PACKET_SIZE too large for a split transaction");
+
+typedef struct {
+    uint8_t *buffer;
+    uint8_t *shadow;
+    uint16_t size;
+    // Master: where the next search starts, and where it continues once the pending packet is sent
+    uint16_t cursor;
+    uint16_t pending_cursor;
+    // Master: the slave content is unknown, send everything from the cursor on
+    bool full;
+    // Slave: range received since the last split_framebuffer_task()
+    bool     updated;
+    uint16_t updated_start;
+    uint16_t updated_end;
+} split_framebuffer_channel_t;
+
+static split_framebuffer_channel_t channels[SPLIT_FRAMEBUFFER_CHANNELS];
+static uint8_t                     next_channel;
+
+bool split_framebuffer_init(uint8_t channel, uint8_t *buffer, uint8_t *shadow, uint16_t size) {
+    if (channel >= SPLIT_FRAMEBUFFER_CHANNELS) {
+        return false;
+    }
+    split_framebuffer_channel_t *c = &channels[channel];
+    memset(c, 0, sizeof(*c));
+    c->buffer = buffer;
+    c->shadow = shadow;
+    c->size   = size;
+    c->full   = true;
+    return true;
+}
+
+void split_framebuffer_invalidate(uint8_t channel) {
+    if (channel < SPLIT_FRAMEBUFFER_CHANNELS) {
+        channels[channel].full   = true;
+        channels[channel].cursor = 0;
+    }
+}
+
+////////////////////////////////////////////////////
+// Codec
+
+static inline bool is_changed(const uint8_t *frame, const uint8_t *shadow, uint16_t pos) {
+    return !shadow || frame[pos] != shadow[pos];
+}
+
+static uint16_t unchanged_run(const uint8_t *frame, const uint8_t *shadow, uint16_t size, uint16_t pos) {
+    uint16_t count = 0;
+    while (pos + count < size && !is_changed(frame, shadow, pos + count)) {
+        count++;
+    }
+    return count;
+}
+
+static uint8_t repeat_run(const uint8_t *frame, uint16_t size, uint16_t pos, uint8_t max) {
+    uint8_t count = 1;
+    while (count < max && pos + count < size && frame[pos + count] == frame[pos]) {
+        count++;
+    }
+    return count;
+}
+
+bool split_framebuffer_encode(const uint8_t *frame, const uint8_t *shadow, uint16_t size, uint16_t *cursor, split_framebuffer_packet_t *packet) {
+    uint16_t pos = *cursor + unchanged_run(frame, shadow, size, *cursor);
+    if (pos >= size) {
+        *cursor = size;
+        return false;
+    }
+
+    uint8_t  out = 0;
+    uint16_t end = pos;
+    packet->offset = pos;
+    while (pos < size) {
+        uint16_t skip = unchanged_run(frame, shadow, size, pos);
+        if (skip) {
+            // Never end a packet on a skip, and leave room for the token that follows it
+            if (pos + skip >= size || out + (skip + MAX_SKIP - 1) / MAX_SKIP + 2 > SPLIT_FRAMEBUFFER_PACKET_SIZE) {
+                break;
+            }
+            while (skip) {
+                uint8_t count       = skip > MAX_SKIP ? MAX_SKIP : skip;
+                packet->data[out++] = TOKEN_SKIP | (count - 1);
+                skip -= count;
+                pos += count;
+            }
+            continue;
+        }
+
+        if (SPLIT_FRAMEBUFFER_PACKET_SIZE - out < 2) {
+            break;
+        }
+
+        // Repeated values may include unchanged bytes, as values are sent as is
+        uint8_t repeat = repeat_run(frame, size, pos, MAX_REPEAT);
+        if (repeat >= 3) {
+            packet->data[out++] = TOKEN_REPEAT | (repeat - 1);
+            packet->data[out++] = frame[pos];
+            pos += repeat;
+            end = pos;
+            continue;
+        }
+
+        uint8_t max   = SPLIT_FRAMEBUFFER_PACKET_SIZE - out - 1;
+        uint8_t count = 0;
+        if (max > MAX_LITERAL) {
+            max = MAX_LITERAL;
+        }
+        while (count < max && pos + count < size) {
+            // Stop where a skip or a repeat is cheaper, single unchanged bytes are sent as literals
+            if (count && ((!is_changed(frame, shadow, pos + count) && (pos + count + 1 >= size || !is_changed(frame, shadow, pos + count + 1))) || repeat_run(frame, size, pos + count, 3) == 3)) {
+                break;
+            }
+            count++;
+        }
+        packet->data[out++] = TOKEN_LITERAL | (count - 1);
+        memcpy(&packet->data[out], &frame[pos], count);
+        out += count;
+        pos += count;
+        end = pos;
+    }
+
+    packet->length = out;
+    *cursor        = end;
+    return true;
+}
+
+uint16_t split_framebuffer_decode(const split_framebuffer_packet_t *packet, uint8_t *buffer, uint16_t size) {
+    uint16_t pos    = packet->offset;
+    uint8_t  in     = 0;
+    uint8_t  length = packet->length < SPLIT_FRAMEBUFFER_PACKET_SIZE ? packet->length : SPLIT_FRAMEBUFFER_PACKET_SIZE;
+
+    while (in < length) {
+        uint8_t token = packet->data[in++];
+        if (token & TOKEN_REPEAT) {
+            if (in >= length) {
+                break;
+            }
+            uint8_t value = packet->data[in++];
+            for (uint8_t i = 0; i <= (token & ~TOKEN_REPEAT); i++, pos++) {
+                if (pos < size) {
+                    buffer[pos] = value;
+                }
+            }
+        } else if (token & TOKEN_LITERAL) {
+            for (uint8_t i = 0; i <= (token & ~TOKEN_LITERAL) && in < length; i++, pos++) {
+                if (pos < size) {
+                    buffer[pos] = packet->data[in];
+                }
+                in++;
+            }
+        } else {
+            pos += token + 1;
+        }
+    }
+
+    return pos - packet->offset;
+}
+
+////////////////////////////////////////////////////
+// Master
+
+static bool encode_channel(uint8_t channel, split_framebuffer_packet_t *packet) {
+    split_framebuffer_channel_t *c = &channels[channel];
+    if (!c->buffer || !c->shadow) {
+        return false;
+    }
+
+    uint16_t cursor = c->cursor;
+    if (c->full) {
+        if (split_framebuffer_encode(c->buffer, NULL, c->size, &cursor, packet)) {
+            c->pending_cursor = cursor;
+            return true;
+        }
+        // Full pass complete, the shadow is trustworthy again
+        c->full = false;
+        cursor  = 0;
+    }
+
+    if (!split_framebuffer_encode(c->buffer, c->shadow, c->size, &cursor, packet)) {
+        // Wrap around, to pick up changes behind the cursor
+        cursor = 0;
+        if (c->cursor == 0 || !split_framebuffer_encode(c->buffer, c->shadow, c->size, &cursor, packet)) {
+            c->cursor = 0;
+            return false;
+        }
+    }
+    c->pending_cursor = cursor;
+    return true;
+}
+
+bool split_framebuffer_next_packet(split_framebuffer_packet_t *packet) {
+    for (uint8_t i = 0; i < SPLIT_FRAMEBUFFER_CHANNELS; i++) {
+        uint8_t channel = (next_channel + i) % SPLIT_FRAMEBUFFER_CHANNELS;
+        if (encode_channel(channel, packet)) {
+            packet->channel = channel;
+            next_channel    = (channel + 1) % SPLIT_FRAMEBUFFER_CHANNELS;
+            return true;
+        }
+    }
+    return false;
+}
+
+void split_framebuffer_packet_sent(const split_framebuffer_packet_t *packet, bool success) {
+    if (packet->channel >= SPLIT_FRAMEBUFFER_CHANNELS) {
+        return;
+    }
+    split_framebuffer_channel_t *c = &channels[packet->channel];
+    if (!success) {
+        // The slave may have missed anything since, so start over
+        split_framebuffer_invalidate(packet->channel);
+        return;
+    }
+    split_framebuffer_decode(packet, c->shadow, c->size);
+    c->cursor = c->pending_cursor;
+}
+
+////////////////////////////////////////////////////
+// Slave
+
+void split_framebuffer_receive(const split_framebuffer_packet_t *packet) {
+    if (packet->channel >= SPLIT_FRAMEBUFFER_CHANNELS) {
+        return;
+    }
+    split_framebuffer_channel_t *c = &channels[packet->channel];
+    if (!c->buffer || packet->offset >= c->size) {
+        return;
+    }
+
+    uint16_t end = packet->offset + split_framebuffer_decode(packet, c->buffer, c->size);
+    if (end > c->size) {
+        end = c->size;
+    }
+    if (!c->updated || packet->offset < c->updated_start) {
+        c->updated_start = packet->offset;
+    }
+    if (!c->updated || end > c->updated_end) {
+        c->updated_end = end;
+    }
+    c->updated = true;
+}
+
+void split_framebuffer_task(void) {
+    for (uint8_t channel = 0; channel < SPLIT_FRAMEBUFFER_CHANNELS; channel++) {
+        bool     updated = false;
+        uint16_t start = 0, end = 0;
+        ATOMIC_BLOCK_FORCEON {
+            split_framebuffer_channel_t *c = &channels[channel];
+            if (c->updated) {
+                updated    = true;
+                start      = c->updated_start;
+                end        = c->updated_end;
+                c->updated = false;
+            }
+        }
+        if (updated) {
+            split_framebuffer_updated_kb(channel, start, end - start);
+        }
+    }
+}
+
+__attribute__((weak)) void split_framebuffer_updated_kb(uint8_t channel, uint16_t offset, uint16_t length) {
+    split_framebuffer_updated_user(channel, offset, length);
+}
+
+__attribute__((weak)) void split_framebuffer_updated_user(uint8_t channel, uint16_t offset, uint16_t length) {}
@@ -0,0 +1,122 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Master to slave framebuffer shipping.
+ *
+ * The master renders into a buffer per channel (OLED pages, LED frames, ...)
+ * and keeps a shadow copy of what the slave holds. Every sync it sends the
+ * changed spans as packets, which the slave applies to its own copy of the
+ * buffer before calling split_framebuffer_updated_kb/user() from the main loop.
+ *
+ * Packet payload is a stream of run length encoded tokens:
+ *   0x00-0x3F  skip n + 1 unchanged bytes
+ *   0x40-0x7F  (n & 0x3F) + 1 literal bytes follow
+ *   0x80-0xFF  repeat the next byte (n & 0x7F) + 1 times
+ * Spans are selected by XOR-ing the frame against the shadow, but carry the
+ * new values rather than the XOR, so a packet that is retried after the slave
+ * already applied it is harmless.
+ */
+
+#ifndef SPLIT_FRAMEBUFFER_CHANNELS
+#    define SPLIT_FRAMEBUFFER_CHANNELS 1
+#endif // SPLIT_FRAMEBUFFER_CHANNELS
+
+#ifndef SPLIT_FRAMEBUFFER_PACKET_SIZE
+#    define SPLIT_FRAMEBUFFER_PACKET_SIZE 32
+#endif // SPLIT_FRAMEBUFFER_PACKET_SIZE
+
+// Maximum number of packets sent per master sync
+#ifndef SPLIT_FRAMEBUFFER_PACKETS_PER_SYNC
+#    define SPLIT_FRAMEBUFFER_PACKETS_PER_SYNC 1
+#endif // SPLIT_FRAMEBUFFER_PACKETS_PER_SYNC
+
+// Minimum time between master syncs that send packets, in ms
+#ifndef SPLIT_FRAMEBUFFER_INTERVAL
+#    define SPLIT_FRAMEBUFFER_INTERVAL 20
+#endif // SPLIT_FRAMEBUFFER_INTERVAL
+
+typedef struct __attribute__((packed)) _split_framebuffer_packet_t {
+    uint8_t  channel;
+    uint8_t  length; // Payload bytes in use
+    uint16_t offset; // Buffer offset of the first encoded byte
+    uint8_t  data[SPLIT_FRAMEBUFFER_PACKET_SIZE];
+} split_framebuffer_packet_t;
+
+/**
+ * @brief Register the buffer of a channel.
+ *
+ * @param buffer the frame rendered on the master, or the frame received on the slave
+ * @param shadow master only, a buffer of the same size tracking what the slave holds
+ */
+bool split_framebuffer_init(uint8_t channel, uint8_t *buffer, uint8_t *shadow, uint16_t size);
+
+/**
+ * @brief Force the next sync of the channel to resend the whole buffer.
+ */
+void split_framebuffer_invalidate(uint8_t channel);
+
+/* Codec */
+
+/**
+ * @brief Encode the bytes of frame that differ from shadow into a packet,
+ * starting the search at *cursor. A NULL shadow treats every byte as changed.
+ * On return *cursor is the offset following the last encoded byte.
+ *
+ * @return false if there was nothing left to encode.
+ */
+bool split_framebuffer_encode(const uint8_t *frame, const uint8_t *shadow, uint16_t size, uint16_t *cursor, split_framebuffer_packet_t *packet);
+
+/**
+ * @brief Apply a packet to a buffer of the given size.
+ *
+ * @return the number of bytes covered by the packet, starting at packet->offset.
+ */
+uint16_t split_framebuffer_decode(const split_framebuffer_packet_t *packet, uint8_t *buffer, uint16_t size);
+
+/* Transport glue */
+
+/**
+ * @brief Master: encode the next packet, going round robin over channels.
+ *
+ * @return false if every channel is in sync.
+ */
+bool split_framebuffer_next_packet(split_framebuffer_packet_t *packet);
+
+/**
+ * @brief Master: report the result of sending a packet from split_framebuffer_next_packet().
+ */
+void split_framebuffer_packet_sent(const split_framebuffer_packet_t *packet, bool success);
+
+/**
+ * @brief Slave: apply a received packet. Safe to call from interrupt context.
+ */
+void split_framebuffer_receive(const split_framebuffer_packet_t *packet);
+
+/**
+ * @brief Slave: invoke split_framebuffer_updated_kb() for channels that received data.
+ */
+void split_framebuffer_task(void);
+
+/**
+ * @brief Slave: called from the main loop with the range of a channel that was updated.
+ */
+void split_framebuffer_updated_kb(uint8_t channel, uint16_t offset, uint16_t length);
+void split_framebuffer_updated_user(uint8_t channel, uint16_t offset, uint16_t length);
@@ -0,0 +1,15 @@
+split_framebuffer_DEFS := -DIGNORE_ATOMIC_BLOCK -DSPLIT_FRAMEBUFFER_CHANNELS=2
+
+split_framebuffer_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_framebuffer_tests.cpp \
+	$(QUANTUM_PATH)/split_common/split_framebuffer.c
+
+split_framebuffer_INC := \
+	$(QUANTUM_PATH)/split_common
+
+serial_link_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/serial_link_tests.cpp \
+	$(QUANTUM_PATH)/split_common/serial_link.c
+
+serial_link_INC := \
+	$(QUANTUM_PATH)/split_common
@@ -0,0 +1,339 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <deque>
+#include <vector>
+
+extern "C" {
+#include "serial_link.h"
+}
+
+/* Both halves run in this process. The initiator's send hands the request
+ * to the target straight away, the way the slave thread wakes up on the
+ * first byte of a request. */
+
+enum { REQUEST_AND_REPLY, WRITE_ONLY, READ_ONLY, NUM_TRANSACTIONS };
+
+static const uint8_t request_sizes[NUM_TRANSACTIONS] = {4, 8, 0};
+static const uint8_t reply_sizes[NUM_TRANSACTIONS]   = {3, 0, 2};
+
+static uint8_t master_request[NUM_TRANSACTIONS][8];
+static uint8_t master_reply[NUM_TRANSACTIONS][8];
+static uint8_t slave_request[NUM_TRANSACTIONS][8];
+static uint8_t slave_reply[NUM_TRANSACTIONS][8];
+static int     executed[NUM_TRANSACTIONS];
+
+static std::deque<uint8_t> to_target;
+static std::deque<uint8_t> to_initiator;
+
+// Faults on the next frames, a bit to flip in each or -1 to leave them be
+static std::deque<int> request_faults;
+static std::deque<int> reply_faults;
+static int             replies_to_drop;
+static bool            target_connected;
+
+static serial_link_t initiator;
+static serial_link_t target;
+
+static void put_frame(std::deque<uint8_t> &wire, std::deque<int> &faults, const uint8_t *data, size_t size) {
+    std::vector<uint8_t> frame(data, data + size);
+    if (!faults.empty()) {
+        int bit = faults.front();
+        faults.pop_front();
+        if (bit >= 0) {
+            frame[bit / 8] ^= 1 << (bit % 8);
+        }
+    }
+    wire.insert(wire.end(), frame.begin(), frame.end());
+}
+
+static bool take(std::deque<uint8_t> &wire, uint8_t *data, size_t size) {
+    while (size && !wire.empty()) {
+        *data++ = wire.front();
+        wire.pop_front();
+        size--;
+    }
+    return size == 0;
+}
+
+static bool get_buffers(uint8_t (*request)[8], uint8_t (*reply)[8], uint8_t index, serial_link_buffers_t *buffers) {
+    if (index >= NUM_TRANSACTIONS) {
+        return false;
+    }
+    buffers->request_size = request_sizes[index];
+    buffers->request      = request[index];
+    buffers->reply_size   = reply_sizes[index];
+    buffers->reply        = reply[index];
+    return true;
+}
+
+static bool initiator_send(const uint8_t *data, size_t size) {
+    put_frame(to_target, request_faults, data, size);
+    if (target_connected) {
+        uint8_t index;
+        if (take(to_target, &index, 1) && !serial_link_react(&target, index)) {
+            to_target.clear();
+        }
+    }
+    return true;
+}
+
+static bool initiator_receive(uint8_t *data, size_t size) {
+    return take(to_initiator, data, size);
+}
+
+static void initiator_clear(void) {
+    to_initiator.clear();
+}
+
+static bool initiator_buffers(uint8_t index, serial_link_buffers_t *buffers) {
+    return get_buffers(master_request, master_reply, index, buffers);
+}
+
+static bool target_send(const uint8_t *data, size_t size) {
+    if (replies_to_drop) {
+        replies_to_drop--;
+        return true;
+    }
+    put_frame(to_initiator, reply_faults, data, size);
+    return true;
+}
+
+static bool target_receive(uint8_t *data, size_t size) {
+    return take(to_target, data, size);
+}
+
+static void target_clear(void) {
+    to_target.clear();
+}
+
+static bool target_buffers(uint8_t index, serial_link_buffers_t *buffers) {
+    return get_buffers(slave_request, slave_reply, index, buffers);
+}
+
+// The slave answers REQUEST_AND_REPLY with its request plus the number of times it ran
+static void target_execute(uint8_t index) {
+    executed[index]++;
+    if (index == REQUEST_AND_REPLY) {
+        for (uint8_t i = 0; i < reply_sizes[index]; i++) {
+            slave_reply[index][i] = slave_request[index][i] + executed[index];
+        }
+    }
+}
+
+static const serial_link_io_t initiator_io = {initiator_send, initiator_receive, initiator_clear, initiator_buffers, NULL};
+static const serial_link_io_t target_io    = {target_send, target_receive, target_clear, target_buffers, target_execute};
+
+class SerialLink : public testing::Test {
+   protected:
+    void SetUp() override {
+        memset(master_request, 0, sizeof(master_request));
+        memset(master_reply, 0, sizeof(master_reply));
+        memset(slave_request, 0, sizeof(slave_request));
+        memset(slave_reply, 0, sizeof(slave_reply));
+        memset(executed, 0, sizeof(executed));
+        to_target.clear();
+        to_initiator.clear();
+        request_faults.clear();
+        reply_faults.clear();
+        replies_to_drop  = 0;
+        target_connected = true;
+        serial_link_init(&initiator, &initiator_io);
+        serial_link_init(&target, &target_io);
+
+        const uint8_t request[4] = {10, 20, 30, 40};
+        memcpy(master_request[REQUEST_AND_REPLY], request, sizeof(request));
+    }
+
+    void ExpectRequestAndReply(int executions) {
+        EXPECT_EQ(memcmp(slave_request[REQUEST_AND_REPLY], master_request[REQUEST_AND_REPLY], 4), 0);
+        for (int i = 0; i < 3; i++) {
+            EXPECT_EQ(master_reply[REQUEST_AND_REPLY][i], master_request[REQUEST_AND_REPLY][i] + executions) << "byte " << i;
+        }
+        EXPECT_EQ(executed[REQUEST_AND_REPLY], executions);
+    }
+};
+
+TEST_F(SerialLink, Crc16MatchesCheckValue) {
+    const uint8_t check[] = "123456789";
+    EXPECT_EQ(serial_link_crc16(0xFFFF, check, 9), 0x29B1);
+}
+
+TEST_F(SerialLink, CheckCatchesOneAndTwoBitErrors) {
+    uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t frame[8 + SERIAL_LINK_REQUEST_OVERHEAD];
+    size_t  size = serial_link_encode_request(frame, 3, 5, payload, sizeof(payload));
+    ASSERT_EQ(size, sizeof(frame));
+    EXPECT_TRUE(serial_link_check(frame, size));
+
+    for (size_t a = 0; a < size * 8; a++) {
+        frame[a / 8] ^= 1 << (a % 8);
+        EXPECT_FALSE(serial_link_check(frame, size)) << "bit " << a;
+        for (size_t b = a + 1; b < size * 8; b++) {
+            frame[b / 8] ^= 1 << (b % 8);
+            EXPECT_FALSE(serial_link_check(frame, size)) << "bits " << a << " and " << b;
+            frame[b / 8] ^= 1 << (b % 8);
+        }
+        frame[a / 8] ^= 1 << (a % 8);
+    }
+}
+
+TEST_F(SerialLink, ReplyFrameLayout) {
+    uint8_t payload[2] = {0xAB, 0xCD};
+    uint8_t frame[2 + SERIAL_LINK_REPLY_OVERHEAD];
+    EXPECT_EQ(serial_link_encode_reply(frame, 9, payload, 2), sizeof(frame));
+    EXPECT_EQ(frame[0], 9);
+    EXPECT_EQ(frame[1], 0xAB);
+    EXPECT_EQ(frame[2], 0xCD);
+    EXPECT_TRUE(serial_link_check(frame, sizeof(frame)));
+    EXPECT_FALSE(serial_link_check(frame, 1));
+}
+
+TEST_F(SerialLink, TransactionsMovePayloads) {
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(1);
+
+    memset(master_request[WRITE_ONLY], 0x5A, 8);
+    EXPECT_TRUE(serial_link_initiate(&initiator, WRITE_ONLY));
+    EXPECT_EQ(memcmp(slave_request[WRITE_ONLY], master_request[WRITE_ONLY], 8), 0);
+
+    slave_reply[READ_ONLY][0] = 0x12;
+    slave_reply[READ_ONLY][1] = 0x34;
+    EXPECT_TRUE(serial_link_initiate(&initiator, READ_ONLY));
+    EXPECT_EQ(master_reply[READ_ONLY][0], 0x12);
+    EXPECT_EQ(master_reply[READ_ONLY][1], 0x34);
+
+    EXPECT_EQ(initiator.counters.transactions, 3);
+    EXPECT_EQ(target.counters.transactions, 3);
+    EXPECT_EQ(initiator.counters.retransmissions, 0);
+    EXPECT_TRUE(to_target.empty());
+    EXPECT_TRUE(to_initiator.empty());
+}
+
+TEST_F(SerialLink, CorruptRequestIsNackedAndSentAgain) {
+    request_faults = {20};
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(1);
+    EXPECT_EQ(target.counters.frame_errors, 1);
+    EXPECT_EQ(target.counters.nacks, 1);
+    EXPECT_EQ(initiator.counters.nacks, 1);
+    EXPECT_EQ(initiator.counters.retransmissions, 1);
+    EXPECT_EQ(initiator.counters.transactions, 1);
+}
+
+TEST_F(SerialLink, CorruptSequenceIsNacked) {
+    request_faults = {15};
+    EXPECT_TRUE(serial_link_initiate(&initiator, WRITE_ONLY));
+    EXPECT_EQ(target.counters.nacks, 1);
+    EXPECT_EQ(initiator.counters.nacks, 1);
+    EXPECT_EQ(executed[WRITE_ONLY], 1);
+}
+
+TEST_F(SerialLink, CorruptReplyIsSentAgainWithoutExecutingTwice) {
+    reply_faults = {12};
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(1);
+    EXPECT_EQ(initiator.counters.frame_errors, 1);
+    EXPECT_EQ(initiator.counters.retransmissions, 1);
+    EXPECT_EQ(target.counters.retransmissions, 1);
+    EXPECT_EQ(target.counters.transactions, 2);
+}
+
+TEST_F(SerialLink, LostReplyFailsWithoutWaitingAgain) {
+    replies_to_drop = 1;
+    EXPECT_FALSE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    EXPECT_EQ(initiator.counters.timeouts, 1);
+    EXPECT_EQ(initiator.counters.retransmissions, 0);
+    EXPECT_EQ(initiator.counters.failures, 1);
+    EXPECT_EQ(executed[REQUEST_AND_REPLY], 1);
+
+    // Retrying is up to the transport, which starts a new transaction
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(2);
+}
+
+TEST_F(SerialLink, CorruptNackIsSentAgain) {
+    request_faults = {20};
+    reply_faults   = {1};
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(1);
+    EXPECT_EQ(initiator.counters.frame_errors, 1);
+    EXPECT_EQ(initiator.counters.nacks, 0);
+}
+
+TEST_F(SerialLink, GivesUpAfterRetries) {
+    for (int i = 0; i <= SERIAL_LINK_RETRIES; i++) {
+        request_faults.push_back(30);
+    }
+    memset(slave_request[REQUEST_AND_REPLY], 0xEE, 4);
+    EXPECT_FALSE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    EXPECT_EQ(initiator.counters.failures, 1);
+    EXPECT_EQ(initiator.counters.nacks, SERIAL_LINK_RETRIES + 1);
+    EXPECT_EQ(initiator.counters.retransmissions, SERIAL_LINK_RETRIES);
+    EXPECT_EQ(executed[REQUEST_AND_REPLY], 0);
+    // Bad requests never reach the transaction buffers
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(slave_request[REQUEST_AND_REPLY][i], 0xEE);
+    }
+
+    // The next transaction goes through
+    EXPECT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    ExpectRequestAndReply(1);
+}
+
+TEST_F(SerialLink, DisconnectedTargetTimesOut) {
+    target_connected = false;
+    EXPECT_FALSE(serial_link_initiate(&initiator, READ_ONLY));
+    EXPECT_EQ(initiator.counters.timeouts, 1);
+    EXPECT_EQ(initiator.counters.retransmissions, 0);
+    EXPECT_EQ(initiator.counters.failures, 1);
+}
+
+TEST_F(SerialLink, CorruptIndexTimesOut) {
+    // The target cannot tell how long the request is, so it does not answer
+    request_faults = {3};
+    EXPECT_FALSE(serial_link_initiate(&initiator, REQUEST_AND_REPLY));
+    EXPECT_EQ(target.counters.frame_errors, 1);
+    EXPECT_EQ(initiator.counters.timeouts, 1);
+    EXPECT_EQ(executed[REQUEST_AND_REPLY], 0);
+}
+
+TEST_F(SerialLink, UnknownIndexIsNotSent) {
+    EXPECT_FALSE(serial_link_initiate(&initiator, NUM_TRANSACTIONS));
+    EXPECT_TRUE(to_target.empty());
+
+    to_target = {0, 0};
+    EXPECT_FALSE(serial_link_react(&target, NUM_TRANSACTIONS));
+    EXPECT_EQ(target.counters.frame_errors, 1);
+}
+
+TEST_F(SerialLink, RepeatedTransactionsExecuteEveryTimeAcrossSequenceWrap) {
+    for (int i = 1; i <= 300; i++) {
+        ASSERT_TRUE(serial_link_initiate(&initiator, REQUEST_AND_REPLY)) << "transaction " << i;
+        EXPECT_EQ(executed[REQUEST_AND_REPLY], i);
+    }
+    EXPECT_EQ(initiator.counters.retransmissions, 0);
+}
+
+TEST_F(SerialLink, CountersSaturate) {
+    initiator.counters.timeouts = UINT16_MAX;
+    target_connected            = false;
+    EXPECT_FALSE(serial_link_initiate(&initiator, READ_ONLY));
+    EXPECT_EQ(initiator.counters.timeouts, UINT16_MAX);
+}
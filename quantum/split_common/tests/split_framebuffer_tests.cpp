@@ -0,0 +1,242 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "split_framebuffer.h"
+}
+
+#define FRAME_SIZE 512
+
+// Channel 0 plays the master side, channel 1 the slave side
+#define MASTER_CHANNEL 0
+#define SLAVE_CHANNEL 1
+
+static uint8_t master_frame[FRAME_SIZE];
+static uint8_t master_shadow[FRAME_SIZE];
+static uint8_t slave_frame[FRAME_SIZE];
+
+struct Update {
+    uint8_t  channel;
+    uint16_t offset;
+    uint16_t length;
+};
+static std::vector<Update> updates;
+
+extern "C" void split_framebuffer_updated_user(uint8_t channel, uint16_t offset, uint16_t length) {
+    updates.push_back({channel, offset, length});
+}
+
+static uint32_t random_state;
+
+static uint32_t next_random(void) {
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 16;
+}
+
+class SplitFramebuffer : public testing::Test {
+   protected:
+    void SetUp() override {
+        memset(master_frame, 0, sizeof(master_frame));
+        memset(master_shadow, 0x5A, sizeof(master_shadow));
+        memset(slave_frame, 0xA5, sizeof(slave_frame));
+        updates.clear();
+        random_state = 1;
+        ASSERT_TRUE(split_framebuffer_init(MASTER_CHANNEL, master_frame, master_shadow, FRAME_SIZE));
+        ASSERT_TRUE(split_framebuffer_init(SLAVE_CHANNEL, NULL, NULL, 0));
+    }
+
+    // Runs the link until the master has nothing left to send, returns the number of packets
+    size_t sync(void) {
+        split_framebuffer_packet_t packet;
+        size_t                     packets = 0;
+        while (split_framebuffer_next_packet(&packet)) {
+            EXPECT_EQ(packet.channel, MASTER_CHANNEL);
+            EXPECT_LE(packet.length, SPLIT_FRAMEBUFFER_PACKET_SIZE);
+            split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+            split_framebuffer_packet_sent(&packet, true);
+            if (++packets > FRAME_SIZE) {
+                ADD_FAILURE() << "sync does not converge";
+                break;
+            }
+        }
+        return packets;
+    }
+
+    void expect_in_sync(void) {
+        ASSERT_EQ(memcmp(master_frame, slave_frame, FRAME_SIZE), 0);
+        ASSERT_EQ(memcmp(master_frame, master_shadow, FRAME_SIZE), 0);
+    }
+};
+
+TEST_F(SplitFramebuffer, FirstSyncSendsEverything) {
+    // A blank frame compresses into a handful of repeat tokens
+    EXPECT_EQ(sync(), 1u);
+    expect_in_sync();
+    EXPECT_EQ(sync(), 0u);
+}
+
+TEST_F(SplitFramebuffer, SparseChangesAreCompressed) {
+    sync();
+    const uint16_t changes[] = {3, 4, 100, 101, 102, 103, 104, 105, 106, 107, 300, 511};
+    for (uint16_t offset : changes) {
+        master_frame[offset] = offset | 1;
+    }
+    EXPECT_EQ(sync(), 1u);
+    expect_in_sync();
+}
+
+TEST_F(SplitFramebuffer, NoisyFrameStillConverges) {
+    sync();
+    for (uint16_t i = 0; i < FRAME_SIZE; i++) {
+        master_frame[i] = next_random();
+    }
+    size_t packets = sync();
+    expect_in_sync();
+    // Incompressible data costs one token byte per 64 literal bytes
+    EXPECT_LE(packets, (FRAME_SIZE + SPLIT_FRAMEBUFFER_PACKET_SIZE - 3) / (SPLIT_FRAMEBUFFER_PACKET_SIZE - 1) + 1);
+}
+
+TEST_F(SplitFramebuffer, ChangesBehindTheCursorArePickedUp) {
+    sync();
+    for (uint16_t i = 0; i < FRAME_SIZE; i += 2) {
+        master_frame[i] = next_random() | 1;
+    }
+    split_framebuffer_packet_t packet;
+    ASSERT_TRUE(split_framebuffer_next_packet(&packet));
+    split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+    split_framebuffer_packet_sent(&packet, true);
+
+    // Change something before the position the master stopped at
+    master_frame[0] ^= 0xFF;
+    sync();
+    expect_in_sync();
+}
+
+TEST_F(SplitFramebuffer, RetriedPacketIsIdempotent) {
+    sync();
+    for (uint16_t i = 10; i < 40; i++) {
+        master_frame[i] = i;
+    }
+    split_framebuffer_packet_t packet;
+    ASSERT_TRUE(split_framebuffer_next_packet(&packet));
+    split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+    split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+    split_framebuffer_packet_sent(&packet, true);
+    EXPECT_EQ(sync(), 0u);
+    expect_in_sync();
+}
+
+TEST_F(SplitFramebuffer, FailedPacketResendsWholeFrame) {
+    for (uint16_t i = 0; i < FRAME_SIZE; i++) {
+        master_frame[i] = i & 0xF0;
+    }
+    sync();
+    expect_in_sync();
+
+    // The slave restarted, and the first packet after that was lost
+    memset(slave_frame, 0, sizeof(slave_frame));
+    master_frame[200] = 0xFF;
+    split_framebuffer_packet_t packet;
+    ASSERT_TRUE(split_framebuffer_next_packet(&packet));
+    split_framebuffer_packet_sent(&packet, false);
+
+    ASSERT_TRUE(split_framebuffer_next_packet(&packet));
+    EXPECT_EQ(packet.offset, 0);
+    split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+    split_framebuffer_packet_sent(&packet, true);
+    sync();
+    expect_in_sync();
+}
+
+TEST_F(SplitFramebuffer, LossyLinkConverges) {
+    sync();
+    for (int frame = 0; frame < 50; frame++) {
+        for (int i = 0; i < 20; i++) {
+            master_frame[next_random() % FRAME_SIZE] = next_random();
+        }
+        split_framebuffer_packet_t packet;
+        for (int i = 0; i < 3 && split_framebuffer_next_packet(&packet); i++) {
+            uint32_t outcome = next_random() % 4;
+            // 0: lost, 1: applied but the acknowledgement was lost, otherwise delivered
+            if (outcome != 0) {
+                split_framebuffer_decode(&packet, slave_frame, FRAME_SIZE);
+            }
+            split_framebuffer_packet_sent(&packet, outcome > 1);
+        }
+    }
+    sync();
+    expect_in_sync();
+}
+
+TEST_F(SplitFramebuffer, SlaveReportsUpdatedRange) {
+    static uint8_t slave_buffer[64];
+    ASSERT_TRUE(split_framebuffer_init(SLAVE_CHANNEL, slave_buffer, NULL, sizeof(slave_buffer)));
+
+    uint8_t                    source[64] = {0};
+    split_framebuffer_packet_t packet;
+    uint16_t                   cursor = 0;
+    source[5]                         = 1;
+    source[9]                         = 2;
+    ASSERT_TRUE(split_framebuffer_encode(source, slave_buffer, sizeof(source), &cursor, &packet));
+    packet.channel = SLAVE_CHANNEL;
+    split_framebuffer_receive(&packet);
+
+    cursor     = 0;
+    source[30] = 3;
+    ASSERT_TRUE(split_framebuffer_encode(source, slave_buffer, sizeof(source), &cursor, &packet));
+    packet.channel = SLAVE_CHANNEL;
+    split_framebuffer_receive(&packet);
+    EXPECT_TRUE(updates.empty());
+
+    split_framebuffer_task();
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].channel, SLAVE_CHANNEL);
+    EXPECT_EQ(updates[0].offset, 5);
+    EXPECT_EQ(updates[0].length, 26);
+    EXPECT_EQ(memcmp(source, slave_buffer, sizeof(source)), 0);
+
+    split_framebuffer_task();
+    EXPECT_EQ(updates.size(), 1u);
+}
+
+TEST_F(SplitFramebuffer, MalformedPacketStaysInBounds) {
+    static uint8_t slave_buffer[16];
+    ASSERT_TRUE(split_framebuffer_init(SLAVE_CHANNEL, slave_buffer, NULL, sizeof(slave_buffer)));
+
+    split_framebuffer_packet_t packet = {};
+    packet.channel                    = SLAVE_CHANNEL;
+    packet.offset                     = 10;
+    packet.length                     = 4;
+    packet.data[0]                    = 0xFF; // repeat 128 times
+    packet.data[1]                    = 0x77;
+    packet.data[2]                    = 0x7F; // literal, truncated
+    packet.data[3]                    = 0x11;
+    split_framebuffer_receive(&packet);
+    for (uint8_t i = 0; i < sizeof(slave_buffer); i++) {
+        EXPECT_EQ(slave_buffer[i], i < 10 ? 0 : 0x77);
+    }
+
+    packet.channel = SPLIT_FRAMEBUFFER_CHANNELS;
+    split_framebuffer_receive(&packet);
+    split_framebuffer_task();
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].length, 6);
+}
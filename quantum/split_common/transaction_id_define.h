@@ -78,6 +78,10 @@ enum serial_transaction_id {
     PUT_ST7565,
 #endif // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_FRAMEBUFFER_ENABLE
+    PUT_FRAMEBUFFER,
+#endif // SPLIT_FRAMEBUFFER_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
     GET_POINTING_CHECKSUM,
     GET_POINTING_DATA,
@@ -24,6 +24,7 @@
 #include "transactions.h"
 #include "transport.h"
 #include "split_util.h"
+#include "telemetry.h"
 #include "transaction_id_define.h"
 
 #define SYNC_TIMER_OFFSET 2
@@ -67,8 +68,10 @@ static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_
             this_okay = handler(master_matrix, slave_matrix);
         };
         if (this_okay) return true;
+        telemetry_count(TELEMETRY_SPLIT_RETRIES);
     }
     dprintf("Failed to execute %s\n", prefix);
+    telemetry_count(TELEMETRY_SPLIT_ERRORS);
     return false;
 }
 
@@ -586,6 +589,46 @@ static void st7565_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sla
 
 #endif // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+////////////////////////////////////////////////////
+// FRAMEBUFFER
+
+#ifdef SPLIT_FRAMEBUFFER_ENABLE
+
+static bool framebuffer_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t last_update = 0;
+    if (timer_elapsed32(last_update) < SPLIT_FRAMEBUFFER_INTERVAL) {
+        return true;
+    }
+
+    split_framebuffer_packet_t packet;
+    for (uint8_t i = 0; i < SPLIT_FRAMEBUFFER_PACKETS_PER_SYNC && split_framebuffer_next_packet(&packet); i++) {
+        bool okay = transport_write(PUT_FRAMEBUFFER, &packet, sizeof(packet));
+        split_framebuffer_packet_sent(&packet, okay);
+        if (!okay) {
+            return false;
+        }
+        last_update = timer_read32();
+    }
+    return true;
+}
+
+static void framebuffer_slave_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    split_framebuffer_receive((const split_framebuffer_packet_t *)initiator2target_buffer);
+}
+
+#    define TRANSACTIONS_FRAMEBUFFER_MASTER() TRANSACTION_HANDLER_MASTER(framebuffer)
+// Not run in an atomic block, the update callbacks may take a while
+#    define TRANSACTIONS_FRAMEBUFFER_SLAVE() split_framebuffer_task()
+#    define TRANSACTIONS_FRAMEBUFFER_REGISTRATIONS [PUT_FRAMEBUFFER] = trans_initiator2target_initializer_cb(framebuffer_packet, framebuffer_slave_callback),
+
+#else // SPLIT_FRAMEBUFFER_ENABLE
+
+#    define TRANSACTIONS_FRAMEBUFFER_MASTER()
+#    define TRANSACTIONS_FRAMEBUFFER_SLAVE()
+#    define TRANSACTIONS_FRAMEBUFFER_REGISTRATIONS
+
+#endif // SPLIT_FRAMEBUFFER_ENABLE
+
 ////////////////////////////////////////////////////
 // POINTING
 
@@ -689,6 +732,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_WPM_REGISTRATIONS
     TRANSACTIONS_OLED_REGISTRATIONS
     TRANSACTIONS_ST7565_REGISTRATIONS
+    TRANSACTIONS_FRAMEBUFFER_REGISTRATIONS
     TRANSACTIONS_POINTING_REGISTRATIONS
 // clang-format on
 
@@ -715,6 +759,7 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_WPM_MASTER();
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
+    TRANSACTIONS_FRAMEBUFFER_MASTER();
     TRANSACTIONS_POINTING_MASTER();
     return true;
 }
@@ -734,6 +779,7 @@ void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[
     TRANSACTIONS_WPM_SLAVE();
     TRANSACTIONS_OLED_SLAVE();
     TRANSACTIONS_ST7565_SLAVE();
+    TRANSACTIONS_FRAMEBUFFER_SLAVE();
     TRANSACTIONS_POINTING_SLAVE();
 }
 
@@ -106,6 +106,10 @@ typedef struct _split_mods_sync_t {
 } split_mods_sync_t;
 #endif // SPLIT_MODS_ENABLE
 
+#ifdef SPLIT_FRAMEBUFFER_ENABLE
+#    include "split_framebuffer.h"
+#endif // SPLIT_FRAMEBUFFER_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 #    include "pointing_device.h"
 typedef struct _split_slave_pointing_sync_t {
@@ -182,6 +186,10 @@ typedef struct _split_shared_memory_t {
     uint8_t current_st7565_state;
 #endif // ST7565_ENABLE(OLED_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_FRAMEBUFFER_ENABLE
+    split_framebuffer_packet_t framebuffer_packet;
+#endif // SPLIT_FRAMEBUFFER_ENABLE
+
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
     split_slave_pointing_sync_t pointing;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
@@ -0,0 +1,274 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "tapping_predict.h"
+#include "action_tapping.h"
+#include "eeprom.h"
+#include "timer.h"
+
+#ifdef DEBUG_ACTION
+#    include "debug.h"
+#else
+#    include "nodebug.h"
+#endif
+
+#define EEPROM_VERSION (0x80 | TAPPING_PREDICT_KEYS)
+#define DURATION_MAX (UINT16_MAX >> 4)
+
+_Static_assert(TAPPING_PREDICT_KEYS > 0 && TAPPING_PREDICT_KEYS < 0x80, "TAPPING_PREDICT_KEYS must be between 1 and 127");
+_Static_assert(1 + sizeof(tapping_predict_entry_t) * TAPPING_PREDICT_KEYS == EECONFIG_TAPPING_PREDICT_SIZE, "EECONFIG_TAPPING_PREDICT_SIZE does not match the statistics");
+
+static tapping_predict_entry_t   entries[TAPPING_PREDICT_KEYS];
+static tapping_predict_latency_t latency;
+static bool                      dirty;
+static uint32_t                  save_timer;
+
+// The tap-hold key whose press is being observed, independent of how it is resolved
+static struct {
+    keyrecord_t press;
+    keypos_t    other;
+    bool        active;
+    bool        overlapped;
+    bool        nested;
+} tracked;
+
+// The tap-hold key resolved as a tap while still pressed
+static struct {
+    keypos_t key;
+    tap_t    tap;
+    bool     active;
+} tapped;
+
+void tapping_predict_init(void) {
+    if (eeprom_read_byte(EECONFIG_TAPPING_PREDICT) == EEPROM_VERSION) {
+        eeprom_read_block(entries, EECONFIG_TAPPING_PREDICT + 1, sizeof(entries));
+    } else {
+        memset(entries, 0, sizeof(entries));
+    }
+    dirty      = false;
+    save_timer = timer_read32();
+}
+
+void tapping_predict_save(void) {
+    eeprom_update_block(entries, EECONFIG_TAPPING_PREDICT + 1, sizeof(entries));
+    eeprom_update_byte(EECONFIG_TAPPING_PREDICT, EEPROM_VERSION);
+    dirty      = false;
+    save_timer = timer_read32();
+}
+
+void tapping_predict_task(void) {
+    if (dirty && timer_elapsed32(save_timer) >= TAPPING_PREDICT_SAVE_INTERVAL) {
+        tapping_predict_save();
+    }
+}
+
+void tapping_predict_clear(void) {
+    memset(entries, 0, sizeof(entries));
+    memset(&tracked, 0, sizeof(tracked));
+    memset(&tapped, 0, sizeof(tapped));
+    tapping_predict_reset_latency();
+    dirty = true;
+}
+
+////////////////////////////////////////////////////
+// Statistics
+
+static uint16_t samples(const tapping_predict_entry_t *entry) {
+    return entry->taps + entry->holds + entry->rolls + entry->chords;
+}
+
+static tapping_predict_entry_t *find_entry(keypos_t key) {
+    for (uint8_t i = 0; i < TAPPING_PREDICT_KEYS; i++) {
+        if (KEYEQ(entries[i].key, key) && samples(&entries[i])) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Replaces the entry with the fewest samples when the key has none yet
+static tapping_predict_entry_t *get_entry(keypos_t key) {
+    tapping_predict_entry_t *entry = find_entry(key);
+    if (!entry) {
+        entry = &entries[0];
+        for (uint8_t i = 1; i < TAPPING_PREDICT_KEYS; i++) {
+            if (samples(&entries[i]) < samples(entry)) {
+                entry = &entries[i];
+            }
+        }
+        memset(entry, 0, sizeof(*entry));
+        entry->key = key;
+    }
+    return entry;
+}
+
+static void count(tapping_predict_entry_t *entry, uint8_t *counter) {
+    if (*counter == UINT8_MAX) {
+        // Halve all counts, so older presses weigh less
+        entry->taps >>= 1;
+        entry->holds >>= 1;
+        entry->rolls >>= 1;
+        entry->chords >>= 1;
+    }
+    (*counter)++;
+}
+
+// Exponentially weighted mean and mean absolute deviation, 1/8 weight for the new sample
+static void add_tap_duration(tapping_predict_entry_t *entry, uint16_t duration) {
+    int32_t sample = (int32_t)(duration < DURATION_MAX ? duration : DURATION_MAX) << 4;
+    if (!entry->taps) {
+        entry->tap_mean      = sample;
+        entry->tap_deviation = sample / 4;
+        return;
+    }
+    int32_t diff = sample - entry->tap_mean;
+    entry->tap_mean += diff / 8;
+    entry->tap_deviation += ((diff < 0 ? -diff : diff) - entry->tap_deviation) / 8;
+}
+
+static uint16_t tapping_term(keyrecord_t *record) {
+#ifdef TAPPING_TERM_PER_KEY
+    return get_tapping_term(get_record_keycode(record, false), record);
+#else
+    return g_tapping_term;
+#endif
+}
+
+// Classifies a press by what happened while the key was down, as the fixed term would have resolved it
+static void classify(uint16_t duration) {
+    tapping_predict_entry_t *entry = get_entry(tracked.press.event.key);
+    if (tracked.nested) {
+        count(entry, &entry->chords);
+    } else if (duration < tapping_term(&tracked.press)) {
+        add_tap_duration(entry, duration);
+        count(entry, &entry->taps);
+        if (tracked.overlapped) {
+            count(entry, &entry->rolls);
+        }
+    } else if (!tracked.overlapped) {
+        count(entry, &entry->holds);
+    } else {
+        return;
+    }
+    dirty = true;
+}
+
+void tapping_predict_event(keyrecord_t *record) {
+    keyevent_t event = record->event;
+    if (IS_NOEVENT(event)) {
+        return;
+    }
+
+    if (tapped.active && !event.pressed && KEYEQ(event.key, tapped.key)) {
+        // Releases the tap registered by the early decision
+        record->tap   = tapped.tap;
+        tapped.active = false;
+    }
+
+    if (!tracked.active) {
+        if (event.pressed && is_tap_record(record)) {
+            tracked.press      = *record;
+            tracked.active     = true;
+            tracked.overlapped = false;
+            tracked.nested     = false;
+        }
+        return;
+    }
+
+    if (KEYEQ(event.key, tracked.press.event.key)) {
+        if (!event.pressed) {
+            classify(TIMER_DIFF_16(event.time, tracked.press.event.time));
+            tracked.active = false;
+        }
+    } else if (event.pressed) {
+        if (!tracked.overlapped) {
+            tracked.other      = event.key;
+            tracked.overlapped = true;
+        }
+    } else if (tracked.overlapped && KEYEQ(event.key, tracked.other)) {
+        tracked.nested = true;
+    }
+}
+
+////////////////////////////////////////////////////
+// Prediction
+
+uint16_t tapping_predict_term(keyrecord_t *tapping_key) {
+    const tapping_predict_entry_t *entry = find_entry(tapping_key->event.key);
+    // Only keys that are actually held get a shorter term
+    if (!entry || entry->taps < TAPPING_PREDICT_MIN_SAMPLES || !(entry->holds + entry->chords)) {
+        return UINT16_MAX;
+    }
+
+    uint32_t term = ((uint32_t)entry->tap_mean + (uint32_t)TAPPING_PREDICT_DEVIATIONS * entry->tap_deviation) / 16 + TAPPING_PREDICT_MARGIN;
+    if (term < TAPPING_PREDICT_MIN_TERM) {
+        term = TAPPING_PREDICT_MIN_TERM;
+    }
+    return term < UINT16_MAX ? term : UINT16_MAX;
+}
+
+tapping_predict_t tapping_predict_interrupt(keyrecord_t *tapping_key) {
+    const tapping_predict_entry_t *entry = find_entry(tapping_key->event.key);
+    if (!entry) {
+        return TAPPING_PREDICT_NONE;
+    }
+
+    uint16_t overlaps = entry->rolls + entry->chords;
+    if (overlaps < TAPPING_PREDICT_MIN_SAMPLES) {
+        return TAPPING_PREDICT_NONE;
+    }
+    if ((uint32_t)entry->rolls * 100 >= (uint32_t)overlaps * TAPPING_PREDICT_CONFIDENCE) {
+        return TAPPING_PREDICT_TAP;
+    }
+    if ((uint32_t)entry->chords * 100 >= (uint32_t)overlaps * TAPPING_PREDICT_CONFIDENCE) {
+        return TAPPING_PREDICT_HOLD;
+    }
+    return TAPPING_PREDICT_NONE;
+}
+
+void tapping_predict_tapped(keyrecord_t *tapping_key) {
+    tapped.key    = tapping_key->event.key;
+    tapped.tap    = tapping_key->tap;
+    tapped.active = true;
+}
+
+void tapping_predict_decided(keyrecord_t *tapping_key, uint16_t time, bool predicted) {
+    uint16_t elapsed = TIMER_DIFF_16(time, tapping_key->event.time);
+
+    if (latency.decisions < UINT16_MAX) {
+        latency.decisions++;
+        latency.predicted += predicted;
+        latency.total += elapsed;
+    }
+    latency.last = elapsed;
+    if (elapsed > latency.max) {
+        latency.max = elapsed;
+    }
+    dprintf("Tapping: Decided after %u ms%s\n", elapsed, predicted ? ", predicted" : "");
+}
+
+const tapping_predict_entry_t *tapping_predict_get_entry(keypos_t key) {
+    return find_entry(key);
+}
+
+const tapping_predict_latency_t *tapping_predict_get_latency(void) {
+    return &latency;
+}
+
+void tapping_predict_reset_latency(void) {
+    memset(&latency, 0, sizeof(latency));
+}
@@ -0,0 +1,94 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "action.h"
+#include "eeconfig.h"
+
+/* Samples of a key needed before its decisions are predicted */
+#ifndef TAPPING_PREDICT_MIN_SAMPLES
+#    define TAPPING_PREDICT_MIN_SAMPLES 16
+#endif
+
+/* Share of rolls, or chords, in percent needed to resolve on the press of another key */
+#ifndef TAPPING_PREDICT_CONFIDENCE
+#    define TAPPING_PREDICT_CONFIDENCE 95
+#endif
+
+/* Mean absolute deviations above the mean tap duration after which a press is a hold */
+#ifndef TAPPING_PREDICT_DEVIATIONS
+#    define TAPPING_PREDICT_DEVIATIONS 4
+#endif
+
+/* Added to the predicted term, in ms */
+#ifndef TAPPING_PREDICT_MARGIN
+#    define TAPPING_PREDICT_MARGIN 20
+#endif
+
+/* Shortest predicted term, in ms */
+#ifndef TAPPING_PREDICT_MIN_TERM
+#    define TAPPING_PREDICT_MIN_TERM 80
+#endif
+
+/* How often changed statistics are written to EEPROM, in ms */
+#ifndef TAPPING_PREDICT_SAVE_INTERVAL
+#    define TAPPING_PREDICT_SAVE_INTERVAL 600000
+#endif
+
+typedef enum {
+    TAPPING_PREDICT_NONE,
+    TAPPING_PREDICT_TAP,
+    TAPPING_PREDICT_HOLD,
+} tapping_predict_t;
+
+/* Statistics of one tap-hold key, durations in 1/16 ms */
+typedef struct {
+    keypos_t key;
+    uint16_t tap_mean;
+    uint16_t tap_deviation;
+    uint8_t  taps;   // presses released within the tapping term, no other key nested
+    uint8_t  holds;  // presses held past the tapping term, alone
+    uint8_t  rolls;  // another key pressed, and still down when this one is released
+    uint8_t  chords; // another key pressed and released while this one is down
+} tapping_predict_entry_t;
+
+/* Time from the press of a tap-hold key to its tap or hold decision, in ms */
+typedef struct {
+    uint16_t decisions;
+    uint16_t predicted; // decisions made before the tapping term from the statistics
+    uint16_t last;
+    uint16_t max;
+    uint32_t total;
+} tapping_predict_latency_t;
+
+void tapping_predict_init(void);
+void tapping_predict_task(void);
+void tapping_predict_clear(void);
+void tapping_predict_save(void);
+
+/* Called by action_tapping */
+void              tapping_predict_event(keyrecord_t *record);
+uint16_t          tapping_predict_term(keyrecord_t *tapping_key);
+tapping_predict_t tapping_predict_interrupt(keyrecord_t *tapping_key);
+void              tapping_predict_tapped(keyrecord_t *tapping_key);
+void              tapping_predict_decided(keyrecord_t *tapping_key, uint16_t time, bool predicted);
+
+const tapping_predict_entry_t *  tapping_predict_get_entry(keypos_t key);
+const tapping_predict_latency_t *tapping_predict_get_latency(void);
+void                             tapping_predict_reset_latency(void);
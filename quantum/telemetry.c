@@ -0,0 +1,177 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "telemetry.h"
+#include "timer.h"
+
+#ifdef TELEMETRY_ENABLE
+#    include "raw_hid.h"
+#endif
+
+static uint8_t *telemetry_put(uint8_t *packet, uint32_t value, uint8_t size) {
+    while (size--) {
+        *packet++ = value >> (8 * size);
+    }
+    return packet;
+}
+
+static const uint8_t *telemetry_get(const uint8_t *packet, uint32_t *value, uint8_t size) {
+    *value = 0;
+    while (size--) {
+        *value = (*value << 8) | *packet++;
+    }
+    return packet;
+}
+
+void telemetry_report_encode(const telemetry_report_t *report, uint8_t *packet) {
+    memset(packet, 0, TELEMETRY_PACKET_SIZE);
+
+    uint8_t *p = telemetry_put(packet, TELEMETRY_REPORT_ID, 1);
+    p          = telemetry_put(p, report->sequence, 1);
+    p          = telemetry_put(p, report->period, 2);
+    p          = telemetry_put(p, report->scan_rate, 4);
+    for (uint8_t i = 0; i < TELEMETRY_TIMING_COUNT; i++) {
+        p = telemetry_put(p, report->timing[i], 2);
+    }
+    for (uint8_t i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+        p = telemetry_put(p, report->counter[i], 2);
+    }
+}
+
+bool telemetry_report_decode(const uint8_t *packet, telemetry_report_t *report) {
+    uint32_t value;
+
+    if (packet[0] != TELEMETRY_REPORT_ID) {
+        return false;
+    }
+
+    const uint8_t *p = telemetry_get(&packet[1], &value, 1);
+    report->sequence = value;
+    p                = telemetry_get(p, &value, 2);
+    report->period   = value;
+    p                = telemetry_get(p, &report->scan_rate, 4);
+    for (uint8_t i = 0; i < TELEMETRY_TIMING_COUNT; i++) {
+        p                 = telemetry_get(p, &value, 2);
+        report->timing[i] = value;
+    }
+    for (uint8_t i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+        p                  = telemetry_get(p, &value, 2);
+        report->counter[i] = value;
+    }
+    return true;
+}
+
+_Static_assert(1 + 1 + 2 + 4 + 2 * TELEMETRY_TIMING_COUNT + 2 * TELEMETRY_COUNTER_COUNT <= TELEMETRY_PACKET_SIZE, "Telemetry report does not fit into a packet");
+
+#ifdef TELEMETRY_ENABLE
+static uint16_t telemetry_interval = 0;
+static uint16_t telemetry_last_report;
+static uint8_t  telemetry_sequence;
+static uint32_t telemetry_scans;
+static uint32_t telemetry_last_loop;
+static uint16_t telemetry_timing[TELEMETRY_TIMING_COUNT];
+static uint16_t telemetry_counter[TELEMETRY_COUNTER_COUNT];
+
+static void telemetry_reset(void) {
+    telemetry_last_report = timer_read();
+    telemetry_scans       = 0;
+    memset(telemetry_timing, 0, sizeof(telemetry_timing));
+    memset(telemetry_counter, 0, sizeof(telemetry_counter));
+}
+
+void telemetry_subscribe(uint16_t interval) {
+    if (interval != 0 && interval < TELEMETRY_MIN_INTERVAL) {
+        interval = TELEMETRY_MIN_INTERVAL;
+    }
+    telemetry_interval  = interval;
+    telemetry_sequence  = 0;
+    telemetry_last_loop = timer_read_us();
+    telemetry_reset();
+}
+
+/* Handles a raw HID command, returns false if it isn't a telemetry one.
+ * Keyboards not using VIA can call this from raw_hid_receive().
+ */
+bool telemetry_process_command(uint8_t *data, uint8_t length) {
+    if (length < 4 || data[0] != TELEMETRY_SUBSCRIBE_ID) {
+        return false;
+    }
+    telemetry_subscribe((data[1] << 8) | data[2]);
+    data[3] = 0x00;
+    return true;
+}
+
+void telemetry_count(uint8_t counter) {
+    if (telemetry_counter[counter] < UINT16_MAX) {
+        telemetry_counter[counter]++;
+    }
+}
+
+/* A start of TELEMETRY_NOT_TIMED was taken before the host subscribed, the
+ * interval it closes is not sampled rather than reported from time 0. */
+uint32_t telemetry_time_start(void) {
+    if (!telemetry_interval) {
+        return TELEMETRY_NOT_TIMED;
+    }
+    uint32_t now = timer_read_us();
+    return now != TELEMETRY_NOT_TIMED ? now : now + 1;
+}
+
+void telemetry_time_end(uint8_t timing, uint32_t start) {
+    if (!telemetry_interval || start == TELEMETRY_NOT_TIMED) {
+        return;
+    }
+    uint32_t elapsed = timer_elapsed_us(start);
+    if (elapsed > UINT16_MAX) {
+        elapsed = UINT16_MAX;
+    }
+    if (elapsed > telemetry_timing[timing]) {
+        telemetry_timing[timing] = elapsed;
+    }
+}
+
+/* Called at the end of every keyboard_task(), so the time between two
+ * calls is the loop time. */
+void telemetry_task(void) {
+    if (!telemetry_interval) {
+        return;
+    }
+
+    telemetry_time_end(TELEMETRY_LOOP, telemetry_last_loop);
+
+    uint16_t period = timer_elapsed(telemetry_last_report);
+    if (period >= telemetry_interval) {
+        telemetry_report_t report = {
+            .sequence  = telemetry_sequence++,
+            .period    = period,
+            .scan_rate = (uint64_t)telemetry_scans * 1000 / period,
+        };
+        memcpy(report.timing, telemetry_timing, sizeof(report.timing));
+        memcpy(report.counter, telemetry_counter, sizeof(report.counter));
+        telemetry_reset();
+
+        uint8_t packet[TELEMETRY_PACKET_SIZE];
+        telemetry_report_encode(&report, packet);
+        raw_hid_send(packet, sizeof(packet));
+    }
+
+    /* The scan that closes a period is counted in the next one. Sending
+     * may block, so keep it out of the next loop time as well. */
+    telemetry_scans++;
+    telemetry_last_loop = timer_read_us();
+}
+#endif
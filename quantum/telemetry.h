@@ -0,0 +1,90 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Telemetry pushes a report of performance counters over raw HID every
+ * subscribed interval, for monitoring a keyboard without the console.
+ *
+ * Subscribe:  [TELEMETRY_SUBSCRIBE_ID, interval (2)] -> [..., status]
+ *             An interval of 0 unsubscribes.
+ * Report:     [TELEMETRY_REPORT_ID, sequence, period (2), scan rate (4),
+ *              timings (2 each), counters (2 each)]
+ *
+ * Values are big endian like the rest of the VIA protocol. Timings are
+ * the maximum in microseconds and counters the number of events during
+ * the period, both saturating.
+ */
+#define TELEMETRY_SUBSCRIBE_ID 0xF3
+#define TELEMETRY_REPORT_ID 0xF4
+#define TELEMETRY_PACKET_SIZE 32
+
+// telemetry_time_start() while not subscribed
+#define TELEMETRY_NOT_TIMED 0
+
+#ifndef TELEMETRY_MIN_INTERVAL
+#    define TELEMETRY_MIN_INTERVAL 100
+#endif
+
+enum telemetry_timing {
+    TELEMETRY_LOOP,
+    TELEMETRY_MATRIX_SCAN,
+    TELEMETRY_QUANTUM_TASKS,
+    TELEMETRY_LIGHTING,
+    TELEMETRY_RGB_FRAME,
+    TELEMETRY_TIMING_COUNT,
+};
+
+enum telemetry_counter {
+    TELEMETRY_USB_REPORTS,
+    TELEMETRY_SPLIT_ERRORS,
+    TELEMETRY_SPLIT_RETRIES,
+    TELEMETRY_EEPROM_WRITES,
+    TELEMETRY_RGB_FRAMES,
+    TELEMETRY_COUNTER_COUNT,
+};
+
+typedef struct {
+    uint8_t  sequence;
+    uint16_t period;
+    uint32_t scan_rate;
+    uint16_t timing[TELEMETRY_TIMING_COUNT];
+    uint16_t counter[TELEMETRY_COUNTER_COUNT];
+} telemetry_report_t;
+
+/* The packet format, also meant for host side decoding. */
+void telemetry_report_encode(const telemetry_report_t *report, uint8_t *packet);
+bool telemetry_report_decode(const uint8_t *packet, telemetry_report_t *report);
+
+#ifdef TELEMETRY_ENABLE
+void telemetry_task(void);
+bool telemetry_process_command(uint8_t *data, uint8_t length);
+void telemetry_subscribe(uint16_t interval);
+
+void     telemetry_count(uint8_t counter);
+uint32_t telemetry_time_start(void);
+void     telemetry_time_end(uint8_t timing, uint32_t start);
+#else
+/* Instrumented code calls these unconditionally. */
+static inline void telemetry_count(uint8_t counter) {}
+static inline uint32_t telemetry_time_start(void) {
+    return TELEMETRY_NOT_TIMED;
+}
+static inline void telemetry_time_end(uint8_t timing, uint32_t start) {}
+#endif
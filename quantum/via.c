@@ -44,6 +44,8 @@
 
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
+#include "crc.h"
+#include "telemetry.h"
 #include "eeprom.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
@@ -184,6 +186,135 @@ bool process_record_via(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+typedef struct {
+    uint8_t  region;
+    uint8_t  direction;
+    uint8_t  sequence;
+    uint8_t  crc;
+    uint8_t  status;
+    bool     active;
+    uint16_t offset;
+    uint16_t remaining;
+    uint16_t staged;
+    uint8_t  buffer[VIA_BULK_WRITE_BUFFER_SIZE];
+} via_bulk_transfer_t;
+
+static via_bulk_transfer_t bulk;
+
+static uint16_t via_bulk_region_size(uint8_t region) {
+    switch (region) {
+        case id_bulk_region_keymap:
+            return dynamic_keymap_get_buffer_size();
+        case id_bulk_region_macro:
+            return dynamic_keymap_macro_get_buffer_size();
+        default:
+            return 0;
+    }
+}
+
+// Writes the gathered bytes, which end at the current offset, as one block.
+static void via_bulk_flush(void) {
+    uint16_t offset = bulk.offset - bulk.staged;
+    if (bulk.region == id_bulk_region_keymap) {
+        dynamic_keymap_set_buffer(offset, bulk.staged, bulk.buffer);
+    } else {
+        dynamic_keymap_macro_set_buffer(offset, bulk.staged, bulk.buffer);
+    }
+    bulk.staged = 0;
+}
+
+static uint8_t via_bulk_begin(uint8_t region, uint8_t direction, uint16_t offset, uint16_t size) {
+    // Keep what an abandoned write already received.
+    if (bulk.active && bulk.direction == id_bulk_write) {
+        via_bulk_flush();
+    }
+
+    uint16_t region_size = via_bulk_region_size(region);
+    if (region_size == 0 || direction > id_bulk_write || offset > region_size || size > region_size - offset) {
+        bulk.active = false;
+        return id_bulk_invalid;
+    }
+
+    bulk = (via_bulk_transfer_t){
+        .region    = region,
+        .direction = direction,
+        .crc       = 0xFF,
+        .status    = id_bulk_ok,
+        .active    = true,
+        .offset    = offset,
+        .remaining = size,
+    };
+    return id_bulk_ok;
+}
+
+static void via_bulk_write(uint8_t sequence, uint8_t *payload) {
+    if (!bulk.active || bulk.direction != id_bulk_write || bulk.status != id_bulk_ok) {
+        return;
+    }
+    if (sequence != bulk.sequence++) {
+        bulk.status = id_bulk_sequence_error;
+        return;
+    }
+
+    uint8_t length = bulk.remaining < VIA_BULK_PAYLOAD_SIZE ? bulk.remaining : VIA_BULK_PAYLOAD_SIZE;
+    bulk.crc       = crc8_update(bulk.crc, payload, length);
+    for (uint8_t i = 0; i < length; i++) {
+        bulk.buffer[bulk.staged++] = payload[i];
+        bulk.offset++;
+        if (bulk.staged == VIA_BULK_WRITE_BUFFER_SIZE) {
+            via_bulk_flush();
+        }
+    }
+    bulk.remaining -= length;
+}
+
+// Also aborts a bulk read that is still being streamed.
+static uint8_t via_bulk_write_end(uint8_t crc) {
+    if (!bulk.active || bulk.direction != id_bulk_write) {
+        bulk.active = false;
+        return id_bulk_invalid;
+    }
+
+    via_bulk_flush();
+    bulk.active = false;
+    if (bulk.status == id_bulk_ok && bulk.remaining > 0) {
+        bulk.status = id_bulk_invalid;
+    }
+    if (bulk.status == id_bulk_ok && crc != bulk.crc) {
+        bulk.status = id_bulk_crc_error;
+    }
+    return bulk.status;
+}
+
+// Streams the packets of a bulk read, one per call so the rest of the
+// keyboard keeps running. The endpoint paces it to the USB polling rate.
+void via_task(void) {
+    if (!bulk.active || bulk.direction != id_bulk_read) {
+        return;
+    }
+
+    uint8_t data[VIA_BULK_PAYLOAD_SIZE + 2] = {0};
+    if (bulk.remaining == 0) {
+        data[0]     = id_dynamic_keymap_bulk_end;
+        data[1]     = bulk.status;
+        data[2]     = bulk.crc;
+        bulk.active = false;
+    } else {
+        uint8_t length = bulk.remaining < VIA_BULK_PAYLOAD_SIZE ? bulk.remaining : VIA_BULK_PAYLOAD_SIZE;
+        data[0]        = id_dynamic_keymap_bulk_data;
+        data[1]        = bulk.sequence++;
+        if (bulk.region == id_bulk_region_keymap) {
+            dynamic_keymap_get_buffer(bulk.offset, length, &data[2]);
+        } else {
+            dynamic_keymap_macro_get_buffer(bulk.offset, length, &data[2]);
+        }
+        bulk.crc = crc8_update(bulk.crc, &data[2], length);
+        bulk.offset += length;
+        bulk.remaining -= length;
+    }
+    raw_hid_send(data, sizeof(data));
+}
+
 // Keyboard level code can override this to handle custom messages from VIA.
 // See raw_hid_receive() implementation.
 // DO NOT call raw_hid_send() in the override function.
@@ -377,6 +508,31 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+        case id_dynamic_keymap_bulk_begin: {
+            uint16_t offset = (command_data[2] << 8) | command_data[3];
+            uint16_t size   = (command_data[4] << 8) | command_data[5];
+            command_data[6] = via_bulk_begin(command_data[0], command_data[1], offset, size);
+            command_data[7] = VIA_BULK_PAYLOAD_SIZE;
+            break;
+        }
+        case id_dynamic_keymap_bulk_data: {
+            // Not acknowledged, so the host can send these back to back.
+            // Errors are reported by bulk_end.
+            via_bulk_write(command_data[0], &command_data[1]);
+            return;
+        }
+        case id_dynamic_keymap_bulk_end: {
+            uint8_t crc     = command_data[0];
+            command_data[0] = via_bulk_write_end(crc);
+            command_data[1] = bulk.crc;
+            break;
+        }
+#ifdef TELEMETRY_ENABLE
+        case id_telemetry_subscribe: {
+            telemetry_process_command(data, length);
+            break;
+        }
+#endif
         default: {
             // The command ID is not known
             // Return the unhandled state
@@ -56,7 +56,7 @@
 
 // This is changed only when the command IDs change,
 // so VIA Configurator can detect compatible firmware.
-#define VIA_PROTOCOL_VERSION 0x0009
+#define VIA_PROTOCOL_VERSION 0x000A
 
 enum via_command_id {
     id_get_protocol_version                 = 0x01, // always 0x01
@@ -78,9 +78,50 @@ enum via_command_id {
     id_dynamic_keymap_get_layer_count       = 0x11,
     id_dynamic_keymap_get_buffer            = 0x12,
     id_dynamic_keymap_set_buffer            = 0x13,
+    // QMK extensions, kept clear of the IDs VIA assigns upwards from 0x01
+    id_dynamic_keymap_bulk_begin            = 0xF0,
+    id_dynamic_keymap_bulk_data             = 0xF1,
+    id_dynamic_keymap_bulk_end              = 0xF2,
+    id_telemetry_subscribe                  = 0xF3, // TELEMETRY_SUBSCRIBE_ID
+    id_telemetry_report                     = 0xF4, // TELEMETRY_REPORT_ID, sent by the keyboard
     id_unhandled                            = 0xFF,
 };
 
+// Bulk transfers move a whole region (keymap or macro buffer) in a stream of
+// packets the host doesn't have to wait for individually:
+//
+// bulk_begin: [region, direction, offset (2), size (2)] -> [..., status, payload size]
+// bulk_data:  [sequence, payload...], no reply for writes
+// bulk_end:   [crc8] -> [status, crc8] for writes, sent unprompted after the last
+//             data packet for reads
+//
+// Sequence numbers start at 0 and wrap. The CRC8 (quantum/crc.c) covers the
+// payload bytes of the whole transfer.
+enum via_bulk_region {
+    id_bulk_region_keymap = 0x00,
+    id_bulk_region_macro  = 0x01,
+};
+
+enum via_bulk_direction {
+    id_bulk_read  = 0x00,
+    id_bulk_write = 0x01,
+};
+
+enum via_bulk_status {
+    id_bulk_ok             = 0x00,
+    id_bulk_invalid        = 0x01,
+    id_bulk_sequence_error = 0x02,
+    id_bulk_crc_error      = 0x03,
+};
+
+// Payload bytes per bulk_data packet, after the command id and sequence number.
+#define VIA_BULK_PAYLOAD_SIZE 30
+
+// Bulk writes are gathered into blocks of this size before being written to EEPROM.
+#ifndef VIA_BULK_WRITE_BUFFER_SIZE
+#    define VIA_BULK_WRITE_BUFFER_SIZE 64
+#endif
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01, //
     id_layout_options      = 0x02,
@@ -155,6 +196,7 @@ void via_eeprom_set_valid(bool valid);
 // Called by QMK core to initialize dynamic keymaps etc.
 void eeconfig_init_via(void);
 void via_init(void);
+void via_task(void);
 
 // Used by VIA to store and retrieve the layout options.
 uint32_t via_get_layout_options(void);
@@ -312,3 +312,102 @@ TEST_F(KeyPress, PressEqualPlusDontReleaseBeforePress) {
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
+
+TEST_F(KeyPress, UnchangedReportIsNotSentAgain) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a       = KeymapKey(0, 0, 0, KC_A);
+    auto       other_key_a = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({key_a, other_key_a});
+
+    key_a.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The key is released first, so the host sees a new press
+    other_key_a.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_a.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    other_key_a.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyPress, SeventhKeyIsDroppedFromAFullReport) {
+    TestDriver             driver;
+    std::vector<KeymapKey> keys;
+
+    set_keymap({});
+    for (uint8_t i = 0; i < 7; i++) {
+        keys.push_back(KeymapKey(0, i, 0, KC_A + i));
+        add_key(keys.back());
+    }
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    for (auto &key : keys) {
+        key.press();
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    keys[0].release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C, KC_D, KC_E, KC_F)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    keys[6].release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(5);
+    for (uint8_t i = 1; i < 6; i++) {
+        keys[i].release();
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyPress, OtherReportsDoNotAffectTheKeyboardReport) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    key_a.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The helpers tell whether the report they were given changed
+    report_keyboard_t other_report = {};
+    EXPECT_TRUE(add_key_to_report(&other_report, KC_B));
+    EXPECT_FALSE(add_key_to_report(&other_report, KC_B));
+    EXPECT_FALSE(is_key_pressed(&other_report, KC_A));
+    EXPECT_TRUE(add_key_to_report(&other_report, KC_A));
+    EXPECT_TRUE(del_key_from_report(&other_report, KC_A));
+    EXPECT_FALSE(del_key_from_report(&other_report, KC_A));
+    EXPECT_TRUE(clear_keys_from_report(&other_report));
+    EXPECT_FALSE(clear_keys_from_report(&other_report));
+
+    EXPECT_TRUE(is_key_pressed(keyboard_report, KC_A));
+    EXPECT_FALSE(is_key_pressed(keyboard_report, KC_B));
+    EXPECT_EQ(has_anykey(keyboard_report), 1);
+
+    key_a.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
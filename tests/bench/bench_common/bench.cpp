@@ -0,0 +1,356 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <regex.h>
+
+extern "C" {
+#include "debug.h"
+
+int8_t sendchar(uint8_t c) {
+    return 0;
+}
+
+__attribute__((weak)) debug_config_t debug_config = {0};
+}
+
+namespace bench {
+
+namespace {
+
+struct Run {
+    std::string name;
+    std::string run_name;
+    std::string aggregate;
+    uint64_t    iterations;
+    uint64_t    repetition;
+    double      real_ns;
+    double      cpu_ns;
+    double      items_per_second;
+    double      bytes_per_second;
+    std::string label;
+};
+
+struct Options {
+    regex_t     filter;
+    bool        has_filter  = false;
+    std::string json;
+    double      min_time    = 0.1;
+    uint64_t    repetitions = 1;
+    bool        list        = false;
+};
+
+std::vector<Benchmark *> &benchmarks(void) {
+    static std::vector<Benchmark *> list;
+    return list;
+}
+
+State run_once(Function function, uint64_t iterations, int64_t arg) {
+    State state(iterations, arg);
+    function(state);
+    return state;
+}
+
+// Grow the iteration count until a run takes at least min_time, like Google Benchmark does
+uint64_t calibrate(Function function, int64_t arg, double min_time) {
+    uint64_t iterations = 1;
+    while (true) {
+        State  state   = run_once(function, iterations, arg);
+        double seconds = std::max(state.real_seconds(), state.cpu_seconds());
+        if (seconds >= min_time || iterations >= 1000000000) {
+            return iterations;
+        }
+        double multiplier = seconds > min_time / 10 ? min_time * 1.4 / seconds : 10;
+        iterations        = std::max<uint64_t>(iterations + 1, uint64_t(iterations * std::min(multiplier, 10.0)));
+    }
+}
+
+Run make_run(const std::string &name, const State &state, uint64_t repetition) {
+    Run run;
+    run.name             = name;
+    run.run_name         = name;
+    run.iterations       = state.iterations();
+    run.repetition       = repetition;
+    run.real_ns          = state.real_seconds() * 1e9 / state.iterations();
+    run.cpu_ns           = state.cpu_seconds() * 1e9 / state.iterations();
+    run.items_per_second = state.items() && state.real_seconds() > 0 ? state.items() / state.real_seconds() : 0;
+    run.bytes_per_second = state.bytes() && state.real_seconds() > 0 ? state.bytes() / state.real_seconds() : 0;
+    run.label            = state.label();
+    return run;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// Adds the mean, median and stddev of the repetitions of one benchmark
+void add_aggregates(std::vector<Run> &runs, size_t first) {
+    size_t count = runs.size() - first;
+    if (count < 2) {
+        return;
+    }
+
+    std::vector<double> real, cpu, items, bytes;
+    for (size_t i = first; i < runs.size(); i++) {
+        real.push_back(runs[i].real_ns);
+        cpu.push_back(runs[i].cpu_ns);
+        items.push_back(runs[i].items_per_second);
+        bytes.push_back(runs[i].bytes_per_second);
+    }
+    auto mean = [](const std::vector<double> &values) {
+        double sum = 0;
+        for (double value : values) sum += value;
+        return sum / values.size();
+    };
+    auto stddev = [&](const std::vector<double> &values) {
+        double m = mean(values), sum = 0;
+        for (double value : values) sum += (value - m) * (value - m);
+        return std::sqrt(sum / (values.size() - 1));
+    };
+
+    Run base = runs[first];
+    base.repetition = 0;
+    base.label.clear();
+
+    Run run       = base;
+    run.aggregate = "mean";
+    run.real_ns   = mean(real);
+    run.cpu_ns    = mean(cpu);
+    run.items_per_second = mean(items);
+    run.bytes_per_second = mean(bytes);
+    runs.push_back(run);
+
+    run           = base;
+    run.aggregate = "median";
+    run.real_ns   = median(real);
+    run.cpu_ns    = median(cpu);
+    run.items_per_second = median(items);
+    run.bytes_per_second = median(bytes);
+    runs.push_back(run);
+
+    run           = base;
+    run.aggregate = "stddev";
+    run.real_ns   = stddev(real);
+    run.cpu_ns    = stddev(cpu);
+    run.items_per_second = stddev(items);
+    run.bytes_per_second = stddev(bytes);
+    runs.push_back(run);
+
+    for (size_t i = runs.size() - 3; i < runs.size(); i++) {
+        runs[i].name = runs[i].run_name + "_" + runs[i].aggregate;
+    }
+}
+
+void print_run(const Run &run) {
+    printf("%-48s %14.1f ns %14.1f ns %12llu", run.name.c_str(), run.real_ns, run.cpu_ns, (unsigned long long)run.iterations);
+    if (run.items_per_second) {
+        printf(" %10.3gM items/s", run.items_per_second / 1e6);
+    }
+    if (run.bytes_per_second) {
+        printf(" %10.3gMB/s", run.bytes_per_second / 1e6);
+    }
+    if (!run.label.empty()) {
+        printf(" %s", run.label.c_str());
+    }
+    printf("\n");
+}
+
+std::string json_string(const std::string &value) {
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+bool write_json(const std::string &path, const char *executable, const std::vector<Run> &runs, uint64_t repetitions) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    char   date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"date\": %s,\n", json_string(date).c_str());
+    fprintf(file, "    \"executable\": %s,\n", json_string(executable).c_str());
+    fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(file, "    \"library_build_type\": \"release\"\n");
+    fprintf(file, "  },\n  \"benchmarks\": [");
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run &run = runs[i];
+        fprintf(file, "%s\n    {\n", i ? "," : "");
+        fprintf(file, "      \"name\": %s,\n", json_string(run.name).c_str());
+        fprintf(file, "      \"run_name\": %s,\n", json_string(run.run_name).c_str());
+        fprintf(file, "      \"run_type\": \"%s\",\n", run.aggregate.empty() ? "iteration" : "aggregate");
+        fprintf(file, "      \"repetitions\": %llu,\n", (unsigned long long)repetitions);
+        if (run.aggregate.empty()) {
+            fprintf(file, "      \"repetition_index\": %llu,\n", (unsigned long long)run.repetition);
+        } else {
+            fprintf(file, "      \"aggregate_name\": \"%s\",\n", run.aggregate.c_str());
+        }
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)run.iterations);
+        fprintf(file, "      \"real_time\": %.6e,\n", run.real_ns);
+        fprintf(file, "      \"cpu_time\": %.6e,\n", run.cpu_ns);
+        if (run.items_per_second) {
+            fprintf(file, "      \"items_per_second\": %.6e,\n", run.items_per_second);
+        }
+        if (run.bytes_per_second) {
+            fprintf(file, "      \"bytes_per_second\": %.6e,\n", run.bytes_per_second);
+        }
+        if (!run.label.empty()) {
+            fprintf(file, "      \"label\": %s,\n", json_string(run.label).c_str());
+        }
+        fprintf(file, "      \"time_unit\": \"ns\"\n    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+// The value of --<name>=<value>, or of the Google Benchmark spelling --benchmark_<name>=<value>
+const char *option_value(const char *arg, const char *name, const char *benchmark_name) {
+    size_t length = strlen(name);
+    if (strncmp(arg, "--", 2) == 0 && strncmp(arg + 2, name, length) == 0 && arg[2 + length] == '=') {
+        return arg + 3 + length;
+    }
+    length = strlen(benchmark_name);
+    if (strncmp(arg, "--benchmark_", 12) == 0 && strncmp(arg + 12, benchmark_name, length) == 0 && arg[12 + length] == '=') {
+        return arg + 13 + length;
+    }
+    return NULL;
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value;
+        bool        okay = true;
+        if ((value = option_value(arg, "filter", "filter"))) {
+            if (options.has_filter) {
+                regfree(&options.filter);
+            }
+            options.has_filter = regcomp(&options.filter, value, REG_EXTENDED | REG_NOSUB) == 0;
+            okay               = options.has_filter;
+        } else if ((value = option_value(arg, "json", "out"))) {
+            options.json = value;
+        } else if ((value = option_value(arg, "out_format", "out_format"))) {
+            okay = strcmp(value, "json") == 0;
+        } else if ((value = option_value(arg, "format", "format"))) {
+            okay = strcmp(value, "console") == 0;
+        } else if ((value = option_value(arg, "min_time", "min_time"))) {
+            // Google Benchmark takes a trailing s for seconds, a trailing x for iterations is not supported
+            char *unit;
+            options.min_time = strtod(value, &unit);
+            okay             = unit != value && (*unit == '\0' || strcmp(unit, "s") == 0);
+        } else if ((value = option_value(arg, "repetitions", "repetitions"))) {
+            options.repetitions = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--list") == 0 || strcmp(arg, "--benchmark_list_tests") == 0) {
+            options.list = true;
+        } else if ((value = option_value(arg, "list", "list_tests"))) {
+            options.list = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            okay = false;
+        }
+        if (!okay) {
+            if (value) {
+                fprintf(stderr, "Invalid value in %s\n", arg);
+            }
+            fprintf(stderr, "Usage: %s [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>] [--benchmark_repetitions=<n>] [--benchmark_out=<file>] [--benchmark_out_format=json] [--benchmark_format=console] [--benchmark_list_tests]\n", argv[0]);
+            fprintf(stderr, "       The short forms --filter, --min_time, --repetitions, --json and --list work too.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+Benchmark *register_benchmark(const char *name, Function function) {
+    Benchmark *benchmark = new Benchmark(name, function);
+    benchmarks().push_back(benchmark);
+    return benchmark;
+}
+
+} // namespace bench
+
+int main(int argc, char **argv) {
+    using namespace bench;
+
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<Run> runs;
+    if (!options.list) {
+        printf("%-48s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    }
+    for (Benchmark *benchmark : benchmarks()) {
+        std::vector<int64_t> args = benchmark->args();
+        if (args.empty()) {
+            args.push_back(0);
+        }
+        for (int64_t arg : args) {
+            std::string name = benchmark->name();
+            if (!benchmark->args().empty()) {
+                name += "/" + std::to_string(arg);
+            }
+            if (options.has_filter && regexec(&options.filter, name.c_str(), 0, NULL, 0) != 0) {
+                continue;
+            }
+            if (options.list) {
+                printf("%s\n", name.c_str());
+                continue;
+            }
+
+            uint64_t iterations = calibrate(benchmark->function(), arg, options.min_time);
+            size_t   first      = runs.size();
+            for (uint64_t repetition = 0; repetition < options.repetitions; repetition++) {
+                runs.push_back(make_run(name, run_once(benchmark->function(), iterations, arg), repetition));
+                print_run(runs.back());
+            }
+            add_aggregates(runs, first);
+            for (size_t i = first + options.repetitions; i < runs.size(); i++) {
+                print_run(runs[i]);
+            }
+        }
+    }
+
+    if (!options.json.empty() && !options.list) {
+        if (!write_json(options.json, argv[0], runs, options.repetitions)) {
+            fprintf(stderr, "Failed to write %s\n", options.json.c_str());
+            return 1;
+        }
+        printf("\nResults written to %s\n", options.json.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/* Minimal micro-benchmark harness, following the API of Google Benchmark
+ * closely enough that benchmarks read the same, taking its command line
+ * flags and writing its JSON format so the usual comparison tooling works
+ * on the results.
+ *
+ *   static void BM_something(bench::State &state) {
+ *       setup();
+ *       while (state.keep_running()) {
+ *           bench::do_not_optimize(something(state.arg()));
+ *       }
+ *   }
+ *   BENCHMARK(BM_something)->arg(8)->arg(64);
+ */
+
+namespace bench {
+
+class State {
+   public:
+    State(uint64_t iterations, int64_t arg) : m_iterations(iterations), m_remaining(iterations), m_arg(arg) {}
+
+    // Loop condition of the measured code, timing covers the first to the last call
+    inline bool keep_running(void) {
+        if (m_remaining) {
+            if (m_remaining-- == m_iterations) {
+                start();
+            }
+            return true;
+        }
+        stop();
+        return false;
+    }
+
+    // Exclude per iteration setup from the measurement
+    void pause_timing(void) {
+        stop();
+    }
+    void resume_timing(void) {
+        start();
+    }
+
+    int64_t arg(void) const {
+        return m_arg;
+    }
+    uint64_t iterations(void) const {
+        return m_iterations;
+    }
+
+    // Work done over all iterations, reported as items_per_second / bytes_per_second
+    void set_items_processed(uint64_t items) {
+        m_items = items;
+    }
+    void set_bytes_processed(uint64_t bytes) {
+        m_bytes = bytes;
+    }
+    void set_label(const std::string &label) {
+        m_label = label;
+    }
+
+    double real_seconds(void) const {
+        return m_real.count();
+    }
+    double cpu_seconds(void) const {
+        return m_cpu;
+    }
+    uint64_t items(void) const {
+        return m_items;
+    }
+    uint64_t bytes(void) const {
+        return m_bytes;
+    }
+    const std::string &label(void) const {
+        return m_label;
+    }
+
+   private:
+    void start(void) {
+        if (!m_running) {
+            m_running    = true;
+            m_real_start = std::chrono::steady_clock::now();
+            m_cpu_start  = std::clock();
+        }
+    }
+    void stop(void) {
+        if (m_running) {
+            m_running = false;
+            m_real += std::chrono::steady_clock::now() - m_real_start;
+            m_cpu += double(std::clock() - m_cpu_start) / CLOCKS_PER_SEC;
+        }
+    }
+
+    const uint64_t                        m_iterations;
+    uint64_t                              m_remaining;
+    const int64_t                         m_arg;
+    bool                                  m_running = false;
+    std::chrono::steady_clock::time_point m_real_start;
+    std::chrono::duration<double>         m_real{0};
+    std::clock_t                          m_cpu_start = 0;
+    double                                m_cpu       = 0;
+    uint64_t                              m_items     = 0;
+    uint64_t                              m_bytes     = 0;
+    std::string                           m_label;
+};
+
+typedef void (*Function)(State &state);
+
+class Benchmark {
+   public:
+    Benchmark(const char *name, Function function) : m_name(name), m_function(function) {}
+
+    // Run once per argument, reported as <name>/<arg>
+    Benchmark *arg(int64_t value) {
+        m_args.push_back(value);
+        return this;
+    }
+
+    const std::string &name(void) const {
+        return m_name;
+    }
+    Function function(void) const {
+        return m_function;
+    }
+    const std::vector<int64_t> &args(void) const {
+        return m_args;
+    }
+
+   private:
+    std::string          m_name;
+    Function             m_function;
+    std::vector<int64_t> m_args;
+};
+
+Benchmark *register_benchmark(const char *name, Function function);
+
+// Keep the compiler from discarding a result, or from assuming memory is unchanged
+template <class T>
+inline void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+inline void clobber_memory(void) {
+    asm volatile("" : : : "memory");
+}
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK(function) static ::bench::Benchmark *BENCHMARK_CONCAT(benchmark_, __COUNTER__) __attribute__((unused)) = ::bench::register_benchmark(#function, function)
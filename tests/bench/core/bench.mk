@@ -0,0 +1,24 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+COMBO_ENABLE = yes
+NKRO_ENABLE = yes
+
+SRC += $(TEST_PATH)/bench_keymap.c
+SRC += $(QUANTUM_DIR)/color.c
+
+# Every debounce algorithm and both CRC8 implementations are built side by
+# side, renamed by these wrappers, so they can be compared within one run
+SRC += $(wildcard $(TEST_PATH)/debounce_*.c) $(wildcard $(TEST_PATH)/crc8_*.c)
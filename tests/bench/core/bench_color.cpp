@@ -0,0 +1,45 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "color.h"
+}
+
+static void BM_hsv_to_rgb(bench::State &state) {
+    HSV hsv = {.h = 0, .s = 255, .v = 255};
+
+    while (state.keep_running()) {
+        bench::do_not_optimize(hsv_to_rgb(hsv));
+        hsv.h += 7;
+        hsv.s = 255 - (hsv.h & 0x3F);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_hsv_to_rgb);
+
+static void BM_hsv_to_rgb_nocie(bench::State &state) {
+    HSV hsv = {.h = 0, .s = 255, .v = 255};
+
+    while (state.keep_running()) {
+        bench::do_not_optimize(hsv_to_rgb_nocie(hsv));
+        hsv.h += 7;
+        hsv.s = 255 - (hsv.h & 0x3F);
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_hsv_to_rgb_nocie);
@@ -0,0 +1,74 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "quantum.h"
+
+void advance_time(uint32_t ms);
+}
+
+static keyrecord_t make_record(uint8_t row, uint8_t col, bool pressed) {
+    keyrecord_t record = {};
+    record.event.key     = (keypos_t){.col = col, .row = row};
+    record.event.pressed = pressed;
+    record.event.time    = timer_read() | 1;
+    return record;
+}
+
+static void process_key(uint8_t row, uint8_t col, bool pressed) {
+    keyrecord_t record  = make_record(row, col, pressed);
+    uint16_t    keycode = keymap_key_to_keycode(0, record.event.key);
+
+    bench::do_not_optimize(process_combo(keycode, &record));
+    advance_time(1);
+}
+
+// Tap of a key that is not part of any combo, the path every key event takes
+static void BM_process_combo_miss(bench::State &state) {
+    while (state.keep_running()) {
+        process_key(0, 5, true);
+        process_key(0, 5, false);
+    }
+    state.set_items_processed(state.iterations() * 2);
+}
+BENCHMARK(BM_process_combo_miss);
+
+// Two key combo, pressed and released together
+static void BM_process_combo_chord(bench::State &state) {
+    while (state.keep_running()) {
+        process_key(1, 1, true);
+        process_key(1, 2, true);
+        process_key(1, 1, false);
+        process_key(1, 2, false);
+        combo_task();
+    }
+    state.set_items_processed(state.iterations() * 4);
+}
+BENCHMARK(BM_process_combo_chord);
+
+// A combo key tapped on its own, buffered until the second key fails to arrive
+static void BM_process_combo_timeout(bench::State &state) {
+    while (state.keep_running()) {
+        process_key(1, 1, true);
+        advance_time(COMBO_TERM);
+        combo_task();
+        process_key(1, 1, false);
+    }
+    state.set_items_processed(state.iterations() * 2);
+}
+BENCHMARK(BM_process_combo_timeout);
@@ -0,0 +1,49 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include <stddef.h>
+#include <stdint.h>
+
+// Both implementations are built under their own name by the crc8_*.c wrappers
+uint8_t crc8_bitwise(const void *data, size_t data_len);
+uint8_t crc8_table(const void *data, size_t data_len);
+}
+
+static uint8_t buffer[256];
+
+static void run_crc8(bench::State &state, uint8_t (*crc8)(const void *, size_t)) {
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = i * 31;
+    }
+    while (state.keep_running()) {
+        bench::do_not_optimize(crc8(buffer, state.arg()));
+        bench::clobber_memory();
+    }
+    state.set_bytes_processed(state.iterations() * state.arg());
+}
+
+static void BM_crc8_bitwise(bench::State &state) {
+    run_crc8(state, crc8_bitwise);
+}
+BENCHMARK(BM_crc8_bitwise)->arg(8)->arg(32)->arg(256);
+
+static void BM_crc8_table(bench::State &state) {
+    run_crc8(state, crc8_table);
+}
+BENCHMARK(BM_crc8_table)->arg(8)->arg(32)->arg(256);
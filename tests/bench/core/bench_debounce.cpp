@@ -0,0 +1,112 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "quantum.h"
+
+void advance_time(uint32_t ms);
+}
+
+// Every algorithm is built under its own name by the debounce_*.c wrappers
+#define DEBOUNCE_VARIANT(name)                                                                          \
+    extern "C" void debounce_##name(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed); \
+    extern "C" void debounce_init_##name(uint8_t num_rows);                                             \
+    extern "C" void debounce_free_##name(void);                                                         \
+    static const debounce_variant_t name##_variant = {debounce_##name, debounce_init_##name, debounce_free_##name};
+
+typedef struct {
+    void (*debounce)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+    void (*init)(uint8_t num_rows);
+    void (*free)(void);
+} debounce_variant_t;
+
+typedef enum {
+    IDLE,    // Nothing pressed, the common case
+    TYPING,  // Keys pressed and released one after the other, bouncing on press
+    CHATTER, // Half a row of noisy switches flipping every scan
+} scenario_t;
+
+#define FRAMES 64
+
+static matrix_row_t frames[FRAMES][MATRIX_ROWS];
+static bool         frame_changed[FRAMES];
+
+static void build_frames(scenario_t scenario) {
+    memset(frames, 0, sizeof(frames));
+    for (uint8_t f = 0; f < FRAMES; f++) {
+        switch (scenario) {
+            case IDLE:
+                break;
+            case TYPING: {
+                uint8_t key   = f / 16;
+                uint8_t phase = f % 16;
+                if (phase < 8 && phase != 1) {
+                    frames[f][key % MATRIX_ROWS] = (matrix_row_t)1 << (key * 3);
+                }
+                break;
+            }
+            case CHATTER:
+                for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                    frames[f][row] = f & 1 ? 0x00FF : 0x0F0F;
+                }
+                break;
+        }
+    }
+    for (uint8_t f = 0; f < FRAMES; f++) {
+        frame_changed[f] = memcmp(frames[f], frames[(f + FRAMES - 1) % FRAMES], sizeof(frames[f])) != 0;
+    }
+}
+
+// One iteration is one matrix scan, a millisecond apart
+static void run_debounce(bench::State &state, const debounce_variant_t &variant, scenario_t scenario) {
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+    uint8_t      frame               = 0;
+
+    build_frames(scenario);
+    variant.init(MATRIX_ROWS);
+    while (state.keep_running()) {
+        variant.debounce(frames[frame], cooked, MATRIX_ROWS, frame_changed[frame]);
+        bench::clobber_memory();
+        frame = (frame + 1) % FRAMES;
+        advance_time(1);
+    }
+    variant.free();
+    state.set_items_processed(state.iterations());
+}
+
+#define DEBOUNCE_BENCHMARKS(name)                                    \
+    DEBOUNCE_VARIANT(name)                                           \
+    static void BM_debounce_##name##_idle(bench::State &state) {    \
+        run_debounce(state, name##_variant, IDLE);                   \
+    }                                                                \
+    static void BM_debounce_##name##_typing(bench::State &state) {  \
+        run_debounce(state, name##_variant, TYPING);                 \
+    }                                                                \
+    static void BM_debounce_##name##_chatter(bench::State &state) { \
+        run_debounce(state, name##_variant, CHATTER);                \
+    }                                                                \
+    BENCHMARK(BM_debounce_##name##_idle);                            \
+    BENCHMARK(BM_debounce_##name##_typing);                          \
+    BENCHMARK(BM_debounce_##name##_chatter);
+
+DEBOUNCE_BENCHMARKS(sym_defer_g)
+DEBOUNCE_BENCHMARKS(sym_defer_pk)
+DEBOUNCE_BENCHMARKS(sym_defer_pr)
+DEBOUNCE_BENCHMARKS(sym_eager_pk)
+DEBOUNCE_BENCHMARKS(sym_eager_pr)
+DEBOUNCE_BENCHMARKS(asym_eager_defer_pk)
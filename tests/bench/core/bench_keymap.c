@@ -0,0 +1,58 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+#define ROW(k) {k, k, k, k, k, k, k, k, k, k, k, k, k, k, k}
+#define LAYER(k) {ROW(k), ROW(k), ROW(k), ROW(k), ROW(k)}
+
+// A full base layer below fifteen transparent ones, the worst case for layer lookups
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_ESC,  KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    KC_7,    KC_8,    KC_9,    KC_0,    KC_MINS, KC_EQL,  KC_BSPC, KC_GRV},
+        {KC_TAB,  KC_Q,    KC_W,    KC_E,    KC_R,    KC_T,    KC_Y,    KC_U,    KC_I,    KC_O,    KC_P,    KC_LBRC, KC_RBRC, KC_BSLS, KC_DEL},
+        {KC_CAPS, KC_A,    KC_S,    KC_D,    KC_F,    KC_G,    KC_H,    KC_J,    KC_K,    KC_L,    KC_SCLN, KC_QUOT, KC_ENT,  KC_PGUP, KC_HOME},
+        {KC_LSFT, KC_Z,    KC_X,    KC_C,    KC_V,    KC_B,    KC_N,    KC_M,    KC_COMM, KC_DOT,  KC_SLSH, KC_RSFT, KC_UP,   KC_PGDN, KC_END},
+        {KC_LCTL, KC_LGUI, KC_LALT, KC_NO,   KC_NO,   KC_SPC,  KC_NO,   KC_NO,   KC_RALT, MO(1),   KC_APP,  KC_RCTL, KC_LEFT, KC_DOWN, KC_RGHT},
+    },
+    [1 ... 15] = LAYER(KC_TRNS),
+};
+
+const uint16_t PROGMEM combo_0[]  = {KC_Q, KC_W, COMBO_END};
+const uint16_t PROGMEM combo_1[]  = {KC_W, KC_E, COMBO_END};
+const uint16_t PROGMEM combo_2[]  = {KC_E, KC_R, COMBO_END};
+const uint16_t PROGMEM combo_3[]  = {KC_U, KC_I, COMBO_END};
+const uint16_t PROGMEM combo_4[]  = {KC_I, KC_O, COMBO_END};
+const uint16_t PROGMEM combo_5[]  = {KC_O, KC_P, COMBO_END};
+const uint16_t PROGMEM combo_6[]  = {KC_A, KC_S, COMBO_END};
+const uint16_t PROGMEM combo_7[]  = {KC_S, KC_D, COMBO_END};
+const uint16_t PROGMEM combo_8[]  = {KC_D, KC_F, COMBO_END};
+const uint16_t PROGMEM combo_9[]  = {KC_J, KC_K, COMBO_END};
+const uint16_t PROGMEM combo_10[] = {KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM combo_11[] = {KC_Z, KC_X, COMBO_END};
+const uint16_t PROGMEM combo_12[] = {KC_X, KC_C, COMBO_END};
+const uint16_t PROGMEM combo_13[] = {KC_C, KC_V, COMBO_END};
+const uint16_t PROGMEM combo_14[] = {KC_M, KC_COMM, COMBO_END};
+const uint16_t PROGMEM combo_15[] = {KC_A, KC_S, KC_D, KC_F, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(combo_0, KC_ESC),   COMBO(combo_1, KC_TAB),  COMBO(combo_2, KC_BSPC), COMBO(combo_3, KC_LPRN),
+    COMBO(combo_4, KC_RPRN),  COMBO(combo_5, KC_DEL),  COMBO(combo_6, KC_LCTL), COMBO(combo_7, KC_LALT),
+    COMBO(combo_8, KC_LGUI),  COMBO(combo_9, KC_ENT),  COMBO(combo_10, KC_SCLN), COMBO(combo_11, KC_UNDO),
+    COMBO(combo_12, KC_COPY), COMBO(combo_13, KC_PSTE), COMBO(combo_14, KC_MINS), COMBO(combo_15, KC_CAPS),
+};
+// clang-format on
@@ -0,0 +1,54 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "quantum.h"
+}
+
+// Looks a key up with the given number of layers enabled, all but the base one transparent
+static void BM_layer_switch_get_layer(bench::State &state) {
+    keypos_t key = {.col = 1, .row = 0};
+
+    layer_clear();
+    for (int64_t layer = 1; layer < state.arg(); layer++) {
+        layer_on(layer);
+    }
+    while (state.keep_running()) {
+        bench::do_not_optimize(layer_switch_get_layer(key));
+        key.col = (key.col + 1) % MATRIX_COLS;
+    }
+    layer_clear();
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_layer_switch_get_layer)->arg(1)->arg(4)->arg(16);
+
+static void BM_layer_switch_get_action(bench::State &state) {
+    keypos_t key = {.col = 1, .row = 0};
+
+    layer_clear();
+    for (int64_t layer = 1; layer < state.arg(); layer++) {
+        layer_on(layer);
+    }
+    while (state.keep_running()) {
+        bench::do_not_optimize(layer_switch_get_action(key));
+        key.col = (key.col + 1) % MATRIX_COLS;
+    }
+    layer_clear();
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_layer_switch_get_action)->arg(1)->arg(4)->arg(16);
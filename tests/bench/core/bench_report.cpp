@@ -0,0 +1,128 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "quantum.h"
+
+// Provided by the USB protocol code on real hardware
+uint8_t keyboard_protocol = 1;
+}
+
+static report_keyboard_t report;
+
+// Adds and removes the given number of keys, as a chord being pressed and released
+static void run_report(bench::State &state, bool nkro) {
+    uint8_t keys = state.arg();
+
+    keymap_config.nkro = nkro;
+    clear_keys_from_report(&report);
+    while (state.keep_running()) {
+        for (uint8_t i = 0; i < keys; i++) {
+            add_key_to_report(&report, KC_A + i * 5);
+        }
+        bench::do_not_optimize(report);
+        for (uint8_t i = 0; i < keys; i++) {
+            del_key_from_report(&report, KC_A + i * 5);
+        }
+        bench::do_not_optimize(report);
+    }
+    keymap_config.nkro = false;
+    state.set_items_processed(state.iterations() * keys * 2);
+}
+
+static void BM_report_6kro(bench::State &state) {
+    run_report(state, false);
+}
+BENCHMARK(BM_report_6kro)->arg(1)->arg(6)->arg(20);
+
+static void BM_report_nkro(bench::State &state) {
+    run_report(state, true);
+}
+BENCHMARK(BM_report_nkro)->arg(1)->arg(6)->arg(16)->arg(20);
+
+// Lookups done for every keypress, with a full report
+static void BM_report_is_key_pressed(bench::State &state) {
+    uint8_t key = KC_A;
+
+    keymap_config.nkro = state.arg();
+    clear_keys_from_report(&report);
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        add_key_to_report(&report, KC_1 + i);
+    }
+    while (state.keep_running()) {
+        bench::do_not_optimize(is_key_pressed(&report, key));
+        key = key == KC_0 ? KC_A : key + 1;
+    }
+    clear_keys_from_report(&report);
+    keymap_config.nkro = false;
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_report_is_key_pressed)->arg(0)->arg(1);
+
+static void BM_report_has_anykey(bench::State &state) {
+    keymap_config.nkro = state.arg();
+    clear_keys_from_report(&report);
+    add_key_to_report(&report, KC_SLSH);
+    while (state.keep_running()) {
+        bench::do_not_optimize(has_anykey(&report));
+        bench::clobber_memory();
+    }
+    clear_keys_from_report(&report);
+    keymap_config.nkro = false;
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_report_has_anykey)->arg(0)->arg(1);
+
+// Full path of a key change, including the check for an unchanged report, with 20 keys held
+static void BM_report_send_20_keys(bench::State &state) {
+    keymap_config.nkro = state.arg();
+    clear_keys();
+    while (state.keep_running()) {
+        for (uint8_t i = 0; i < 20; i++) {
+            add_key(KC_A + i);
+            send_keyboard_report();
+        }
+        for (uint8_t i = 0; i < 20; i++) {
+            del_key(KC_A + i);
+            send_keyboard_report();
+        }
+    }
+    clear_keys();
+    send_keyboard_report();
+    keymap_config.nkro = false;
+    state.set_items_processed(state.iterations() * 40);
+}
+BENCHMARK(BM_report_send_20_keys)->arg(0)->arg(1);
+
+// Reports requested while nothing changed, as many features do every scan
+static void BM_report_send_unchanged(bench::State &state) {
+    keymap_config.nkro = state.arg();
+    clear_keys();
+    for (uint8_t i = 0; i < 20; i++) {
+        add_key(KC_A + i);
+    }
+    send_keyboard_report();
+    while (state.keep_running()) {
+        send_keyboard_report();
+    }
+    clear_keys();
+    send_keyboard_report();
+    keymap_config.nkro = false;
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_report_send_unchanged)->arg(0)->arg(1);
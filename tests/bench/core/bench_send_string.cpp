@@ -0,0 +1,52 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+#include <string.h>
+
+extern "C" {
+#include "quantum.h"
+#include "send_string.h"
+}
+
+// Strings are typed through the whole keycode path, into the (absent) host driver
+static const char *const strings[] = {
+    "the quick brown fox jumps over the lazy dog",
+    "The Quick Brown Fox: \"Jumps\" over {the} Lazy Dog?! #42",
+    SS_LCTL("a") SS_DELAY(10) "hello" SS_TAP(X_ENTER),
+};
+
+static void BM_send_string(bench::State &state) {
+    const char *string = strings[state.arg()];
+
+    while (state.keep_running()) {
+        send_string(string);
+    }
+    state.set_bytes_processed(state.iterations() * strlen(string));
+}
+BENCHMARK(BM_send_string)->arg(0)->arg(1)->arg(2);
+
+static void BM_send_char(bench::State &state) {
+    char c = ' ';
+
+    while (state.keep_running()) {
+        send_char(c);
+        c = c == '~' ? ' ' : c + 1;
+    }
+    state.set_items_processed(state.iterations());
+}
+BENCHMARK(BM_send_char);
@@ -0,0 +1,66 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+#define ROW(k) {k, k, k, k, k, k, k, k, k, k, k, k, k, k, k}
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {ROW(KC_A), ROW(KC_A), ROW(KC_A), ROW(KC_A), ROW(KC_A)},
+};
+
+// One LED per key, laid out as a 5x15 grid with modifiers at both ends
+#define ROW_LEDS(r) {r * 15 + 0, r * 15 + 1, r * 15 + 2, r * 15 + 3, r * 15 + 4, r * 15 + 5, r * 15 + 6, r * 15 + 7, r * 15 + 8, r * 15 + 9, r * 15 + 10, r * 15 + 11, r * 15 + 12, r * 15 + 13, r * 15 + 14}
+#define ROW_POINTS(r) {0, r * 16}, {16, r * 16}, {32, r * 16}, {48, r * 16}, {64, r * 16}, {80, r * 16}, {96, r * 16}, {112, r * 16}, {128, r * 16}, {144, r * 16}, {160, r * 16}, {176, r * 16}, {192, r * 16}, {208, r * 16}, {224, r * 16}
+#define ROW_FLAGS 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 1
+
+led_config_t g_led_config = {
+    {ROW_LEDS(0), ROW_LEDS(1), ROW_LEDS(2), ROW_LEDS(3), ROW_LEDS(4)},
+    {ROW_POINTS(0), ROW_POINTS(1), ROW_POINTS(2), ROW_POINTS(3), ROW_POINTS(4)},
+    {ROW_FLAGS, ROW_FLAGS, ROW_FLAGS, ROW_FLAGS, ROW_FLAGS},
+};
+// clang-format on
+
+static RGB      leds[DRIVER_LED_TOTAL];
+static uint32_t flushes;
+
+static void bench_init(void) {}
+
+static void bench_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    leds[index] = (RGB){.r = r, .g = g, .b = b};
+}
+
+static void bench_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        bench_set_color(i, r, g, b);
+    }
+}
+
+static void bench_flush(void) {
+    flushes++;
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = bench_init,
+    .set_color     = bench_set_color,
+    .set_color_all = bench_set_color_all,
+    .flush         = bench_flush,
+};
+
+uint32_t bench_rgb_matrix_flushes(void) {
+    return flushes;
+}
@@ -0,0 +1,62 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "quantum.h"
+
+void     advance_time(uint32_t ms);
+uint32_t bench_rgb_matrix_flushes(void);
+}
+
+// One iteration renders and flushes one frame of the effect, while a key is
+// hit every few frames to keep the reactive effects busy
+static void run_effect(bench::State &state, uint8_t mode) {
+    static bool initialized = false;
+    uint8_t     frame       = 0;
+
+    if (!initialized) {
+        rgb_matrix_init();
+        initialized = true;
+    }
+    rgb_matrix_enable_noeeprom();
+    rgb_matrix_mode_noeeprom(mode);
+    while (state.keep_running()) {
+        uint32_t flushes = bench_rgb_matrix_flushes();
+
+        if (frame % 4 == 0) {
+            uint8_t key = (frame / 4 * 7) % (MATRIX_ROWS * MATRIX_COLS);
+            process_rgb_matrix(key / MATRIX_COLS, key % MATRIX_COLS, true);
+            process_rgb_matrix(key / MATRIX_COLS, key % MATRIX_COLS, false);
+        }
+        frame++;
+        advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+        while (bench_rgb_matrix_flushes() == flushes) {
+            rgb_matrix_task();
+        }
+    }
+    state.set_items_processed(state.iterations() * DRIVER_LED_TOTAL);
+}
+
+// A benchmark per effect enabled in config.h
+#define RGB_MATRIX_EFFECT(name, ...)                           \
+    static void BM_rgb_matrix_##name(bench::State &state) { \
+        run_effect(state, RGB_MATRIX_##name);                  \
+    }                                                          \
+    BENCHMARK(BM_rgb_matrix_##name);
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
@@ -0,0 +1,142 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "eeconfig.h"
+#include "eeprom.h"
+#include "process_dynamic_macro.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Mock;
+
+class DynamicMacro : public TestFixture {
+   protected:
+    KeymapKey record_key = KeymapKey(0, 0, 0, DYN_REC_START1);
+    KeymapKey stop_key   = KeymapKey(0, 1, 0, DYN_REC_STOP);
+    KeymapKey play_key   = KeymapKey(0, 2, 0, DYN_MACRO_PLAY1);
+    KeymapKey key_a      = KeymapKey(0, 3, 0, KC_A);
+    KeymapKey key_b      = KeymapKey(0, 4, 0, KC_B);
+
+    void SetUp() override {
+        set_keymap({record_key, stop_key, play_key, key_a, key_b});
+    }
+
+    void tap(KeymapKey &key) {
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+    }
+
+    /* Record: tap A, wait 100ms, tap B. */
+    void record_a_then_b(TestDriver &driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap(record_key);
+        tap(key_a);
+        idle_for(100);
+        tap(key_b);
+        tap(stop_key);
+        Mock::VerifyAndClearExpectations(&driver);
+    }
+};
+
+TEST_F(DynamicMacro, PlaybackKeepsTheRecordedTiming) {
+    TestDriver driver;
+
+    record_a_then_b(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).Times(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code))).Times(0);
+    tap(play_key);
+    idle_for(90);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code))).Times(1);
+    idle_for(20);
+    Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(DynamicMacro, StopKeyCancelsPlayback) {
+    TestDriver driver;
+
+    record_a_then_b(driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).Times(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code))).Times(0);
+    tap(play_key);
+    idle_for(50);
+    tap(stop_key);
+    idle_for(100);
+    Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(DynamicMacro, EventsAreStoredCompactly) {
+    TestDriver driver;
+
+    /* 30 events would need 30 whole keyrecord_t in the old format. */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap(record_key);
+    for (int i = 0; i < 15; i++) {
+        tap(key_a);
+    }
+    tap(stop_key);
+    idle_for(10);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).Times(15);
+    tap(play_key);
+    idle_for(100);
+    Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(DynamicMacro, MacroIsLoadedFromEeprom) {
+    TestDriver driver;
+
+    record_a_then_b(driver);
+    dynamic_macro_init();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).Times(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code))).Times(1);
+    tap(play_key);
+    idle_for(200);
+    Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(DynamicMacro, InvalidEepromContentIsIgnored) {
+    TestDriver driver;
+
+    record_a_then_b(driver);
+    eeprom_update_byte((uint8_t *)EECONFIG_SIZE, 0);
+    dynamic_macro_init();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code))).Times(0);
+    tap(play_key);
+    idle_for(200);
+    Mock::VerifyAndClearExpectations(&driver);
+}
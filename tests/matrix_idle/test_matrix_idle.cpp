@@ -0,0 +1,113 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static uint32_t user_scan_count = 0;
+
+extern "C" void matrix_scan_user(void) {
+    user_scan_count++;
+}
+
+class MatrixIdle : public TestFixture {
+   protected:
+    // Let the fixture settle, and wait out the idle timeout
+    void go_idle(void) {
+        idle_for(MATRIX_IDLE_TIMEOUT + 1);
+        ASSERT_TRUE(matrix_is_idle());
+    }
+
+    uint32_t full_scans_during(unsigned time) {
+        uint32_t before = get_matrix_scan_count();
+        idle_for(time);
+        return get_matrix_scan_count() - before;
+    }
+};
+
+TEST_F(MatrixIdle, QuietMatrixGoesIdle) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+
+    idle_for(MATRIX_IDLE_TIMEOUT / 2);
+    EXPECT_FALSE(matrix_is_idle());
+    go_idle();
+}
+
+TEST_F(MatrixIdle, IdleScansAtReducedRate) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+
+    go_idle();
+    EXPECT_EQ(full_scans_during(MATRIX_IDLE_SCAN_INTERVAL * 10), 10u);
+}
+
+TEST_F(MatrixIdle, ScanHooksRunEveryLoopWhileIdle) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+
+    go_idle();
+    uint32_t before = user_scan_count;
+    EXPECT_EQ(full_scans_during(MATRIX_IDLE_SCAN_INTERVAL * 10), 10u);
+    EXPECT_EQ(user_scan_count - before, MATRIX_IDLE_SCAN_INTERVAL * 10u);
+}
+
+TEST_F(MatrixIdle, HeldKeyKeepsFullRate) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key.press();
+    EXPECT_EQ(full_scans_during(MATRIX_IDLE_TIMEOUT * 2), MATRIX_IDLE_TIMEOUT * 2u);
+    EXPECT_FALSE(matrix_is_idle());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(MatrixIdle, FirstPressWakesImmediately) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key});
+
+    go_idle();
+    uint32_t activity = last_matrix_activity_time();
+
+    // The press lands between two idle scans, but is reported in the same loop
+    idle_for(MATRIX_IDLE_SCAN_INTERVAL / 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_FALSE(matrix_is_idle());
+    EXPECT_NE(last_matrix_activity_time(), activity);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
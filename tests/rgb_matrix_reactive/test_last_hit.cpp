@@ -0,0 +1,154 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class LastHit : public TestFixture {
+   protected:
+    void SetUp() override {
+        // Forget the hits of the previous test
+        rgb_matrix_init();
+        set_keymap({});
+        for (uint8_t col = 0; col < 8; col++) {
+            keys.push_back(KeymapKey(0, col, 0, KC_A + col));
+            add_key(keys.back());
+        }
+    }
+
+    // Presses and releases the key of LED col, one scan each
+    void tap(uint8_t col) {
+        keys[col].press();
+        run_one_scan_loop();
+        keys[col].release();
+        run_one_scan_loop();
+    }
+
+    // Lets the next frame publish the hits to g_last_hit_tracker
+    void next_frame(void) {
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 3);
+    }
+
+    std::vector<uint8_t> hit_leds(void) {
+        return std::vector<uint8_t>(g_last_hit_tracker.index, g_last_hit_tracker.index + g_last_hit_tracker.count);
+    }
+
+    std::vector<KeymapKey> keys;
+};
+
+TEST_F(LastHit, HitsArePublishedOldestFirst) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap(2);
+    idle_for(10);
+    tap(0);
+    idle_for(10);
+    tap(1);
+    next_frame();
+
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({2, 0, 1}));
+    EXPECT_EQ(g_last_hit_tracker.x[0], 32);
+    EXPECT_EQ(g_last_hit_tracker.y[0], 0);
+    // Taps are 12 ms apart, 2 ms for the tap and 10 idle. Hits are aged by
+    // the task, so their ticks are only exact to a scan.
+    EXPECT_NEAR(g_last_hit_tracker.tick[0] - g_last_hit_tracker.tick[1], 12, 1);
+    EXPECT_NEAR(g_last_hit_tracker.tick[1] - g_last_hit_tracker.tick[2], 12, 1);
+    EXPECT_LE(g_last_hit_tracker.tick[2], RGB_MATRIX_LED_FLUSH_LIMIT * 3 + 1);
+}
+
+TEST_F(LastHit, OverflowOverwritesOldestHits) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint8_t col = 0; col < 7; col++) {
+        tap(col);
+    }
+    next_frame();
+
+    ASSERT_EQ(LED_HITS_TO_REMEMBER, 4);
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({3, 4, 5, 6}));
+    EXPECT_GT(g_last_hit_tracker.tick[0], g_last_hit_tracker.tick[3]);
+}
+
+TEST_F(LastHit, HitsExpireAfterUint16MaxMilliseconds) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap(0);
+    next_frame();
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({0}));
+
+    advance_time(65000);
+    next_frame();
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({0}));
+    EXPECT_GT(g_last_hit_tracker.tick[0], 65000);
+
+    advance_time(500);
+    next_frame();
+    EXPECT_TRUE(hit_leds().empty());
+}
+
+TEST_F(LastHit, LongStallExpiresHits) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap(0);
+    next_frame();
+
+    // More than UINT16_MAX ms between two tasks, the tick must not wrap
+    advance_time(70000);
+    next_frame();
+    EXPECT_TRUE(hit_leds().empty());
+}
+
+TEST_F(LastHit, WrappedRingExpiresFromItsHead) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint8_t col = 0; col < 4; col++) {
+        tap(col);
+    }
+    advance_time(40000);
+    next_frame();
+
+    // Overwrites the two oldest, the head of the ring moves past the start
+    tap(4);
+    tap(5);
+    next_frame();
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({2, 3, 4, 5}));
+
+    // Hits 2 and 3 are past UINT16_MAX, the newer ones are kept
+    advance_time(30000);
+    next_frame();
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({4, 5}));
+    EXPECT_LT(g_last_hit_tracker.tick[0], 31000);
+
+    // Space freed by expiry is reused in order
+    tap(6);
+    next_frame();
+    EXPECT_EQ(hit_leds(), std::vector<uint8_t>({4, 5, 6}));
+}
@@ -0,0 +1,45 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+// One LED per key, LED r * 10 + c at key r,c on a 16 unit grid
+#define ROW_LEDS(r) {r * 10 + 0, r * 10 + 1, r * 10 + 2, r * 10 + 3, r * 10 + 4, r * 10 + 5, r * 10 + 6, r * 10 + 7, r * 10 + 8, r * 10 + 9}
+#define ROW_POINTS(r) {0, r * 16}, {16, r * 16}, {32, r * 16}, {48, r * 16}, {64, r * 16}, {80, r * 16}, {96, r * 16}, {112, r * 16}, {128, r * 16}, {144, r * 16}
+#define ROW_FLAGS 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+
+led_config_t g_led_config = {
+    {ROW_LEDS(0), ROW_LEDS(1), ROW_LEDS(2), ROW_LEDS(3)},
+    {ROW_POINTS(0), ROW_POINTS(1), ROW_POINTS(2), ROW_POINTS(3)},
+    {ROW_FLAGS, ROW_FLAGS, ROW_FLAGS, ROW_FLAGS},
+};
+// clang-format on
+
+static void test_init(void) {}
+
+static void test_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {}
+
+static void test_set_color_all(uint8_t r, uint8_t g, uint8_t b) {}
+
+static void test_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = test_init,
+    .set_color     = test_set_color,
+    .set_color_all = test_set_color_all,
+    .flush         = test_flush,
+};
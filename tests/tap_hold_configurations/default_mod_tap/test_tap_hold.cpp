@@ -227,4 +227,47 @@ TEST_F(DefaultTapHold, tap_and_hold_mod_tap_hold_key) {
     mod_tap_hold_key.release();
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
-}
\ No newline at end of file
+}
+
+TEST_F(DefaultTapHold, roll_fifteen_regular_keys_while_mod_tap_key_is_held) {
+    TestDriver             driver;
+    InSequence             s;
+    auto                   mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_Z));
+    std::vector<KeymapKey> regular_keys;
+
+    set_keymap({mod_tap_hold_key});
+    for (uint8_t i = 0; i < 15; i++) {
+        regular_keys.push_back(KeymapKey(0, i % 8 + 1, i / 8 + 1, KC_A + i));
+        add_key(regular_keys.back());
+    }
+
+    /* Press mod-tap-hold key and roll over the regular keys, with the release of the
+     * mod-tap-hold key this fills all 32 slots of the waiting buffer. */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    for (uint8_t i = 0; i < 15; i++) {
+        regular_keys[i].press();
+        run_one_scan_loop();
+        if (i > 0) {
+            regular_keys[i - 1].release();
+            run_one_scan_loop();
+        }
+    }
+    regular_keys[14].release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key, the roll is replayed after the tap. */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z, KC_A)));
+    for (uint8_t i = 1; i < 15; i++) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z, KC_A + i - 1, KC_A + i)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z, KC_A + i)));
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
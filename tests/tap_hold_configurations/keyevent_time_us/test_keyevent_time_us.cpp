@@ -0,0 +1,87 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time_us(uint32_t us);
+}
+
+using testing::_;
+using testing::InSequence;
+
+class KeyEventTimeUs : public TestFixture {
+   protected:
+    KeymapKey mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    void SetUp() override {
+        set_keymap({mod_tap_hold_key});
+        set_time(1000);
+    }
+};
+
+TEST_F(KeyEventTimeUs, tap_released_just_before_the_term) {
+    TestDriver driver;
+    InSequence s;
+
+    /* Press mod-tap-hold key late in a millisecond */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    advance_time_us(900);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM - 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release it 500us before the term, the millisecond timestamps are a full term apart */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    advance_time_us(500);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeyEventTimeUs, hold_is_not_decided_before_the_term) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    advance_time_us(900);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM - 2);
+
+    /* The millisecond timer reads a full term since the press, but 800us are missing */
+    advance_time_us(200);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    advance_time_us(800);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
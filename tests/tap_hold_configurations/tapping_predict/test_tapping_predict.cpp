@@ -0,0 +1,247 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "tapping_predict.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class TappingPredict : public TestFixture {
+   protected:
+    KeymapKey mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    KeymapKey regular_key      = KeymapKey(0, 2, 0, KC_A);
+
+    void SetUp() override {
+        set_keymap({mod_tap_hold_key, regular_key});
+    }
+
+    void tap(unsigned duration) {
+        mod_tap_hold_key.press();
+        idle_for(duration);
+        mod_tap_hold_key.release();
+        idle_for(TAPPING_TERM);
+    }
+
+    void hold(void) {
+        mod_tap_hold_key.press();
+        idle_for(TAPPING_TERM + 100);
+        mod_tap_hold_key.release();
+        idle_for(TAPPING_TERM);
+    }
+
+    void roll(void) {
+        mod_tap_hold_key.press();
+        idle_for(30);
+        regular_key.press();
+        idle_for(30);
+        mod_tap_hold_key.release();
+        idle_for(30);
+        regular_key.release();
+        idle_for(TAPPING_TERM);
+    }
+
+    void chord(void) {
+        mod_tap_hold_key.press();
+        idle_for(30);
+        regular_key.press();
+        idle_for(30);
+        regular_key.release();
+        idle_for(30);
+        mod_tap_hold_key.release();
+        idle_for(TAPPING_TERM);
+    }
+};
+
+TEST_F(TappingPredict, decision_latency_is_recorded) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap(50);
+    hold();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    const tapping_predict_latency_t *latency = tapping_predict_get_latency();
+    EXPECT_EQ(latency->decisions, 2);
+    EXPECT_EQ(latency->predicted, 0);
+    EXPECT_EQ(latency->max, TAPPING_TERM);
+    EXPECT_EQ(latency->total, 50 + TAPPING_TERM);
+
+    const tapping_predict_entry_t *entry = tapping_predict_get_entry(mod_tap_hold_key.position);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->taps, 1);
+    EXPECT_EQ(entry->holds, 1);
+    EXPECT_EQ(entry->tap_mean, 50 * 16);
+}
+
+TEST_F(TappingPredict, rolls_resolve_as_tap_on_the_next_press) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < TAPPING_PREDICT_MIN_SAMPLES; i++) {
+        roll();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    tapping_predict_reset_latency();
+
+    /* Press mod-tap-hold key */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press regular key, the mod-tap-hold key is tapped right away */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P, KC_A)));
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release regular key */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(tapping_predict_get_latency()->predicted, 1);
+    EXPECT_LE(tapping_predict_get_latency()->last, 1);
+}
+
+TEST_F(TappingPredict, chords_resolve_as_hold_on_the_next_press) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < TAPPING_PREDICT_MIN_SAMPLES; i++) {
+        chord();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press mod-tap-hold key */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press regular key, the mod-tap-hold key is held right away */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release regular key */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TappingPredict, short_taps_shorten_the_hold_term) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    hold();
+    for (int i = 0; i < TAPPING_PREDICT_MIN_SAMPLES; i++) {
+        tap(40);
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press mod-tap-hold key, it is held after the shortest predicted term */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    mod_tap_hold_key.press();
+    idle_for(TAPPING_PREDICT_MIN_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_LT(tapping_predict_get_latency()->last, TAPPING_TERM);
+
+    /* Release mod-tap-hold key */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TappingPredict, keys_never_held_keep_the_tapping_term) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < TAPPING_PREDICT_MIN_SAMPLES; i++) {
+        tap(40);
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    mod_tap_hold_key.press();
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TappingPredict, statistics_survive_a_save_and_reload) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < 3; i++) {
+        roll();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    tapping_predict_save();
+    tapping_predict_clear();
+    EXPECT_EQ(tapping_predict_get_entry(mod_tap_hold_key.position), nullptr);
+
+    tapping_predict_init();
+    const tapping_predict_entry_t *entry = tapping_predict_get_entry(mod_tap_hold_key.position);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->taps, 3);
+    EXPECT_EQ(entry->rolls, 3);
+}
@@ -0,0 +1,165 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "telemetry.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+/* Stands in for the host side of the raw HID endpoint. */
+static std::vector<telemetry_report_t> received_reports;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    telemetry_report_t report;
+    ASSERT_EQ(length, TELEMETRY_PACKET_SIZE);
+    ASSERT_TRUE(telemetry_report_decode(data, &report));
+    received_reports.push_back(report);
+}
+
+class Telemetry : public TestFixture {
+   protected:
+    void SetUp() override {
+        received_reports.clear();
+    }
+
+    void TearDown() override {
+        telemetry_subscribe(0);
+    }
+
+    void subscribe(uint16_t interval) {
+        uint8_t packet[TELEMETRY_PACKET_SIZE] = {TELEMETRY_SUBSCRIBE_ID, (uint8_t)(interval >> 8), (uint8_t)(interval & 0xFF)};
+        EXPECT_TRUE(telemetry_process_command(packet, sizeof(packet)));
+    }
+};
+
+TEST_F(Telemetry, NothingIsSentWithoutSubscription) {
+    TestDriver driver;
+
+    idle_for(1000);
+    EXPECT_TRUE(received_reports.empty());
+}
+
+TEST_F(Telemetry, ReportsArriveEveryInterval) {
+    TestDriver driver;
+
+    subscribe(250);
+    // The report for each interval is sent on the scan after it has elapsed
+    idle_for(1000 + 1);
+
+    ASSERT_EQ(received_reports.size(), 4);
+    for (size_t i = 0; i < received_reports.size(); i++) {
+        EXPECT_EQ(received_reports[i].sequence, i);
+        EXPECT_EQ(received_reports[i].period, 250);
+        // run_one_scan_loop() advances the time by 1ms
+        EXPECT_EQ(received_reports[i].scan_rate, 1000);
+    }
+}
+
+TEST_F(Telemetry, IntervalIsLimited) {
+    TestDriver driver;
+
+    subscribe(1);
+    idle_for(TELEMETRY_MIN_INTERVAL * 2 + 1);
+
+    EXPECT_EQ(received_reports.size(), 2);
+}
+
+TEST_F(Telemetry, UsbReportsAreCounted) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    subscribe(100);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    key.press();
+    run_one_scan_loop();
+    key.release();
+    run_one_scan_loop();
+    idle_for(200);
+
+    ASSERT_EQ(received_reports.size(), 2);
+    EXPECT_EQ(received_reports[0].counter[TELEMETRY_USB_REPORTS], 2);
+    EXPECT_EQ(received_reports[1].counter[TELEMETRY_USB_REPORTS], 0);
+}
+
+TEST_F(Telemetry, TimingsAreMeasuredFromTheirStart) {
+    TestDriver driver;
+
+    subscribe(100);
+    uint32_t start = telemetry_time_start();
+    advance_time(3);
+    telemetry_time_end(TELEMETRY_RGB_FRAME, start);
+    idle_for(100);
+
+    ASSERT_EQ(received_reports.size(), 1);
+    EXPECT_EQ(received_reports[0].timing[TELEMETRY_RGB_FRAME], 3000);
+}
+
+TEST_F(Telemetry, TimingStartedBeforeSubscribingIsSkipped) {
+    TestDriver driver;
+
+    // A frame that is being rendered while the host subscribes
+    idle_for(10);
+    uint32_t start = telemetry_time_start();
+    subscribe(100);
+    advance_time(1);
+    telemetry_time_end(TELEMETRY_RGB_FRAME, start);
+    idle_for(100);
+
+    ASSERT_EQ(received_reports.size(), 1);
+    EXPECT_EQ(received_reports[0].timing[TELEMETRY_RGB_FRAME], 0);
+}
+
+TEST_F(Telemetry, PacketRoundTrips) {
+    telemetry_report_t report = {
+        .sequence  = 7,
+        .period    = 1000,
+        .scan_rate = 123456,
+        .timing    = {1, 2, 3, 4, 65535},
+        .counter   = {6, 7, 8, 9, 10},
+    };
+    telemetry_report_t decoded;
+    uint8_t            packet[TELEMETRY_PACKET_SIZE];
+
+    telemetry_report_encode(&report, packet);
+    EXPECT_EQ(packet[0], TELEMETRY_REPORT_ID);
+    // Big endian
+    EXPECT_EQ(packet[4], 0x00);
+    EXPECT_EQ(packet[5], 0x01);
+    EXPECT_EQ(packet[6], 0xE2);
+    EXPECT_EQ(packet[7], 0x40);
+
+    ASSERT_TRUE(telemetry_report_decode(packet, &decoded));
+    EXPECT_EQ(decoded.sequence, report.sequence);
+    EXPECT_EQ(decoded.period, report.period);
+    EXPECT_EQ(decoded.scan_rate, report.scan_rate);
+    for (int i = 0; i < TELEMETRY_TIMING_COUNT; i++) {
+        EXPECT_EQ(decoded.timing[i], report.timing[i]);
+    }
+    for (int i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+        EXPECT_EQ(decoded.counter[i], report.counter[i]);
+    }
+}
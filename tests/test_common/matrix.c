@@ -19,6 +19,8 @@
 #include <string.h>
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
+static bool         matrix_changed      = true;
+static uint32_t     matrix_scan_count   = 0;
 
 void matrix_init(void) {
     clear_all_keys();
@@ -26,8 +28,22 @@ void matrix_init(void) {
 }
 
 uint8_t matrix_scan(void) {
+    bool changed   = matrix_changed;
+    matrix_changed = false;
+    matrix_scan_count++;
     matrix_scan_quantum();
-    return 1;
+    return changed;
+}
+
+bool matrix_wake_check(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix[row]) return true;
+    }
+    return false;
+}
+
+uint32_t get_matrix_scan_count(void) {
+    return matrix_scan_count;
 }
 
 matrix_row_t matrix_get_row(uint8_t row) {
@@ -38,18 +54,25 @@ void matrix_print(void) {}
 
 void matrix_init_kb(void) {}
 
-void matrix_scan_kb(void) {}
+void matrix_scan_kb(void) {
+    matrix_scan_user();
+}
+
+__attribute__((weak)) void matrix_scan_user(void) {}
 
 void press_key(uint8_t col, uint8_t row) {
     matrix[row] |= 1 << col;
+    matrix_changed = true;
 }
 
 void release_key(uint8_t col, uint8_t row) {
     matrix[row] &= ~(1 << col);
+    matrix_changed = true;
 }
 
 void clear_all_keys(void) {
     memset(matrix, 0, sizeof(matrix));
+    matrix_changed = true;
 }
 
 void led_set(uint8_t usb_led) {}
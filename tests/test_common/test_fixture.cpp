@@ -22,6 +22,9 @@ extern "C" {
 #include "eeconfig.h"
 #include "keyboard.h"
 #include "keymap.h"
+#if defined(TAPPING_PREDICT_ENABLE)
+#    include "tapping_predict.h"
+#endif
 
 void set_time(uint32_t t);
 void advance_time(uint32_t ms);
@@ -32,13 +35,16 @@ using testing::_;
 /* This is used for dynamic dispatching keymap_key_to_keycode calls to the current active test_fixture. */
 TestFixture* TestFixture::m_this = nullptr;
 
+#ifndef DYNAMIC_KEYMAP_ENABLE
 /* Override weak QMK function to allow the usage of isolated per-test keymaps in unit-tests.
- * The actual call is dynamicaly dispatched to the current active test fixture, which in turn has it's own keymap. */
+ * The actual call is dynamicaly dispatched to the current active test fixture, which in turn has it's own keymap.
+ * Dynamic keymaps bring their own override, which reads the keymap from EEPROM. */
 extern "C" uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t position) {
     uint16_t keycode;
     TestFixture::m_this->get_keycode(layer, position, &keycode);
     return keycode;
 }
+#endif
 
 void TestFixture::SetUpTestCase() {
     test_logger.info() << "TestFixture setup-up start." << std::endl;
@@ -78,6 +84,10 @@ TestFixture::~TestFixture() {
     clear_oneshot_swaphands();
 #endif
 
+#if defined(TAPPING_PREDICT_ENABLE)
+    tapping_predict_clear();
+#endif
+
     idle_for(TAPPING_TERM * 10);
     testing::Mock::VerifyAndClearExpectations(&driver);
 
@@ -24,6 +24,8 @@ void press_key(uint8_t col, uint8_t row);
 void release_key(uint8_t col, uint8_t row);
 void clear_all_keys(void);
 
+uint32_t get_matrix_scan_count(void);
+
 #ifdef __cplusplus
 }
 #endif
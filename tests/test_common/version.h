@@ -0,0 +1,24 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stands in for the version.h generated for keyboard builds, with the
+// placeholders of `qmk generate-version-h --skip-all`
+#define QMK_VERSION "NA"
+#define QMK_BUILDDATE "1970-01-01-00:00:00"
+#define CHIBIOS_VERSION "NA"
+#define CHIBIOS_CONTRIB_VERSION "NA"
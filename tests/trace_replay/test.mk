@@ -0,0 +1,35 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+COMBO_ENABLE = yes
+TAP_DANCE_ENABLE = yes
+KEY_OVERRIDE_ENABLE = yes
+
+SRC += $(TEST_PATH)/trace_keymap.c
+
+OPT_DEFS += -DTRACE_REPLAY_DIR=\"$(TEST_PATH)/traces\"
+
+# Per section costs need the GNU linker to route calls through trace_profiler.cpp
+ifneq ($(findstring linux, $(shell gcc -dumpmachine)),)
+    LDFLAGS += -Wl,--wrap=action_exec,--wrap=process_record
+    LDFLAGS += -Wl,--wrap=process_combo,--wrap=combo_task
+    LDFLAGS += -Wl,--wrap=process_tap_dance,--wrap=tap_dance_task
+    LDFLAGS += -Wl,--wrap=process_key_override,--wrap=key_override_task
+    OPT_DEFS += -DTRACE_REPLAY_WRAP
+endif
@@ -0,0 +1,277 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "trace_profiler.hpp"
+
+extern "C" {
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+/* Replays recorded matrix event streams through keyboard_task(), and reports
+ * what each part of the key pipeline cost.
+ *
+ * Trace files hold one event per line, "<ms since previous event> <d|u> <row> <col>",
+ * with '#' starting a comment. Besides the traces in traces/, files listed in
+ * TRACE_REPLAY_TRACES (separated by ':') are replayed as well.
+ *
+ * TRACE_REPLAY_REPORT names a file the tab separated report is appended to.
+ * TRACE_REPLAY_BASELINE names an earlier report, and fails the run if the
+ * instructions per call of a section grew by more than TRACE_REPLAY_TOLERANCE
+ * percent (10 by default). Times are too noisy to be compared.
+ */
+
+// clang-format off
+static const uint16_t layout[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_Q,         KC_W,         KC_E,         KC_R,         KC_T,    KC_Y,    KC_U,         KC_I,         KC_O,         KC_P},
+        {LGUI_T(KC_A), LALT_T(KC_S), LCTL_T(KC_D), LSFT_T(KC_F), KC_G,    KC_H,    RSFT_T(KC_J), RCTL_T(KC_K), RALT_T(KC_L), KC_BSPC},
+        {KC_Z,         KC_X,         KC_C,         KC_V,         KC_B,    KC_N,    KC_M,         KC_COMM,      KC_DOT,       TD(0)},
+        {KC_LSFT,      MO(1),        KC_SPC,       KC_ENT,       KC_NO,   KC_NO,   KC_NO,        KC_NO,        KC_NO,        KC_NO},
+    },
+    [1] = {
+        {KC_1,         KC_2,         KC_3,         KC_4,         KC_5,    KC_6,    KC_7,         KC_8,         KC_9,         KC_0},
+        {KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS, KC_TRNS, KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS},
+        {KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS, KC_TRNS, KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS},
+        {KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS, KC_TRNS, KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS},
+    },
+};
+// clang-format on
+
+struct trace_event_t {
+    uint32_t delay;
+    bool     pressed;
+    uint8_t  row;
+    uint8_t  col;
+};
+
+static bool load_trace(const std::string &path, std::vector<trace_event_t> &events) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        uint32_t           delay;
+        std::string        kind;
+        unsigned           row, col;
+        if (!(fields >> delay)) {
+            continue;
+        }
+        if (!(fields >> kind >> row >> col) || (kind != "d" && kind != "u") || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            ADD_FAILURE() << path << ": malformed line '" << line << "'";
+            return false;
+        }
+        events.push_back({delay, kind == "d", (uint8_t)row, (uint8_t)col});
+    }
+    return true;
+}
+
+static std::string trace_name(const std::string &path) {
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    return name.substr(0, name.find('.'));
+}
+
+/* Reads a report written by write_report(), keyed by "trace section" */
+static std::map<std::string, trace_stats_t> load_report(const char *path) {
+    std::map<std::string, trace_stats_t> report;
+    std::ifstream                        file(path);
+    std::string                          line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string        trace, section;
+        trace_stats_t      stats;
+        if (fields >> trace >> section >> stats.calls >> stats.nanoseconds >> stats.max_nanoseconds >> stats.instructions >> stats.max_instructions) {
+            report[trace + " " + section] = stats;
+        }
+    }
+    return report;
+}
+
+class TraceReplay : public TestFixture {
+   protected:
+    TraceReplay() {
+        for (uint8_t layer = 0; layer < sizeof(layout) / sizeof(layout[0]); layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    add_key(KeymapKey(layer, col, row, layout[layer][row][col]));
+                }
+            }
+        }
+    }
+
+    // Runs one scan loop, a millisecond of firmware time
+    void scan(bool event) {
+        {
+            trace_sample_t start = TraceProfiler::now();
+            keyboard_task();
+            TraceProfiler::add(SECTION_KEYBOARD_TASK, start);
+            if (event) {
+                TraceProfiler::add(SECTION_EVENT_LOOP, start);
+            }
+        }
+        advance_time(1);
+    }
+
+    void replay(const std::string &path) {
+        std::vector<trace_event_t> events;
+        ASSERT_TRUE(load_trace(path, events)) << "cannot read " << path;
+        ASSERT_FALSE(events.empty());
+
+        TestDriver            driver;
+        report_keyboard_t     last_report = {};
+        std::set<uint8_t>     seen;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([&](report_keyboard_t &report) {
+            last_report = report;
+            for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                seen.insert(report.keys[i]);
+            }
+        }));
+
+        TraceProfiler::reset();
+        for (size_t i = 0; i < events.size(); i++) {
+            for (uint32_t ms = 0; ms < events[i].delay; ms++) {
+                scan(false);
+            }
+            // Events without delay land in the same scan
+            for (; i < events.size(); i++) {
+                if (events[i].pressed) {
+                    press_key(events[i].col, events[i].row);
+                } else {
+                    release_key(events[i].col, events[i].row);
+                }
+                if (i + 1 == events.size() || events[i + 1].delay) {
+                    break;
+                }
+            }
+            scan(true);
+        }
+        // Let pending taps and combos resolve
+        for (uint32_t ms = 0; ms < TAPPING_TERM * 5; ms++) {
+            scan(false);
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        // Everything pressed was released again
+        EXPECT_EQ(last_report.mods, 0);
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            EXPECT_EQ(last_report.keys[i], 0);
+        }
+        m_seen = seen;
+        write_report(trace_name(path));
+    }
+
+    void write_report(const std::string &trace) {
+        bool instructions = TraceProfiler::has_instructions();
+
+        printf("\n%s (%s)\n", trace.c_str(), instructions ? "time and instructions" : "time only, no hardware counters");
+        printf("  %-24s %8s %12s %10s %14s %10s\n", "section", "calls", "ns/call", "max ns", "instr/call", "max instr");
+        for (int i = 0; i < SECTION_COUNT; i++) {
+            trace_section_t      section = (trace_section_t)i;
+            const trace_stats_t &stats   = TraceProfiler::stats(section);
+            if (!stats.calls) {
+                continue;
+            }
+            printf("  %-24s %8llu %12llu %10llu %14llu %10llu\n", TraceProfiler::name(section), (unsigned long long)stats.calls, (unsigned long long)(stats.nanoseconds / stats.calls), (unsigned long long)stats.max_nanoseconds, (unsigned long long)(stats.instructions / stats.calls), (unsigned long long)stats.max_instructions);
+        }
+
+        const char *report_path = getenv("TRACE_REPLAY_REPORT");
+        if (report_path) {
+            FILE *report = fopen(report_path, "a");
+            ASSERT_NE(report, nullptr) << "cannot write " << report_path;
+            fprintf(report, "# trace\tsection\tcalls\tns\tmax_ns\tinstructions\tmax_instructions\n");
+            for (int i = 0; i < SECTION_COUNT; i++) {
+                const trace_stats_t &stats = TraceProfiler::stats((trace_section_t)i);
+                fprintf(report, "%s\t%s\t%llu\t%llu\t%llu\t%llu\t%llu\n", trace.c_str(), TraceProfiler::name((trace_section_t)i), (unsigned long long)stats.calls, (unsigned long long)stats.nanoseconds, (unsigned long long)stats.max_nanoseconds, (unsigned long long)stats.instructions, (unsigned long long)stats.max_instructions);
+            }
+            fclose(report);
+        }
+
+        const char *baseline_path = getenv("TRACE_REPLAY_BASELINE");
+        if (baseline_path && instructions) {
+            const char *tolerance_env = getenv("TRACE_REPLAY_TOLERANCE");
+            double      tolerance     = tolerance_env ? atof(tolerance_env) : 10;
+            auto        baseline      = load_report(baseline_path);
+            for (int i = 0; i < SECTION_COUNT; i++) {
+                const trace_stats_t &stats = TraceProfiler::stats((trace_section_t)i);
+                auto                 old   = baseline.find(trace + " " + TraceProfiler::name((trace_section_t)i));
+                if (old == baseline.end() || !old->second.calls || !old->second.instructions || !stats.calls) {
+                    continue;
+                }
+                double before = (double)old->second.instructions / old->second.calls;
+                double after  = (double)stats.instructions / stats.calls;
+                EXPECT_LE(after, before * (1 + tolerance / 100)) << trace << " " << TraceProfiler::name((trace_section_t)i) << " regressed from " << before << " to " << after << " instructions per call";
+            }
+        }
+    }
+
+    std::set<uint8_t> m_seen;
+};
+
+TEST_F(TraceReplay, Typing) {
+    replay(TRACE_REPLAY_DIR "/typing.trace");
+    EXPECT_TRUE(m_seen.count(KC_A) && m_seen.count(KC_F) && m_seen.count(KC_SPC));
+}
+
+TEST_F(TraceReplay, Chords) {
+    replay(TRACE_REPLAY_DIR "/chords.trace");
+    EXPECT_TRUE(m_seen.count(KC_TAB)) << "combo never fired";
+    EXPECT_TRUE(m_seen.count(KC_DEL)) << "key override never fired";
+    EXPECT_TRUE(m_seen.count(KC_1) || m_seen.count(KC_0) || m_seen.count(KC_5)) << "layer never switched";
+}
+
+TEST_F(TraceReplay, RollingModTap) {
+    replay(TRACE_REPLAY_DIR "/rolling_mod_tap.trace");
+    EXPECT_TRUE(m_seen.count(KC_SCLN)) << "tap dance single tap missing";
+    EXPECT_TRUE(m_seen.count(KC_QUOT)) << "tap dance double tap missing";
+    EXPECT_TRUE(m_seen.count(KC_S) && m_seen.count(KC_D));
+}
+
+TEST_F(TraceReplay, RecordedTraces) {
+    const char *traces = getenv("TRACE_REPLAY_TRACES");
+    if (!traces) {
+        return;
+    }
+    std::istringstream paths(traces);
+    std::string        path;
+    while (std::getline(paths, path, ':')) {
+        if (!path.empty()) {
+            replay(path);
+        }
+    }
+}
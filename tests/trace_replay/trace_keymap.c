@@ -0,0 +1,29 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// Features exercised by the traces, the key layout is in test_trace_replay.cpp
+
+const uint16_t PROGMEM we_combo[] = {KC_W, KC_E, COMBO_END};
+combo_t                key_combos[COMBO_COUNT] = {COMBO(we_combo, KC_TAB)};
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_SCLN, KC_QUOT),
+};
+
+const key_override_t   delete_key_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+const key_override_t **key_overrides       = (const key_override_t *[]){&delete_key_override, NULL};
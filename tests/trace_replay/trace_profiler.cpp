@@ -0,0 +1,165 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace_profiler.hpp"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#    include <linux/perf_event.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+extern "C" {
+#include "quantum.h"
+}
+
+trace_stats_t TraceProfiler::m_stats[SECTION_COUNT];
+
+#ifdef __linux__
+static int instruction_counter(void) {
+    static int fd = -2;
+    if (fd == -2) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        // Commonly denied in containers and VMs, the report then only has times
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    return fd;
+}
+#endif
+
+void TraceProfiler::reset() {
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+bool TraceProfiler::has_instructions() {
+#ifdef __linux__
+    return instruction_counter() >= 0;
+#else
+    return false;
+#endif
+}
+
+bool TraceProfiler::has_sections() {
+#ifdef TRACE_REPLAY_WRAP
+    return true;
+#else
+    return false;
+#endif
+}
+
+trace_sample_t TraceProfiler::now() {
+    trace_sample_t sample = {0, 0};
+#ifdef __linux__
+    int fd = instruction_counter();
+    if (fd >= 0 && read(fd, &sample.instructions, sizeof(sample.instructions)) != sizeof(sample.instructions)) {
+        sample.instructions = 0;
+    }
+#endif
+    sample.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return sample;
+}
+
+void TraceProfiler::add(trace_section_t section, const trace_sample_t& start) {
+    trace_sample_t end          = now();
+    trace_stats_t& stats        = m_stats[section];
+    uint64_t       nanoseconds  = end.nanoseconds - start.nanoseconds;
+    uint64_t       instructions = end.instructions - start.instructions;
+
+    stats.calls++;
+    stats.nanoseconds += nanoseconds;
+    stats.instructions += instructions;
+    if (nanoseconds > stats.max_nanoseconds) {
+        stats.max_nanoseconds = nanoseconds;
+    }
+    if (instructions > stats.max_instructions) {
+        stats.max_instructions = instructions;
+    }
+}
+
+const trace_stats_t& TraceProfiler::stats(trace_section_t section) {
+    return m_stats[section];
+}
+
+const char* TraceProfiler::name(trace_section_t section) {
+    static const char* names[SECTION_COUNT] = {
+        "keyboard_task", "event_loop", "action_exec", "process_record", "process_combo", "combo_task", "process_tap_dance", "tap_dance_task", "process_key_override", "key_override_task",
+    };
+    return names[section];
+}
+
+#ifdef TRACE_REPLAY_WRAP
+/* The linker redirects calls made from other translation units to these, see test.mk */
+extern "C" {
+void __real_action_exec(keyevent_t event);
+void __real_process_record(keyrecord_t* record);
+bool __real_process_combo(uint16_t keycode, keyrecord_t* record);
+void __real_combo_task(void);
+bool __real_process_tap_dance(uint16_t keycode, keyrecord_t* record);
+void __real_tap_dance_task(void);
+bool __real_process_key_override(const uint16_t keycode, const keyrecord_t* const record);
+void __real_key_override_task(void);
+
+void __wrap_action_exec(keyevent_t event) {
+    TraceScope scope(SECTION_ACTION_EXEC);
+    __real_action_exec(event);
+}
+
+// process_record_quantum() has a weak fallback next to its caller, so it cannot be wrapped itself
+void __wrap_process_record(keyrecord_t* record) {
+    TraceScope scope(SECTION_PROCESS_RECORD);
+    __real_process_record(record);
+}
+
+bool __wrap_process_combo(uint16_t keycode, keyrecord_t* record) {
+    TraceScope scope(SECTION_PROCESS_COMBO);
+    return __real_process_combo(keycode, record);
+}
+
+void __wrap_combo_task(void) {
+    TraceScope scope(SECTION_COMBO_TASK);
+    __real_combo_task();
+}
+
+bool __wrap_process_tap_dance(uint16_t keycode, keyrecord_t* record) {
+    TraceScope scope(SECTION_PROCESS_TAP_DANCE);
+    return __real_process_tap_dance(keycode, record);
+}
+
+void __wrap_tap_dance_task(void) {
+    TraceScope scope(SECTION_TAP_DANCE_TASK);
+    __real_tap_dance_task();
+}
+
+bool __wrap_process_key_override(const uint16_t keycode, const keyrecord_t* const record) {
+    TraceScope scope(SECTION_PROCESS_KEY_OVERRIDE);
+    return __real_process_key_override(keycode, record);
+}
+
+void __wrap_key_override_task(void) {
+    TraceScope scope(SECTION_KEY_OVERRIDE_TASK);
+    __real_key_override_task();
+}
+}
+#endif
@@ -0,0 +1,81 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/* Cost accounting for the key pipeline.
+ *
+ * Every section accumulates the wall time and, where the host allows reading
+ * the hardware counters, the user space instruction count of its calls. Times
+ * are inclusive, so action_exec also contains process_record.
+ */
+
+enum trace_section_t {
+    SECTION_KEYBOARD_TASK,
+    SECTION_EVENT_LOOP, // keyboard_task() calls that had a matrix event to process
+    SECTION_ACTION_EXEC,
+    SECTION_PROCESS_RECORD, // process_record_quantum() and process_action()
+    SECTION_PROCESS_COMBO,
+    SECTION_COMBO_TASK,
+    SECTION_PROCESS_TAP_DANCE,
+    SECTION_TAP_DANCE_TASK,
+    SECTION_PROCESS_KEY_OVERRIDE,
+    SECTION_KEY_OVERRIDE_TASK,
+    SECTION_COUNT,
+};
+
+struct trace_stats_t {
+    uint64_t calls;
+    uint64_t nanoseconds;
+    uint64_t max_nanoseconds;
+    uint64_t instructions;
+    uint64_t max_instructions;
+};
+
+struct trace_sample_t {
+    uint64_t nanoseconds;
+    uint64_t instructions;
+};
+
+class TraceProfiler {
+   public:
+    static void reset();
+    static bool has_instructions();
+    static bool has_sections();
+
+    static trace_sample_t now();
+    static void           add(trace_section_t section, const trace_sample_t& start);
+
+    static const trace_stats_t& stats(trace_section_t section);
+    static const char*          name(trace_section_t section);
+
+   private:
+    static trace_stats_t m_stats[SECTION_COUNT];
+};
+
+/* Times the enclosing scope */
+class TraceScope {
+   public:
+    explicit TraceScope(trace_section_t section) : m_section(section), m_start(TraceProfiler::now()) {}
+    ~TraceScope() { TraceProfiler::add(m_section, m_start); }
+
+   private:
+    trace_section_t m_section;
+    trace_sample_t  m_start;
+};
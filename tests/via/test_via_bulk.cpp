@@ -0,0 +1,265 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "via.h"
+#include "raw_hid.h"
+#include "crc.h"
+#include "dynamic_keymap.h"
+}
+
+#define PACKET_SIZE 32
+
+typedef std::vector<uint8_t> packet_t;
+
+/* Stands in for the host side of the raw HID endpoint. */
+static std::vector<packet_t> received_packets;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    ASSERT_EQ(length, PACKET_SIZE);
+    received_packets.push_back(packet_t(data, data + length));
+}
+
+class ViaBulk : public TestFixture {
+   protected:
+    void SetUp() override {
+        // Drop whatever transfer a previous test left behind
+        bulk_end(0);
+        received_packets.clear();
+    }
+
+    packet_t send(packet_t packet) {
+        received_packets.clear();
+        packet.resize(PACKET_SIZE);
+        raw_hid_receive(packet.data(), PACKET_SIZE);
+        return received_packets.empty() ? packet_t() : received_packets.back();
+    }
+
+    uint8_t bulk_begin(uint8_t region, uint8_t direction, uint16_t offset, uint16_t size) {
+        packet_t reply = send({id_dynamic_keymap_bulk_begin, region, direction, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF), (uint8_t)(size >> 8), (uint8_t)(size & 0xFF)});
+        EXPECT_EQ(reply[0], id_dynamic_keymap_bulk_begin);
+        EXPECT_EQ(reply[8], VIA_BULK_PAYLOAD_SIZE);
+        return reply[7];
+    }
+
+    void bulk_data(uint8_t sequence, const uint8_t *payload, size_t size) {
+        packet_t packet = {id_dynamic_keymap_bulk_data, sequence};
+        packet.insert(packet.end(), payload, payload + size);
+        EXPECT_TRUE(send(packet).empty()) << "bulk_data is not answered";
+    }
+
+    uint8_t bulk_end(uint8_t crc) {
+        packet_t reply = send({id_dynamic_keymap_bulk_end, crc});
+        return reply[1];
+    }
+
+    // Sends data in full payloads, starting at sequence 0
+    void write(const std::vector<uint8_t> &data) {
+        for (size_t i = 0; i * VIA_BULK_PAYLOAD_SIZE < data.size(); i++) {
+            size_t size = std::min<size_t>(VIA_BULK_PAYLOAD_SIZE, data.size() - i * VIA_BULK_PAYLOAD_SIZE);
+            bulk_data(i, &data[i * VIA_BULK_PAYLOAD_SIZE], size);
+        }
+    }
+
+    std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++) {
+            data[i] = seed + i * 7;
+        }
+        return data;
+    }
+
+    uint8_t crc(const std::vector<uint8_t> &data) {
+        return crc8_update(0xFF, data.data(), data.size());
+    }
+
+    std::vector<uint8_t> keymap(uint16_t offset, uint16_t size) {
+        std::vector<uint8_t> data(size);
+        dynamic_keymap_get_buffer(offset, size, data.data());
+        return data;
+    }
+};
+
+TEST_F(ViaBulk, WriteReachesEeprom) {
+    TestDriver driver;
+
+    // All but the last keycode, not a multiple of the payload size nor of the write buffer
+    uint16_t size = dynamic_keymap_get_buffer_size() - 2;
+    auto     data = pattern(size, 1);
+
+    ASSERT_NE(size % VIA_BULK_PAYLOAD_SIZE, 0);
+    ASSERT_NE(size % VIA_BULK_WRITE_BUFFER_SIZE, 0);
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, size), id_bulk_ok);
+    write(data);
+    EXPECT_EQ(bulk_end(crc(data)), id_bulk_ok);
+    EXPECT_EQ(keymap(0, size), data);
+}
+
+TEST_F(ViaBulk, WriteToMacroRegionAtOffset) {
+    TestDriver driver;
+    auto       data = pattern(45, 3);
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_macro, id_bulk_write, 10, data.size()), id_bulk_ok);
+    write(data);
+    EXPECT_EQ(bulk_end(crc(data)), id_bulk_ok);
+
+    std::vector<uint8_t> macros(data.size());
+    dynamic_keymap_macro_get_buffer(10, data.size(), macros.data());
+    EXPECT_EQ(macros, data);
+}
+
+TEST_F(ViaBulk, OutOfSequencePacketFailsTheWrite) {
+    TestDriver driver;
+    auto       before = keymap(0, 90);
+    auto       data   = pattern(90, 5);
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, data.size()), id_bulk_ok);
+    bulk_data(0, &data[0], VIA_BULK_PAYLOAD_SIZE);
+    // Packet 1 got lost
+    bulk_data(2, &data[60], VIA_BULK_PAYLOAD_SIZE);
+    bulk_data(3, &data[60], VIA_BULK_PAYLOAD_SIZE);
+    EXPECT_EQ(bulk_end(crc(data)), id_bulk_sequence_error);
+
+    // Nothing after the gap was written
+    auto after = keymap(0, 90);
+    EXPECT_TRUE(std::equal(before.begin() + 30, before.end(), after.begin() + 30));
+}
+
+TEST_F(ViaBulk, CrcMismatchIsReported) {
+    TestDriver driver;
+    auto       data = pattern(40, 7);
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, data.size()), id_bulk_ok);
+    write(data);
+    packet_t reply = send({id_dynamic_keymap_bulk_end, (uint8_t)(crc(data) ^ 1)});
+    EXPECT_EQ(reply[1], id_bulk_crc_error);
+    // The keyboard's CRC lets the host tell which side is wrong
+    EXPECT_EQ(reply[2], crc(data));
+}
+
+TEST_F(ViaBulk, ShortWriteIsInvalid) {
+    TestDriver driver;
+    auto       data = pattern(60, 9);
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, data.size() + 1), id_bulk_ok);
+    write(data);
+    EXPECT_EQ(bulk_end(crc(data)), id_bulk_invalid);
+    // What did arrive is kept
+    EXPECT_EQ(keymap(0, data.size()), data);
+}
+
+TEST_F(ViaBulk, OverlongWriteStaysWithinItsRange) {
+    TestDriver driver;
+    auto       before = keymap(0, 64);
+    auto       data   = pattern(64, 11);
+
+    // Only 5 bytes at offset 10 are announced, the packets carry more
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 10, 5), id_bulk_ok);
+    write(data);
+    EXPECT_EQ(bulk_end(crc8_update(0xFF, data.data(), 5)), id_bulk_ok);
+
+    auto after = keymap(0, 64);
+    EXPECT_TRUE(std::equal(before.begin(), before.begin() + 10, after.begin()));
+    EXPECT_TRUE(std::equal(data.begin(), data.begin() + 5, after.begin() + 10));
+    EXPECT_TRUE(std::equal(before.begin() + 15, before.end(), after.begin() + 15));
+}
+
+TEST_F(ViaBulk, RangeOutsideRegionIsRejected) {
+    TestDriver driver;
+    uint16_t   size = dynamic_keymap_get_buffer_size();
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, size + 1), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, size, 1), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, size + 1, 0), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0xFFFF, 2), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(2, id_bulk_write, 0, 1), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, 2, 0, 1), id_bulk_invalid);
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, size, 0), id_bulk_ok);
+}
+
+TEST_F(ViaBulk, DataBeforeBeginIsIgnored) {
+    TestDriver driver;
+    auto       before = keymap(0, 30);
+    auto       data   = pattern(30, 13);
+
+    bulk_data(0, data.data(), data.size());
+    EXPECT_EQ(bulk_end(crc(data)), id_bulk_invalid);
+    EXPECT_EQ(keymap(0, 30), before);
+
+    // Nor after a write ended
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_write, 0, 0), id_bulk_ok);
+    EXPECT_EQ(bulk_end(0xFF), id_bulk_ok);
+    bulk_data(0, data.data(), data.size());
+    EXPECT_EQ(keymap(0, 30), before);
+}
+
+TEST_F(ViaBulk, ReadIsStreamedOnePacketPerScan) {
+    TestDriver driver;
+    auto       data = pattern(75, 17);
+    dynamic_keymap_set_buffer(20, data.size(), data.data());
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_read, 20, data.size()), id_bulk_ok);
+    received_packets.clear();
+
+    // 3 data packets and the end
+    idle_for(2);
+    EXPECT_EQ(received_packets.size(), 2);
+    idle_for(10);
+    ASSERT_EQ(received_packets.size(), 4);
+
+    std::vector<uint8_t> streamed;
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(received_packets[i][0], id_dynamic_keymap_bulk_data);
+        EXPECT_EQ(received_packets[i][1], i);
+        size_t size = std::min<size_t>(VIA_BULK_PAYLOAD_SIZE, data.size() - streamed.size());
+        streamed.insert(streamed.end(), received_packets[i].begin() + 2, received_packets[i].begin() + 2 + size);
+    }
+    EXPECT_EQ(streamed, data);
+
+    EXPECT_EQ(received_packets[3][0], id_dynamic_keymap_bulk_end);
+    EXPECT_EQ(received_packets[3][1], id_bulk_ok);
+    EXPECT_EQ(received_packets[3][2], crc(data));
+}
+
+TEST_F(ViaBulk, EndAbortsRead) {
+    TestDriver driver;
+
+    EXPECT_EQ(bulk_begin(id_bulk_region_keymap, id_bulk_read, 0, 200), id_bulk_ok);
+    received_packets.clear();
+    idle_for(1);
+    EXPECT_EQ(received_packets.size(), 1);
+
+    EXPECT_EQ(bulk_end(0), id_bulk_invalid);
+    received_packets.clear();
+    idle_for(10);
+    EXPECT_TRUE(received_packets.empty());
+}
+
+TEST_F(ViaBulk, UpstreamEncoderCommandsAreNotBulkCommands) {
+    TestDriver driver;
+    auto       before = keymap(0, 30);
+
+    EXPECT_EQ(send({id_get_protocol_version})[2], VIA_PROTOCOL_VERSION & 0xFF);
+
+    // dynamic_keymap_get_encoder and dynamic_keymap_set_encoder in VIA
+    EXPECT_EQ(send({0x14, 0, 0, 0})[0], id_unhandled);
+    EXPECT_EQ(send({0x15, 0, 0, 0, 0, 4})[0], id_unhandled);
+    EXPECT_EQ(keymap(0, 30), before);
+}
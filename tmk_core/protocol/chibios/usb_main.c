@@ -42,6 +42,7 @@
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "usb_report_queue.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -86,6 +87,25 @@ report_mouse_t mouse_report_blank = {0};
 uint8_t extra_report_blank[3] = {0};
 #endif /* EXTRAKEY_ENABLE */
 
+/* Reports waiting for their IN endpoint, sent from the IN and SOF callbacks */
+#ifdef SHARED_EP_ENABLE
+static usb_report_queue_t shared_queue;
+#endif
+#ifdef KEYBOARD_SHARED_EP
+#    define keyboard_queue shared_queue
+#else
+static usb_report_queue_t keyboard_queue;
+#endif
+#ifdef MOUSE_ENABLE
+#    ifdef MOUSE_SHARED_EP
+#        define mouse_queue shared_queue
+#    else
+static usb_report_queue_t mouse_queue;
+#    endif
+_Static_assert(sizeof(report_mouse_t) <= USB_REPORT_QUEUE_REPORT_SIZE, "USB_REPORT_QUEUE_REPORT_SIZE is too small for the mouse report");
+#endif
+_Static_assert(sizeof(report_keyboard_t) <= USB_REPORT_QUEUE_REPORT_SIZE, "USB_REPORT_QUEUE_REPORT_SIZE is too small for the keyboard report");
+
 /* ---------------------------------------------------------
  *            Descriptors and USB driver objects
  * ---------------------------------------------------------
@@ -172,7 +192,7 @@ static const USBEndpointConfig shared_ep_config = {
 };
 #endif
 
-#if STM32_USB_USE_OTG1
+#if STM32_USB_USE_OTG1 || STM32_USB_USE_OTG2
 typedef struct {
     size_t              queue_capacity_in;
     size_t              queue_capacity_out;
@@ -199,7 +219,7 @@ typedef struct {
 } usb_driver_config_t;
 #endif
 
-#if STM32_USB_USE_OTG1
+#if STM32_USB_USE_OTG1 || STM32_USB_USE_OTG2
 /* Reusable initialization structure - see USBEndpointConfig comment at top of file */
 #    define QMK_USB_DRIVER_CONFIG(stream, notification, fixedsize)                                                              \
         {                                                                                                                       \
@@ -476,15 +496,18 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
+            usb_report_queue_init(&keyboard_queue);
 #endif
 #if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
             usbInitEndpointI(usbp, MOUSE_IN_EPNUM, &mouse_ep_config);
+            usb_report_queue_init(&mouse_queue);
 #endif
 #ifdef SHARED_EP_ENABLE
             usbInitEndpointI(usbp, SHARED_IN_EPNUM, &shared_ep_config);
+            usb_report_queue_init(&shared_queue);
 #endif
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
-#if STM32_USB_USE_OTG1
+#if STM32_USB_USE_OTG1 || STM32_USB_USE_OTG2
                 usbInitEndpointI(usbp, drivers.array[i].config.bulk_in, &drivers.array[i].inout_ep_config);
 #else
                 usbInitEndpointI(usbp, drivers.array[i].config.bulk_in, &drivers.array[i].in_ep_config);
@@ -711,7 +734,7 @@ static const USBConfig usbcfg = {
  */
 void init_usb_driver(USBDriver *usbp) {
     for (int i = 0; i < NUM_USB_DRIVERS; i++) {
-#if STM32_USB_USE_OTG1
+#if STM32_USB_USE_OTG1 || STM32_USB_USE_OTG2
         QMKUSBDriver *driver                       = &drivers.array[i].driver;
         drivers.array[i].inout_ep_config.in_state  = &drivers.array[i].in_ep_state;
         drivers.array[i].inout_ep_config.out_state = &drivers.array[i].out_ep_state;
@@ -763,20 +786,52 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
  *                  Keyboard functions
  * ---------------------------------------------------------
  */
+/* start sending the oldest queued report if the endpoint is free
+ * callable from ISR, in locked state */
+static void report_queue_transmit_i(USBDriver *usbp, usbep_t ep, usb_report_queue_t *queue) {
+    if (usbGetDriverStateI(usbp) != USB_ACTIVE || usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+    const usb_report_t *report = usb_report_queue_pop(queue);
+    if (report != NULL) {
+        usbStartTransmitI(usbp, ep, (uint8_t *)report->data, report->size);
+    }
+}
+
+/* queue a report IN without waiting for the endpoint
+ * not callable from ISR or locked state */
+static void report_queue_send(usbep_t ep, usb_report_queue_t *queue, uint8_t kind, const void *data, uint8_t size, bool merge) {
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE && usb_report_queue_push(queue, kind, data, size, merge)) {
+        report_queue_transmit_i(&USB_DRIVER, ep, queue);
+    }
+    osalSysUnlock();
+}
+
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    report_queue_transmit_i(usbp, ep, &keyboard_queue);
+    osalSysUnlockFromISR();
 }
 #endif
 
 /* start-of-frame handler
- * TODO: i guess it would be better to re-implement using timers,
- *  so that this is not going to have to be checked every 1ms */
+ * picks up reports queued while an endpoint was busy, should the IN
+ * callback have run before they were queued */
 void kbd_sof_cb(USBDriver *usbp) {
-    (void)usbp;
+    osalSysLockFromISR();
+#ifndef KEYBOARD_SHARED_EP
+    report_queue_transmit_i(usbp, KEYBOARD_IN_EPNUM, &keyboard_queue);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    report_queue_transmit_i(usbp, MOUSE_IN_EPNUM, &mouse_queue);
+#endif
+#ifdef SHARED_EP_ENABLE
+    report_queue_transmit_i(usbp, SHARED_IN_EPNUM, &shared_queue);
+#endif
+    osalSysUnlockFromISR();
 }
 
 /* Idle requests timer code
@@ -804,7 +859,7 @@ static void keyboard_idle_timer_cb(void *arg) {
     if (keyboard_idle && keyboard_protocol) {
 #endif /* NKRO_ENABLE */
         /* TODO: are we sure we want the KBD_ENDPOINT? */
-        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
+        if (usb_report_queue_is_empty(&keyboard_queue) && !usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
             usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)&keyboard_report_sent, KEYBOARD_EPSIZE);
         }
         /* rearm the timer */
@@ -821,65 +876,22 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-/* prepare and start sending a report IN
+/* queue a report IN, sent as soon as the endpoint is free
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        goto unlock;
-    }
-
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        report_queue_send(SHARED_IN_EPNUM, &shared_queue, REPORT_ID_NKRO, report, sizeof(struct nkro_report), true);
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        uint8_t *data, size;
         if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
+            report_queue_send(KEYBOARD_IN_EPNUM, &keyboard_queue, 0, report, KEYBOARD_REPORT_SIZE, true);
         } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
+            report_queue_send(KEYBOARD_IN_EPNUM, &keyboard_queue, 0, &report->mods, 8, true);
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
     }
     keyboard_report_sent = *report;
-
-unlock:
-    osalSysUnlock();
 }
 
 /* ---------------------------------------------------------
@@ -892,30 +904,15 @@ unlock:
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    report_queue_transmit_i(usbp, ep, &mouse_queue);
+    osalSysUnlockFromISR();
 }
 #    endif
 
 void send_mouse(report_mouse_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
+    /* movement is relative, so mouse reports are never merged */
+    report_queue_send(MOUSE_IN_EPNUM, &mouse_queue, REPORT_ID_MOUSE, report, sizeof(report_mouse_t), false);
 }
 
 #else  /* MOUSE_ENABLE */
@@ -931,9 +928,9 @@ void send_mouse(report_mouse_t *report) {
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    report_queue_transmit_i(usbp, ep, &shared_queue);
+    osalSysUnlockFromISR();
 }
 #endif
 
@@ -944,28 +941,9 @@ void shared_in_cb(USBDriver *usbp, usbep_t ep) {
 
 #ifdef EXTRAKEY_ENABLE
 static void send_extra(uint8_t report_id, uint16_t data) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
+    report_extra_t report = {.report_id = report_id, .usage = data};
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    static report_extra_t report;
-    report = (report_extra_t){.report_id = report_id, .usage = data};
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
-    osalSysUnlock();
+    report_queue_send(SHARED_IN_EPNUM, &shared_queue, report_id, &report, sizeof(report_extra_t), true);
 }
 #endif
 
@@ -983,44 +961,19 @@ void send_consumer(uint16_t data) {
 
 void send_programmable_button(uint32_t data) {
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    static report_programmable_button_t report = {
+    report_programmable_button_t report = {
         .report_id = REPORT_ID_PROGRAMMABLE_BUTTON,
+        .usage     = data,
     };
 
-    report.usage = data;
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report));
-    osalSysUnlock();
+    report_queue_send(SHARED_IN_EPNUM, &shared_queue, REPORT_ID_PROGRAMMABLE_BUTTON, &report, sizeof(report), true);
 #endif
 }
 
 void send_digitizer(report_digitizer_t *report) {
 #ifdef DIGITIZER_ENABLE
 #    ifdef DIGITIZER_SHARED_EP
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    usbStartTransmitI(&USB_DRIVER, DIGITIZER_IN_EPNUM, (uint8_t *)report, sizeof(report_digitizer_t));
-    osalSysUnlock();
+    report_queue_send(DIGITIZER_IN_EPNUM, &shared_queue, REPORT_ID_DIGITIZER, report, sizeof(report_digitizer_t), true);
 #    else
     chnWrite(&drivers.digitizer_driver.driver, (uint8_t *)report, sizeof(report_digitizer_t));
 #    endif
@@ -28,8 +28,10 @@
  * -------------------------
  */
 
-/* The USB driver to use */
-#define USB_DRIVER USBD1
+/* The USB driver to use, e.g. USBD2 for the high speed OTG peripheral of STM32 */
+#ifndef USB_DRIVER
+#    define USB_DRIVER USBD1
+#endif
 
 /* Initialize the USB driver and bus */
 void init_usb_driver(USBDriver *usbp);
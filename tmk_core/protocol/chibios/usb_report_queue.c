@@ -0,0 +1,105 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "usb_report_queue.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define QUEUE_MASK (USB_REPORT_QUEUE_SIZE - 1)
+
+_Static_assert((USB_REPORT_QUEUE_SIZE & QUEUE_MASK) == 0, "USB_REPORT_QUEUE_SIZE must be a power of two");
+_Static_assert(USB_REPORT_QUEUE_SIZE <= 128, "USB_REPORT_QUEUE_SIZE must fit the queue counters");
+
+static inline usb_report_t *queued(usb_report_queue_t *queue, uint8_t index) {
+    return &queue->reports[(queue->head + index) & QUEUE_MASK];
+}
+
+static inline bool same_kind(const usb_report_t *report, uint8_t kind, uint8_t size) {
+    return report->size == size && report->kind == kind;
+}
+
+/* The report the host will have seen right before the newest queued one */
+static const usb_report_t *previous_of_kind(usb_report_queue_t *queue, uint8_t kind, uint8_t size) {
+    for (uint8_t i = queue->count - 1; i > 0; i--) {
+        const usb_report_t *report = queued(queue, i - 1);
+        if (same_kind(report, kind, size)) {
+            return report;
+        }
+    }
+    return same_kind(&queue->sent, kind, size) ? &queue->sent : NULL;
+}
+
+/* Replacing the newest report must not hide any byte it changes, so every
+ * byte may change at most once between the previous report and the new one.
+ */
+static bool can_merge(usb_report_queue_t *queue, const usb_report_t *newest, const uint8_t *data) {
+    const usb_report_t *previous = previous_of_kind(queue, newest->kind, newest->size);
+    if (previous == NULL) {
+        return memcmp(newest->data, data, newest->size) == 0;
+    }
+    for (uint8_t i = 0; i < newest->size; i++) {
+        if (newest->data[i] != previous->data[i] && data[i] != newest->data[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void usb_report_queue_init(usb_report_queue_t *queue) {
+    queue->head      = 0;
+    queue->count     = 0;
+    queue->sent.size = 0;
+}
+
+bool usb_report_queue_push(usb_report_queue_t *queue, uint8_t kind, const void *data, uint8_t size, bool merge) {
+    if (size > USB_REPORT_QUEUE_REPORT_SIZE) {
+        return false;
+    }
+
+    usb_report_t *report = NULL;
+    if (queue->count) {
+        usb_report_t *newest = queued(queue, queue->count - 1);
+        if (merge && newest->merge && same_kind(newest, kind, size)) {
+            if (queue->count == USB_REPORT_QUEUE_SIZE || can_merge(queue, newest, data)) {
+                report = newest;
+            }
+        }
+    }
+
+    if (report == NULL) {
+        if (queue->count == USB_REPORT_QUEUE_SIZE) {
+            return false;
+        }
+        report = queued(queue, queue->count++);
+    }
+
+    report->kind  = kind;
+    report->size  = size;
+    report->merge = merge;
+    memcpy(report->data, data, size);
+    return true;
+}
+
+const usb_report_t *usb_report_queue_pop(usb_report_queue_t *queue) {
+    if (queue->count == 0) {
+        return NULL;
+    }
+    queue->sent = *queued(queue, 0);
+    queue->head = (queue->head + 1) & QUEUE_MASK;
+    queue->count--;
+    return &queue->sent;
+}
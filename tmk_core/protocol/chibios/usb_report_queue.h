@@ -0,0 +1,78 @@
+/* Copyright 2022 QMK
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Per endpoint queue of HID reports waiting to be sent IN.
+ * Producers push reports without waiting for the endpoint, the IN complete
+ * and start of frame callbacks pop the oldest one once the endpoint is free.
+ *
+ * A report of the same kind as the newest queued one replaces it, unless
+ * that would hide a state the host has not seen yet: a press and release
+ * inside one frame stay two reports. When the queue is full the newest
+ * report of the same kind is replaced regardless, so the host always ends
+ * up with the latest state.
+ *
+ * The queue does no locking of its own, callers serialise access.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+/* Largest report that can be queued, in bytes */
+#ifndef USB_REPORT_QUEUE_REPORT_SIZE
+#    define USB_REPORT_QUEUE_REPORT_SIZE 32
+#endif
+
+typedef struct {
+    uint8_t kind; // Reports of different kinds are never merged, e.g. the report ID
+    uint8_t size;
+    bool    merge; // false for reports carrying deltas, like mouse movement
+    uint8_t data[USB_REPORT_QUEUE_REPORT_SIZE];
+} usb_report_t;
+
+typedef struct {
+    usb_report_t reports[USB_REPORT_QUEUE_SIZE];
+    usb_report_t sent; // Last popped report, stays valid until the next pop
+    uint8_t      head;
+    uint8_t      count;
+} usb_report_queue_t;
+
+/**
+ * @brief Drop all queued reports.
+ */
+void usb_report_queue_init(usb_report_queue_t *queue);
+
+/**
+ * @brief Queue a report, merging it into the newest queued one when possible.
+ *
+ * @return false if the report was dropped.
+ */
+bool usb_report_queue_push(usb_report_queue_t *queue, uint8_t kind, const void *data, uint8_t size, bool merge);
+
+/**
+ * @brief Take the oldest report for transmission.
+ *
+ * @return NULL if the queue is empty.
+ */
+const usb_report_t *usb_report_queue_pop(usb_report_queue_t *queue);
+
+static inline bool usb_report_queue_is_empty(const usb_report_queue_t *queue) {
+    return queue->count == 0;
+}
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "debug.h"
 #include "digitizer.h"
+#include "telemetry.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -79,6 +80,7 @@ void host_keyboard_send(report_keyboard_t *report) {
 #endif
     }
     (*driver->send_keyboard)(report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -95,6 +97,7 @@ void host_mouse_send(report_mouse_t *report) {
     report->report_id = REPORT_ID_MOUSE;
 #endif
     (*driver->send_mouse)(report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 }
 
 void host_system_send(uint16_t report) {
@@ -103,6 +106,7 @@ void host_system_send(uint16_t report) {
 
     if (!driver) return;
     (*driver->send_system)(report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 }
 
 void host_consumer_send(uint16_t report) {
@@ -111,6 +115,7 @@ void host_consumer_send(uint16_t report) {
 
     if (!driver) return;
     (*driver->send_consumer)(report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 }
 
 void host_digitizer_send(digitizer_t *digitizer) {
@@ -127,6 +132,7 @@ void host_digitizer_send(digitizer_t *digitizer) {
     };
 
     send_digitizer(&report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 }
 
 __attribute__((weak)) void send_digitizer(report_digitizer_t *report) {}
@@ -137,6 +143,7 @@ void host_programmable_button_send(uint32_t report) {
 
     if (!driver) return;
     (*driver->send_programmable_button)(report);
+    telemetry_count(TELEMETRY_USB_REPORTS);
 }
 
 uint16_t host_last_system_report(void) {
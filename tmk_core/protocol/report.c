@@ -31,37 +31,51 @@ static int8_t cb_tail  = 0;
 static int8_t cb_count = 0;
 #endif
 
+#define KEY_BIT(code) ((uint8_t)1 << ((code)&7))
+
+// Index of code in the 6KRO keys[], or -1
+static int8_t find_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    for (int8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == code) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /** \brief has_anykey
  *
- * FIXME: Needs doc
+ * Returns the number of keys in the keyboard report
  */
 uint8_t has_anykey(report_keyboard_t* keyboard_report) {
-    uint8_t  cnt = 0;
-    uint8_t* p   = keyboard_report->keys;
-    uint8_t  lp  = sizeof(keyboard_report->keys);
+    uint8_t cnt = 0;
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        p  = keyboard_report->nkro.bits;
-        lp = sizeof(keyboard_report->nkro.bits);
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (keyboard_report->nkro.bits[i]) cnt += __builtin_popcount(keyboard_report->nkro.bits[i]);
+        }
+        return cnt;
     }
 #endif
-    while (lp--) {
-        if (*p++) cnt++;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i]) cnt++;
     }
     return cnt;
 }
 
 /** \brief get_first_key
  *
- * FIXME: Needs doc
+ * Returns the lowest key in the NKRO report, or the oldest key in the 6KRO report
  */
 uint8_t get_first_key(report_keyboard_t* keyboard_report) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        uint8_t i = 0;
-        for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
-            ;
-        return i << 3 | biton(keyboard_report->nkro.bits[i]);
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (keyboard_report->nkro.bits[i]) {
+                return i << 3 | __builtin_ctz(keyboard_report->nkro.bits[i]);
+            }
+        }
+        return 0;
     }
 #endif
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
@@ -89,34 +103,25 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
     }
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        if ((key >> 3) < KEYBOARD_REPORT_BITS) {
-            return keyboard_report->nkro.bits[key >> 3] & 1 << (key & 7);
-        } else {
-            return false;
-        }
+        return (key >> 3) < KEYBOARD_REPORT_BITS && (keyboard_report->nkro.bits[key >> 3] & KEY_BIT(key));
     }
 #endif
-    for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == key) {
-            return true;
-        }
-    }
-    return false;
+    return find_key_byte(keyboard_report, key) >= 0;
 }
 
 /** \brief add key byte
  *
- * FIXME: Needs doc
+ * Adds a key to the 6KRO report, unless it is full. Returns whether the report changed.
  */
-void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+bool add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    if (code == KC_NO || find_key_byte(keyboard_report, code) >= 0) {
+        return false;
+    }
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
     int8_t i     = cb_head;
     int8_t empty = -1;
     if (cb_count) {
         do {
-            if (keyboard_report->keys[i] == code) {
-                return;
-            }
             if (empty == -1 && keyboard_report->keys[i] == 0) {
                 empty = i;
             }
@@ -148,34 +153,28 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
             }
         }
     }
-    // add to tail
+    // add to tail, replacing the popped head
     keyboard_report->keys[cb_tail] = code;
     cb_tail                        = RO_INC(cb_tail);
     cb_count++;
 #else
-    int8_t i     = 0;
-    int8_t empty = -1;
-    for (; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            break;
-        }
-        if (empty == -1 && keyboard_report->keys[i] == 0) {
-            empty = i;
-        }
-    }
-    if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
-        }
+    int8_t i = find_key_byte(keyboard_report, 0);
+    if (i < 0) {
+        return false;
     }
+    keyboard_report->keys[i] = code;
 #endif
+    return true;
 }
 
 /** \brief del key byte
  *
- * FIXME: Needs doc
+ * Removes a key from the 6KRO report. Returns whether the report changed.
  */
-void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+bool del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+    if (code == KC_NO) {
+        return false;
+    }
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
     uint8_t i = cb_head;
     if (cb_count) {
@@ -196,85 +195,95 @@ void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
                         }
                     } while (cb_tail != cb_head);
                 }
-                break;
+                return true;
             }
             i = RO_INC(i);
         } while (i != cb_tail);
     }
+    return false;
 #else
-    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            keyboard_report->keys[i] = 0;
-        }
+    int8_t i = find_key_byte(keyboard_report, code);
+    if (i < 0) {
+        return false;
     }
+    keyboard_report->keys[i] = 0;
+    return true;
 #endif
 }
 
 #ifdef NKRO_ENABLE
 /** \brief add key bit
  *
- * FIXME: Needs doc
+ * Adds a key to the NKRO report. Returns whether the report changed.
  */
-void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
+bool add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
-        keyboard_report->nkro.bits[code >> 3] |= 1 << (code & 7);
+        if (code != KC_NO && !(keyboard_report->nkro.bits[code >> 3] & KEY_BIT(code))) {
+            keyboard_report->nkro.bits[code >> 3] |= KEY_BIT(code);
+            return true;
+        }
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
     }
+    return false;
 }
 
 /** \brief del key bit
  *
- * FIXME: Needs doc
+ * Removes a key from the NKRO report. Returns whether the report changed.
  */
-void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
+bool del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
-        keyboard_report->nkro.bits[code >> 3] &= ~(1 << (code & 7));
+        if (keyboard_report->nkro.bits[code >> 3] & KEY_BIT(code)) {
+            keyboard_report->nkro.bits[code >> 3] &= ~KEY_BIT(code);
+            return true;
+        }
     } else {
         dprintf("del_key_bit: can't del: %02X\n", code);
     }
+    return false;
 }
 #endif
 
 /** \brief add key to report
  *
- * FIXME: Needs doc
+ * Returns whether the report changed
  */
-void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key) {
+bool add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        add_key_bit(keyboard_report, key);
-        return;
+        return add_key_bit(keyboard_report, key);
     }
 #endif
-    add_key_byte(keyboard_report, key);
+    return add_key_byte(keyboard_report, key);
 }
 
 /** \brief del key from report
  *
- * FIXME: Needs doc
+ * Returns whether the report changed
  */
-void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
+bool del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        del_key_bit(keyboard_report, key);
-        return;
+        return del_key_bit(keyboard_report, key);
     }
 #endif
-    del_key_byte(keyboard_report, key);
+    return del_key_byte(keyboard_report, key);
 }
 
 /** \brief clear key from report
  *
- * FIXME: Needs doc
+ * Returns whether the report changed
  */
-void clear_keys_from_report(report_keyboard_t* keyboard_report) {
+bool clear_keys_from_report(report_keyboard_t* keyboard_report) {
     // not clear mods
+    bool changed = has_anykey(keyboard_report);
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
         memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
-        return;
+        return changed;
     }
 #endif
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
+    return changed;
 }
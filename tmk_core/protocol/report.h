@@ -133,7 +133,7 @@ enum desktop_usages {
 #        define KEYBOARD_REPORT_BITS (NKRO_EPSIZE - 1)
 #        undef NKRO_SHARED_EP
 #        undef MOUSE_SHARED_EP
-#    else
+#    elif !defined(KEYBOARD_REPORT_BITS)
 #        error "NKRO not supported with this protocol"
 #    endif
 #endif
@@ -309,16 +309,16 @@ uint8_t has_anykey(report_keyboard_t* keyboard_report);
 uint8_t get_first_key(report_keyboard_t* keyboard_report);
 bool    is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key);
 
-void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
-void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
+bool add_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
+bool del_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
 #ifdef NKRO_ENABLE
-void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code);
-void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code);
+bool add_key_bit(report_keyboard_t* keyboard_report, uint8_t code);
+bool del_key_bit(report_keyboard_t* keyboard_report, uint8_t code);
 #endif
 
-void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
-void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
-void clear_keys_from_report(report_keyboard_t* keyboard_report);
+bool add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
+bool del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
+bool clear_keys_from_report(report_keyboard_t* keyboard_report);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,13 @@
+usb_interval_INC := \
+	$(TMK_PATH)/protocol
+
+usb_interval_SRC := \
+	$(TMK_PATH)/protocol/tests/usb_interval_tests.cpp
+
+usb_interval_high_speed_DEFS := -DUSB_HIGH_SPEED
+
+usb_interval_high_speed_INC := \
+	$(TMK_PATH)/protocol
+
+usb_interval_high_speed_SRC := \
+	$(TMK_PATH)/protocol/tests/usb_interval_tests.cpp
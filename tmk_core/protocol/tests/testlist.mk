@@ -0,0 +1,3 @@
+TEST_LIST += \
+	usb_interval \
+	usb_interval_high_speed
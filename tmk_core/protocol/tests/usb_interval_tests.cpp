@@ -0,0 +1,76 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "usb_descriptor_common.h"
+}
+
+/* Polling period of an endpoint on the bus, in us */
+static unsigned long period_us(unsigned long interval) {
+#ifdef USB_HIGH_SPEED
+    return 125UL << (interval - 1);
+#else
+    return interval * 1000UL;
+#endif
+}
+
+TEST(UsbInterval, FullSpeedIntervalIsInFrames) {
+    EXPECT_EQ(USB_FS_INTERVAL(125), 1);
+    EXPECT_EQ(USB_FS_INTERVAL(1000), 1);
+    EXPECT_EQ(USB_FS_INTERVAL(1999), 1);
+    EXPECT_EQ(USB_FS_INTERVAL(2000), 2);
+    EXPECT_EQ(USB_FS_INTERVAL(10000), 10);
+    EXPECT_EQ(USB_FS_INTERVAL(255000), 255);
+    EXPECT_EQ(USB_FS_INTERVAL(1000000), 255);
+}
+
+TEST(UsbInterval, HighSpeedIntervalIsAPowerOfTwoOfMicroframes) {
+    EXPECT_EQ(USB_HS_INTERVAL(0), 1);
+    EXPECT_EQ(USB_HS_INTERVAL(125), 1);
+    EXPECT_EQ(USB_HS_INTERVAL(249), 1);
+    EXPECT_EQ(USB_HS_INTERVAL(250), 2);
+    EXPECT_EQ(USB_HS_INTERVAL(500), 3);
+    EXPECT_EQ(USB_HS_INTERVAL(1000), 4);
+    EXPECT_EQ(USB_HS_INTERVAL(5000), 6);
+    EXPECT_EQ(USB_HS_INTERVAL(4096000), 16);
+    EXPECT_EQ(USB_HS_INTERVAL(10000000), 16);
+}
+
+TEST(UsbInterval, HostPollsAtLeastAsOftenAsAsked) {
+    for (unsigned long us = 125; us <= 300000; us += 125) {
+        unsigned long interval = USB_INTERVAL_US(us);
+        EXPECT_LE(period_us(interval), std::max(us, period_us(1))) << us;
+    }
+}
+
+TEST(UsbInterval, PollingIntervalDefault) {
+#ifdef USB_HIGH_SPEED
+    EXPECT_EQ(USB_POLLING_INTERVAL_US, 125);
+    EXPECT_EQ(period_us(USB_POLLING_INTERVAL), 125);
+#else
+    EXPECT_EQ(USB_POLLING_INTERVAL_US, 1000);
+    EXPECT_EQ(period_us(USB_POLLING_INTERVAL), 1000);
+#endif
+}
+
+TEST(UsbInterval, MillisecondIntervalsKeepTheirPeriod) {
+    EXPECT_EQ(period_us(USB_INTERVAL_MS(1)), 1000);
+    EXPECT_EQ(period_us(USB_INTERVAL_MS(8)), 8000);
+}
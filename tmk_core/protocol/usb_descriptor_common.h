@@ -33,3 +33,49 @@
 
 #define RAW_USAGE_PAGE_HI ((uint8_t)(RAW_USAGE_PAGE >> 8))
 #define RAW_USAGE_PAGE_LO ((uint8_t)(RAW_USAGE_PAGE & 0xFF))
+
+/////////////////////
+// Endpoint polling intervals
+
+/* Full speed endpoints are polled every bInterval frames of 1 ms, high speed
+ * ones every 2^(bInterval - 1) microframes of 125 us. Intervals are rounded
+ * down to the nearest one the bus can do, so the host polls at least as
+ * often as asked.
+ */
+#define USB_FS_INTERVAL(us) ((us) >= 255000UL ? 255 : (us) >= 2000UL ? (us) / 1000UL : 1)
+#define USB_HS_INTERVAL(us) ( \
+    (us) >= 4096000UL ? 16 : \
+    (us) >= 2048000UL ? 15 : \
+    (us) >= 1024000UL ? 14 : \
+    (us) >= 512000UL ? 13 : \
+    (us) >= 256000UL ? 12 : \
+    (us) >= 128000UL ? 11 : \
+    (us) >= 64000UL ? 10 : \
+    (us) >= 32000UL ? 9 : \
+    (us) >= 16000UL ? 8 : \
+    (us) >= 8000UL ? 7 : \
+    (us) >= 4000UL ? 6 : \
+    (us) >= 2000UL ? 5 : \
+    (us) >= 1000UL ? 4 : \
+    (us) >= 500UL ? 3 : \
+    (us) >= 250UL ? 2 : \
+    1)
+
+#ifdef USB_HIGH_SPEED
+#    define USB_INTERVAL_US(us) USB_HS_INTERVAL(us)
+#else
+#    define USB_INTERVAL_US(us) USB_FS_INTERVAL(us)
+#endif
+#define USB_INTERVAL_MS(ms) USB_INTERVAL_US((ms)*1000UL)
+
+/* Polling interval of the keyboard, mouse and shared endpoints */
+#ifndef USB_POLLING_INTERVAL_US
+#    if defined(USB_POLLING_INTERVAL_MS)
+#        define USB_POLLING_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000UL)
+#    elif defined(USB_HIGH_SPEED)
+#        define USB_POLLING_INTERVAL_US 125
+#    else
+#        define USB_POLLING_INTERVAL_US 1000
+#    endif
+#endif
+#define USB_POLLING_INTERVAL USB_INTERVAL_US(USB_POLLING_INTERVAL_US)